@@ -0,0 +1,720 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_mecard.h"
+#include "mc_record.h"
+
+#include <glib.h>
+
+#include <stdio.h>
+#include <sys/resource.h>
+
+#define RET_OK (0)
+#define RET_CMDLINE (1)
+#define RET_ERR (2)
+#define RET_REGRESSION (3)
+
+#define BENCH_SEED (0x6d63)
+#define BENCH_DEFAULT_RECORDS (1000)
+#define BENCH_DEFAULT_TIME (0.5)
+#define BENCH_DEFAULT_THRESHOLD (10.0)
+
+/*
+ * Heap accounting. Defining these in the executable makes them visible
+ * to glib too, so every g_malloc made by the library is counted.
+ */
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t n, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+static guint64 bench_alloc_count;
+static guint64 bench_alloc_bytes;
+
+void*
+malloc(
+    size_t size)
+{
+    bench_alloc_count++;
+    bench_alloc_bytes += size;
+    return __libc_malloc(size);
+}
+
+void*
+calloc(
+    size_t n,
+    size_t size)
+{
+    bench_alloc_count++;
+    bench_alloc_bytes += n * size;
+    return __libc_calloc(n, size);
+}
+
+void*
+realloc(
+    void* ptr,
+    size_t size)
+{
+    bench_alloc_count++;
+    bench_alloc_bytes += size;
+    return __libc_realloc(ptr, size);
+}
+
+void
+free(
+    void* ptr)
+{
+    __libc_free(ptr);
+}
+
+/*
+ * Corpus generator. The pseudo-random sequence is fixed, so is
+ * the corpus.
+ */
+
+typedef struct bench_random {
+    guint32 state;
+} BenchRandom;
+
+typedef struct bench_entry {
+    char* data;
+    gsize size;
+} BenchEntry;
+
+typedef void (*BenchGenFunc)(GString* buf, BenchRandom* rnd);
+
+typedef struct bench_case {
+    const char* name;
+    BenchGenFunc gen;
+} BenchCase;
+
+typedef struct bench_api {
+    const char* name;
+    gpointer (*parse)(const void* data, size_t size);
+    void (*free)(gpointer obj);
+} BenchApi;
+
+typedef struct bench_result {
+    char* name;
+    gdouble ns_parse;
+    gdouble ns_free;
+    gdouble mb_per_s;
+    gdouble allocs;
+    gdouble alloc_bytes;
+} BenchResult;
+
+static
+guint32
+bench_random(
+    BenchRandom* rnd,
+    guint32 n)
+{
+    /* xorshift32 */
+    guint32 x = rnd->state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rnd->state = x;
+    return x % n;
+}
+
+static
+void
+bench_append_ascii(
+    GString* buf,
+    BenchRandom* rnd,
+    guint len)
+{
+    static const char chars[] = "abcdefghijklmnopqrstuvwxyz"
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 .-@/+";
+
+    while (len--) {
+        g_string_append_c(buf, chars[bench_random(rnd, sizeof(chars) - 1)]);
+    }
+}
+
+static
+void
+bench_append_utf8(
+    GString* buf,
+    BenchRandom* rnd,
+    guint len)
+{
+    static const char* chars[] = {
+        "\xd0\xb0", "\xd0\xb1", "\xd1\x8f", "\xc3\xa9",         /* 2 bytes */
+        "\xe3\x83\x8f", "\xe3\x81\x82", "\xe6\x97\xa5",         /* 3 bytes */
+        "\xf0\x9f\x98\x80",                                     /* 4 bytes */
+        "a", " "
+    };
+
+    while (len--) {
+        g_string_append(buf, chars[bench_random(rnd, G_N_ELEMENTS(chars))]);
+    }
+}
+
+static
+void
+bench_append_sjis(
+    GString* buf,
+    BenchRandom* rnd,
+    guint len)
+{
+    while (len--) {
+        if (bench_random(rnd, 2)) {
+            /* Katakana, including 0x5c trail bytes */
+            g_string_append_c(buf, (char)0x83);
+            g_string_append_c(buf, (char)(0x40 + bench_random(rnd, 0x3f)));
+        } else {
+            /* Hiragana */
+            g_string_append_c(buf, (char)0x82);
+            g_string_append_c(buf, (char)(0x9f + bench_random(rnd, 0x53)));
+        }
+    }
+}
+
+static
+void
+bench_append_latin1(
+    GString* buf,
+    BenchRandom* rnd,
+    guint len)
+{
+    while (len--) {
+        if (bench_random(rnd, 3)) {
+            bench_append_ascii(buf, rnd, 1);
+        } else {
+            g_string_append_c(buf, (char)(0xc0 + bench_random(rnd, 0x40)));
+        }
+    }
+}
+
+static
+void
+bench_append_escaped(
+    GString* buf,
+    BenchRandom* rnd,
+    guint len)
+{
+    static const char* escapes[] = { "\\\\", "\\;", "\\,", "\\:" };
+
+    while (len--) {
+        if (bench_random(rnd, 3)) {
+            bench_append_ascii(buf, rnd, 1);
+        } else {
+            g_string_append(buf, escapes[bench_random(rnd,
+                G_N_ELEMENTS(escapes))]);
+        }
+    }
+}
+
+static
+void
+bench_gen_mecard(
+    GString* buf,
+    BenchRandom* rnd,
+    void (*append)(GString* buf, BenchRandom* rnd, guint len))
+{
+    g_string_append(buf, "MECARD:N:");
+    append(buf, rnd, 4 + bench_random(rnd, 8));
+    g_string_append_c(buf, ',');
+    append(buf, rnd, 4 + bench_random(rnd, 8));
+    g_string_append_printf(buf, ";TEL:+%u;EMAIL:", bench_random(rnd,
+        1000000000));
+    bench_append_ascii(buf, rnd, 12);
+    g_string_append(buf, ";ADR:");
+    append(buf, rnd, 16 + bench_random(rnd, 32));
+    g_string_append(buf, ";NOTE:");
+    append(buf, rnd, 16 + bench_random(rnd, 64));
+    g_string_append(buf, ";URL:http://example.com/");
+    bench_append_ascii(buf, rnd, 8);
+    g_string_append(buf, ";;");
+}
+
+static
+void
+bench_gen_ascii(
+    GString* buf,
+    BenchRandom* rnd)
+{
+    bench_gen_mecard(buf, rnd, bench_append_ascii);
+}
+
+static
+void
+bench_gen_utf8(
+    GString* buf,
+    BenchRandom* rnd)
+{
+    bench_gen_mecard(buf, rnd, bench_append_utf8);
+}
+
+static
+void
+bench_gen_sjis(
+    GString* buf,
+    BenchRandom* rnd)
+{
+    bench_gen_mecard(buf, rnd, bench_append_sjis);
+}
+
+static
+void
+bench_gen_latin1(
+    GString* buf,
+    BenchRandom* rnd)
+{
+    bench_gen_mecard(buf, rnd, bench_append_latin1);
+}
+
+static
+void
+bench_gen_escapes(
+    GString* buf,
+    BenchRandom* rnd)
+{
+    bench_gen_mecard(buf, rnd, bench_append_escaped);
+}
+
+static
+void
+bench_gen_many(
+    GString* buf,
+    BenchRandom* rnd)
+{
+    static const char* names[] = { "TEL", "EMAIL", "NOTE" };
+    guint i;
+
+    g_string_append(buf, "MECARD:N:");
+    bench_append_ascii(buf, rnd, 8);
+    for (i = 0; i < 200; i++) {
+        if (bench_random(rnd, 2)) {
+            g_string_append_printf(buf, ";%s:", names[bench_random(rnd,
+                G_N_ELEMENTS(names))]);
+        } else {
+            g_string_append_printf(buf, ";X-%u:", i);
+        }
+        bench_append_ascii(buf, rnd, 1 + bench_random(rnd, 8));
+    }
+    g_string_append(buf, ";;");
+}
+
+static
+void
+bench_gen_backslash(
+    GString* buf,
+    BenchRandom* rnd)
+{
+    guint i;
+
+    g_string_append(buf, "MECARD:N:");
+    for (i = 0; i < 2048; i++) {
+        g_string_append(buf, bench_random(rnd, 16) ? "\\\\" : "\\;");
+    }
+    g_string_append(buf, ";;");
+}
+
+static
+void
+bench_gen_invalid(
+    GString* buf,
+    BenchRandom* rnd)
+{
+    /* Fails at the very end */
+    bench_gen_mecard(buf, rnd, bench_append_ascii);
+    g_string_truncate(buf, buf->len - 1);
+    g_string_append(buf, "NOTE:a:b;");
+}
+
+static const BenchCase bench_cases[] = {
+    { "ascii", bench_gen_ascii },
+    { "utf8", bench_gen_utf8 },
+    { "sjis", bench_gen_sjis },
+    { "latin1", bench_gen_latin1 },
+    { "escapes", bench_gen_escapes },
+    { "many", bench_gen_many },
+    { "backslash", bench_gen_backslash },
+    { "invalid", bench_gen_invalid }
+};
+
+static const BenchApi bench_apis[] = {
+    {
+        "record",
+        (gpointer (*)(const void*, size_t)) mc_record_parse_data,
+        (void (*)(gpointer)) mc_record_free
+    },{
+        "mecard",
+        (gpointer (*)(const void*, size_t)) mecard_parse_data,
+        (void (*)(gpointer)) mecard_free
+    }
+};
+
+static
+BenchEntry*
+bench_corpus_new(
+    const BenchCase* test,
+    guint n,
+    gsize* total)
+{
+    BenchEntry* corpus = g_new(BenchEntry, n);
+    BenchRandom rnd;
+    guint i;
+
+    rnd.state = BENCH_SEED;
+    *total = 0;
+    for (i = 0; i < n; i++) {
+        GString* buf = g_string_new(NULL);
+
+        test->gen(buf, &rnd);
+        corpus[i].size = buf->len;
+        corpus[i].data = g_string_free(buf, FALSE);
+        *total += corpus[i].size;
+    }
+    return corpus;
+}
+
+static
+void
+bench_corpus_free(
+    BenchEntry* corpus,
+    guint n)
+{
+    guint i;
+
+    for (i = 0; i < n; i++) {
+        g_free(corpus[i].data);
+    }
+    g_free(corpus);
+}
+
+static
+void
+bench_run(
+    const BenchCase* test,
+    const BenchApi* api,
+    guint n,
+    gdouble min_time,
+    BenchResult* result)
+{
+    gsize total;
+    BenchEntry* corpus = bench_corpus_new(test, n, &total);
+    gpointer* objs = g_new0(gpointer, n);
+    const gint64 min_usec = (gint64)(min_time * G_USEC_PER_SEC);
+    gint64 parse_usec = 0;
+    gint64 free_usec = 0;
+    guint64 allocs, bytes;
+    guint passes = 0;
+    guint i;
+
+    /* Warm up (and allocate the per-thread parser) */
+    for (i = 0; i < n; i++) {
+        api->free(api->parse(corpus[i].data, corpus[i].size));
+    }
+
+    allocs = bench_alloc_count;
+    bytes = bench_alloc_bytes;
+    do {
+        gint64 t0, t1, t2;
+
+        t0 = g_get_monotonic_time();
+        for (i = 0; i < n; i++) {
+            objs[i] = api->parse(corpus[i].data, corpus[i].size);
+        }
+        t1 = g_get_monotonic_time();
+        for (i = 0; i < n; i++) {
+            api->free(objs[i]);
+        }
+        t2 = g_get_monotonic_time();
+        parse_usec += t1 - t0;
+        free_usec += t2 - t1;
+        passes++;
+    } while (parse_usec + free_usec < min_usec);
+    allocs = bench_alloc_count - allocs;
+    bytes = bench_alloc_bytes - bytes;
+
+    result->name = g_strconcat(test->name, "/", api->name, NULL);
+    result->ns_parse = parse_usec * 1000.0 / passes / n;
+    result->ns_free = free_usec * 1000.0 / passes / n;
+    result->mb_per_s = parse_usec ? ((gdouble)total * passes / parse_usec *
+        G_USEC_PER_SEC / (1024 * 1024)) : 0;
+    result->allocs = (gdouble)allocs / passes / n;
+    result->alloc_bytes = (gdouble)bytes / passes / n;
+
+    g_free(objs);
+    bench_corpus_free(corpus, n);
+}
+
+/*
+ * Results are saved as JSON, one object per line. That's all that
+ * bench_json_number() needs to understand.
+ */
+
+static
+gboolean
+bench_json_number(
+    const char* line,
+    const char* key,
+    gdouble* value)
+{
+    char* pattern = g_strdup_printf("\"%s\":", key);
+    const char* found = strstr(line, pattern);
+    const gsize len = strlen(pattern);
+
+    g_free(pattern);
+    if (found) {
+        *value = g_ascii_strtod(found + len, NULL);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static
+gboolean
+bench_save(
+    const char* file,
+    const BenchResult* results,
+    guint count,
+    glong peak_rss)
+{
+    FILE* out = fopen(file, "w");
+
+    if (out) {
+        guint i;
+
+        for (i = 0; i < count; i++) {
+            const BenchResult* r = results + i;
+
+            fprintf(out, "{\"name\":\"%s\",\"ns_parse\":%.1f,"
+                "\"ns_free\":%.1f,\"mb_per_s\":%.2f,\"allocs\":%.2f,"
+                "\"alloc_bytes\":%.1f}\n", r->name, r->ns_parse, r->ns_free,
+                r->mb_per_s, r->allocs, r->alloc_bytes);
+        }
+        fprintf(out, "{\"name\":\"total\",\"peak_rss_kb\":%ld}\n", peak_rss);
+        if (!fclose(out)) {
+            return TRUE;
+        }
+    }
+    fprintf(stderr, "Failed to write %s\n", file);
+    return FALSE;
+}
+
+static
+gboolean
+bench_compare_metric(
+    const char* line,
+    const char* name,
+    const char* key,
+    gdouble value,
+    gdouble threshold)
+{
+    gdouble base;
+
+    if (bench_json_number(line, key, &base)) {
+        const gdouble delta = base ? ((value - base) * 100 / base) : 0;
+        const gboolean worse = delta > threshold;
+
+        printf("%-20s %-12s %12.1f %12.1f %+8.1f%%%s\n", name, key, base,
+            value, delta, worse ? "  REGRESSION" : "");
+        return !worse;
+    }
+    return TRUE;
+}
+
+static
+int
+bench_compare(
+    const char* file,
+    const BenchResult* results,
+    guint count,
+    glong peak_rss,
+    gdouble threshold)
+{
+    int ret = RET_ERR;
+    char* contents = NULL;
+    GError* error = NULL;
+
+    if (g_file_get_contents(file, &contents, NULL, &error)) {
+        char** lines = g_strsplit(contents, "\n", -1);
+        gboolean ok = TRUE;
+        guint i, k;
+
+        printf("\n%-20s %-12s %12s %12s %9s\n", "", "", "baseline",
+            "current", "delta");
+        for (i = 0; i < count; i++) {
+            const BenchResult* r = results + i;
+            char* tag = g_strdup_printf("\"name\":\"%s\"", r->name);
+
+            for (k = 0; lines[k]; k++) {
+                const char* line = lines[k];
+
+                if (strstr(line, tag)) {
+                    /* Lower is better for all of these */
+                    ok &= bench_compare_metric(line, r->name, "ns_parse",
+                        r->ns_parse, threshold);
+                    ok &= bench_compare_metric(line, r->name, "ns_free",
+                        r->ns_free, threshold);
+                    ok &= bench_compare_metric(line, r->name, "allocs",
+                        r->allocs, threshold);
+                    ok &= bench_compare_metric(line, r->name, "alloc_bytes",
+                        r->alloc_bytes, threshold);
+                    break;
+                }
+            }
+            g_free(tag);
+        }
+        if (peak_rss) {
+            for (k = 0; lines[k]; k++) {
+                if (strstr(lines[k], "\"name\":\"total\"")) {
+                    ok &= bench_compare_metric(lines[k], "total",
+                        "peak_rss_kb", peak_rss, threshold);
+                    break;
+                }
+            }
+        }
+        g_strfreev(lines);
+        g_free(contents);
+        ret = ok ? RET_OK : RET_REGRESSION;
+    } else {
+        fprintf(stderr, "%s\n", error->message);
+        g_error_free(error);
+    }
+    return ret;
+}
+
+int main(int argc, char* argv[])
+{
+    int ret = RET_CMDLINE;
+    gint n = BENCH_DEFAULT_RECORDS;
+    gdouble min_time = BENCH_DEFAULT_TIME;
+    gdouble threshold = BENCH_DEFAULT_THRESHOLD;
+    char* save = NULL;
+    char* baseline = NULL;
+    char* filter = NULL;
+    GError* error = NULL;
+    GOptionContext* options;
+    GOptionEntry entries[] = {
+        { "records", 'n', 0, G_OPTION_ARG_INT, &n,
+          "Number of records per corpus [1000]", "N" },
+        { "time", 't', 0, G_OPTION_ARG_DOUBLE, &min_time,
+          "Minimum run time per test, in seconds [0.5]", "SEC" },
+        { "case", 'c', 0, G_OPTION_ARG_STRING, &filter,
+          "Only run tests whose name contains TEXT", "TEXT" },
+        { "save", 's', 0, G_OPTION_ARG_FILENAME, &save,
+          "Save the results to FILE", "FILE" },
+        { "baseline", 'b', 0, G_OPTION_ARG_FILENAME, &baseline,
+          "Compare the results against FILE", "FILE" },
+        { "threshold", 'T', 0, G_OPTION_ARG_DOUBLE, &threshold,
+          "Regression threshold, in percent [10]", "PCT" },
+        { NULL }
+    };
+
+    options = g_option_context_new(NULL);
+    g_option_context_add_main_entries(options, entries, NULL);
+    g_option_context_set_summary(options, "Benchmarks libmc on "
+        "generated corpora.");
+    if (g_option_context_parse(options, &argc, &argv, &error) &&
+        argc == 1 && n > 0) {
+        const guint max = G_N_ELEMENTS(bench_cases) *
+            G_N_ELEMENTS(bench_apis);
+        BenchResult* results = g_new0(BenchResult, max);
+        struct rusage usage;
+        guint count = 0;
+        guint i, k;
+
+        printf("%-20s %10s %10s %10s %10s %12s\n", "", "ns/parse",
+            "ns/free", "MB/s", "allocs", "alloc bytes");
+        for (i = 0; i < G_N_ELEMENTS(bench_cases); i++) {
+            for (k = 0; k < G_N_ELEMENTS(bench_apis); k++) {
+                BenchResult* r = results + count;
+                char* name = g_strconcat(bench_cases[i].name, "/",
+                    bench_apis[k].name, NULL);
+                const gboolean skip = filter && !strstr(name, filter);
+
+                g_free(name);
+                if (!skip) {
+                    bench_run(bench_cases + i, bench_apis + k, n, min_time,
+                        r);
+                    printf("%-20s %10.1f %10.1f %10.2f %10.2f %12.1f\n",
+                        r->name, r->ns_parse, r->ns_free, r->mb_per_s,
+                        r->allocs, r->alloc_bytes);
+                    fflush(stdout);
+                    count++;
+                }
+            }
+        }
+
+        memset(&usage, 0, sizeof(usage));
+        getrusage(RUSAGE_SELF, &usage);
+        printf("Peak RSS: %ld KiB\n", usage.ru_maxrss);
+
+        ret = RET_OK;
+        if (save && !bench_save(save, results, count, usage.ru_maxrss)) {
+            ret = RET_ERR;
+        }
+        if (ret == RET_OK && baseline) {
+            /* Peak RSS is only comparable if everything has been run */
+            ret = bench_compare(baseline, results, count, filter ? 0 :
+                usage.ru_maxrss, threshold);
+        }
+        for (i = 0; i < count; i++) {
+            g_free(results[i].name);
+        }
+        g_free(results);
+    } else if (error) {
+        fprintf(stderr, "%s\n", error->message);
+        g_error_free(error);
+    } else {
+        char* help = g_option_context_get_help(options, TRUE, NULL);
+
+        fprintf(stderr, "%s", help);
+        g_free(help);
+    }
+
+    g_option_context_free(options);
+    g_free(save);
+    g_free(baseline);
+    g_free(filter);
+    return ret;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,644 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_HPP
+#define MC_HPP
+
+/*
+ * Header-only C++17 wrapper. Owning types are move-only and release
+ * the underlying object on destruction, the *Ref types don't own
+ * anything. Strings are returned as std::string_view pointing into
+ * the parsed objects, nothing gets copied. The lengths of McRecord
+ * values come from the record's own table (mc_record_value_lengths()),
+ * View carries them as well (see mc_view.h). Only property names and
+ * MeCard fields, which are plain NUL-terminated strings, are measured
+ * with strlen() on access.
+ */
+
+#include "mc_arena.h"
+#include "mc_mecard.h"
+#include "mc_record.h"
+#include "mc_view.h"
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory_resource>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace mc {
+
+/* Input buffer, like std::span<const std::byte> */
+class Bytes {
+public:
+    constexpr Bytes() noexcept : data_(nullptr), size_(0) {}
+    constexpr Bytes(const void* data, std::size_t size) noexcept :
+        data_(data), size_(size) {}
+    Bytes(const char* str) noexcept :
+        data_(str), size_(str ? std::strlen(str) : 0) {}
+
+    /* Any contiguous container, e.g. std::string or std::span */
+    template<class C, class = std::enable_if_t<!std::is_array_v<C>>,
+        class = decltype(std::data(std::declval<const C&>())),
+        class = decltype(std::size(std::declval<const C&>()))>
+    constexpr Bytes(const C& c) noexcept : data_(std::data(c)),
+        size_(std::size(c) * sizeof(*std::data(c))) {}
+
+    constexpr const void* data() const noexcept { return data_; }
+    constexpr std::size_t size() const noexcept { return size_; }
+
+private:
+    const void* data_;
+    std::size_t size_;
+};
+
+namespace detail {
+
+/* Random access range over a C array, projecting each element */
+template<class T, class V, V (*Get)(const T&)>
+class ArrayRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = V;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = V;
+
+        constexpr iterator() noexcept : p_(nullptr) {}
+        constexpr explicit iterator(const T* p) noexcept : p_(p) {}
+
+        V operator*() const noexcept { return Get(*p_); }
+        V operator[](difference_type i) const noexcept { return Get(p_[i]); }
+        iterator& operator++() noexcept { ++p_; return *this; }
+        iterator operator++(int) noexcept { return iterator(p_++); }
+        iterator& operator--() noexcept { --p_; return *this; }
+        iterator operator--(int) noexcept { return iterator(p_--); }
+        iterator& operator+=(difference_type n) noexcept
+            { p_ += n; return *this; }
+        iterator& operator-=(difference_type n) noexcept
+            { p_ -= n; return *this; }
+        iterator operator+(difference_type n) const noexcept
+            { return iterator(p_ + n); }
+        iterator operator-(difference_type n) const noexcept
+            { return iterator(p_ - n); }
+        difference_type operator-(iterator it) const noexcept
+            { return p_ - it.p_; }
+        bool operator==(iterator it) const noexcept { return p_ == it.p_; }
+        bool operator!=(iterator it) const noexcept { return p_ != it.p_; }
+        bool operator<(iterator it) const noexcept { return p_ < it.p_; }
+        bool operator>(iterator it) const noexcept { return p_ > it.p_; }
+        bool operator<=(iterator it) const noexcept { return p_ <= it.p_; }
+        bool operator>=(iterator it) const noexcept { return p_ >= it.p_; }
+
+    private:
+        const T* p_;
+    };
+
+    constexpr ArrayRange() noexcept : p_(nullptr), n_(0) {}
+    constexpr ArrayRange(const T* p, std::size_t n) noexcept :
+        p_(p), n_(n) {}
+
+    iterator begin() const noexcept { return iterator(p_); }
+    iterator end() const noexcept { return iterator(p_ + n_); }
+    std::size_t size() const noexcept { return n_; }
+    bool empty() const noexcept { return !n_; }
+    V operator[](std::size_t i) const noexcept { return Get(p_[i]); }
+
+private:
+    const T* p_;
+    std::size_t n_;
+};
+
+inline std::string_view str(const char* s) noexcept
+    { return s ? std::string_view(s) : std::string_view(); }
+
+inline std::string_view slice(const McStrSlice& s) noexcept
+    { return std::string_view(s.ptr, s.len); }
+
+/* Releases the memory resource block holding a parsed object */
+struct Block {
+    std::pmr::memory_resource* mr = nullptr;
+    void* ptr = nullptr;
+    std::size_t size = 0;
+
+    void release() noexcept {
+        if (ptr) {
+            mr->deallocate(ptr, size, alignof(std::max_align_t));
+            ptr = nullptr;
+        }
+    }
+};
+
+/*
+ * Parses into a fixed arena backed by a block from the memory
+ * resource. Each object is a single allocation, a failed attempt
+ * tells exactly how much space is needed for the next one.
+ */
+template<class T>
+T* parse_into(
+    T* (*parse)(McArena*, const void*, size_t),
+    Bytes data,
+    std::pmr::memory_resource* mr,
+    Block* block)
+{
+    std::size_t size = 2 * data.size() + 256;
+
+    for (;;) {
+        void* buf = mr->allocate(size, alignof(std::max_align_t));
+        McArena* arena = mc_arena_new_fixed(buf, size);
+        T* obj = parse(arena, data.data(), data.size());
+        const std::size_t needed = mc_arena_needed(arena);
+
+        mc_arena_free(arena);
+        if (obj) {
+            block->release();
+            block->mr = mr;
+            block->ptr = buf;
+            block->size = size;
+            return obj;
+        }
+        mr->deallocate(buf, size, alignof(std::max_align_t));
+        if (!needed) {
+            return nullptr;
+        }
+        size = (needed > size ? needed : size) + alignof(std::max_align_t);
+    }
+}
+
+} // namespace detail
+
+using StrSliceRange = detail::ArrayRange<McStrSlice, std::string_view,
+    detail::slice>;
+
+/*
+ * NULL-terminated list of strings, e.g. property values. If the lengths
+ * are known (record values carry them), neither the iterator nor size()
+ * need strlen(), otherwise (e.g. MeCard fields) they are computed.
+ */
+class StrList {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::string_view;
+
+        constexpr iterator() noexcept : p_(nullptr), len_(nullptr) {}
+        constexpr iterator(const McStr* p, const std::size_t* len)
+            noexcept : p_(p), len_(len) {}
+
+        std::string_view operator*() const noexcept
+            { return len_ ? std::string_view(*p_, *len_) :
+                std::string_view(*p_); }
+        iterator& operator++() noexcept
+            { ++p_; if (len_) ++len_; return *this; }
+        iterator operator++(int) noexcept
+            { iterator it(*this); ++*this; return it; }
+        bool operator==(iterator it) const noexcept
+            { return at_end() ? it.at_end() : p_ == it.p_; }
+        bool operator!=(iterator it) const noexcept
+            { return !(*this == it); }
+
+    private:
+        bool at_end() const noexcept { return !p_ || !*p_; }
+        const McStr* p_;
+        const std::size_t* len_;
+    };
+
+    constexpr StrList() noexcept : list_(nullptr), len_(nullptr), n_(0) {}
+    constexpr explicit StrList(const McStr* list) noexcept :
+        list_(list), len_(nullptr), n_(count(list)) {}
+    constexpr StrList(const McStr* list, const std::size_t* len,
+        std::size_t n) noexcept : list_(list), len_(len), n_(n) {}
+
+    iterator begin() const noexcept { return iterator(list_, len_); }
+    iterator end() const noexcept { return iterator(); }
+    bool empty() const noexcept { return !n_; }
+    std::size_t size() const noexcept { return n_; }
+    std::string_view operator[](std::size_t i) const noexcept
+        { return len_ ? std::string_view(list_[i], len_[i]) :
+            std::string_view(list_[i]); }
+
+    /* First value or an empty string */
+    std::string_view front() const noexcept
+        { return empty() ? std::string_view() : (*this)[0]; }
+    const McStr* c_ptr() const noexcept { return list_; }
+
+private:
+    static constexpr std::size_t count(const McStr* list) noexcept {
+        std::size_t n = 0;
+
+        while (list && list[n]) {
+            n++;
+        }
+        return n;
+    }
+
+    const McStr* list_;
+    const std::size_t* len_;
+    std::size_t n_;
+};
+
+class Property {
+public:
+    Property(const McRecord* rec, const McProperty& prop) noexcept :
+        prop_(&prop) {
+        unsigned int n;
+
+        len_ = mc_record_value_lengths(rec, prop_, &n);
+        n_ = n;
+    }
+
+    std::string_view name() const noexcept
+        { return detail::str(prop_->name); }
+    StrList values() const noexcept
+        { return StrList(prop_->values, len_, n_); }
+    const McProperty* c_ptr() const noexcept { return prop_; }
+
+private:
+    const McProperty* prop_;
+    const std::size_t* len_;
+    std::size_t n_;
+};
+
+/* Properties of a record */
+class PropertyRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Property;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Property;
+
+        constexpr iterator() noexcept : rec_(nullptr), i_(0) {}
+        constexpr iterator(const McRecord* rec, std::size_t i) noexcept :
+            rec_(rec), i_(i) {}
+
+        Property operator*() const noexcept
+            { return Property(rec_, rec_->prop[i_]); }
+        Property operator[](difference_type n) const noexcept
+            { return Property(rec_, rec_->prop[i_ + n]); }
+        iterator& operator++() noexcept { ++i_; return *this; }
+        iterator operator++(int) noexcept { return iterator(rec_, i_++); }
+        iterator& operator--() noexcept { --i_; return *this; }
+        iterator operator--(int) noexcept { return iterator(rec_, i_--); }
+        iterator& operator+=(difference_type n) noexcept
+            { i_ += n; return *this; }
+        iterator& operator-=(difference_type n) noexcept
+            { i_ -= n; return *this; }
+        iterator operator+(difference_type n) const noexcept
+            { return iterator(rec_, i_ + n); }
+        iterator operator-(difference_type n) const noexcept
+            { return iterator(rec_, i_ - n); }
+        difference_type operator-(iterator it) const noexcept
+            { return difference_type(i_) - difference_type(it.i_); }
+        bool operator==(iterator it) const noexcept { return i_ == it.i_; }
+        bool operator!=(iterator it) const noexcept { return i_ != it.i_; }
+        bool operator<(iterator it) const noexcept { return i_ < it.i_; }
+        bool operator>(iterator it) const noexcept { return i_ > it.i_; }
+        bool operator<=(iterator it) const noexcept { return i_ <= it.i_; }
+        bool operator>=(iterator it) const noexcept { return i_ >= it.i_; }
+
+    private:
+        const McRecord* rec_;
+        std::size_t i_;
+    };
+
+    constexpr explicit PropertyRange(const McRecord* rec) noexcept :
+        rec_(rec) {}
+
+    iterator begin() const noexcept { return iterator(rec_, 0); }
+    iterator end() const noexcept { return iterator(rec_, size()); }
+    std::size_t size() const noexcept { return rec_->n_prop; }
+    bool empty() const noexcept { return !rec_->n_prop; }
+    Property operator[](std::size_t i) const noexcept
+        { return Property(rec_, rec_->prop[i]); }
+
+private:
+    const McRecord* rec_;
+};
+
+class PropertyView {
+public:
+    constexpr explicit PropertyView(const McPropertyView& prop) noexcept :
+        prop_(&prop) {}
+
+    std::string_view name() const noexcept
+        { return detail::slice(prop_->name); }
+    StrSliceRange values() const noexcept
+        { return StrSliceRange(prop_->values, prop_->n_values); }
+    const McPropertyView* c_ptr() const noexcept { return prop_; }
+
+private:
+    const McPropertyView* prop_;
+};
+
+namespace detail {
+
+inline PropertyView property_view(const McPropertyView& prop) noexcept
+    { return PropertyView(prop); }
+
+} // namespace detail
+
+using PropertyViewRange = detail::ArrayRange<McPropertyView, PropertyView,
+    detail::property_view>;
+
+/* Non-owning record, e.g. allocated from an arena */
+class RecordRef {
+public:
+    constexpr RecordRef() noexcept : rec_(nullptr) {}
+    constexpr explicit RecordRef(const McRecord* rec) noexcept : rec_(rec) {}
+
+    explicit operator bool() const noexcept { return rec_ != nullptr; }
+    std::string_view ident() const noexcept
+        { return detail::str(rec_->ident); }
+    PropertyRange props() const noexcept
+        { return PropertyRange(rec_); }
+    PropertyRange::iterator begin() const noexcept
+        { return props().begin(); }
+    PropertyRange::iterator end() const noexcept { return props().end(); }
+    std::size_t size() const noexcept { return rec_->n_prop; }
+    Property operator[](std::size_t i) const noexcept
+        { return Property(rec_, rec_->prop[i]); }
+    const McRecord* c_ptr() const noexcept { return rec_; }
+
+protected:
+    const McRecord* rec_;
+};
+
+/* Owning record */
+class Record : public RecordRef {
+public:
+    Record() noexcept {}
+    explicit Record(McRecord* rec) noexcept : RecordRef(rec) {}
+    Record(McRecord* rec, const detail::Block& block) noexcept :
+        RecordRef(rec), block_(block) {}
+    Record(Record&& other) noexcept : RecordRef(other), block_(other.block_)
+        { other.rec_ = nullptr; other.block_.ptr = nullptr; }
+    Record(const Record&) = delete;
+    Record& operator=(const Record&) = delete;
+    Record& operator=(Record&& other) noexcept {
+        if (this != &other) {
+            reset();
+            rec_ = std::exchange(other.rec_, nullptr);
+            block_ = other.block_;
+            other.block_.ptr = nullptr;
+        }
+        return *this;
+    }
+    ~Record() { reset(); }
+
+    void reset() noexcept {
+        if (block_.ptr) {
+            block_.release();
+        } else if (rec_) {
+            mc_record_unref(const_cast<McRecord*>(rec_));
+        }
+        rec_ = nullptr;
+    }
+
+private:
+    detail::Block block_;
+};
+
+/* Zero-copy record, see mc_view.h */
+class View {
+public:
+    constexpr View() noexcept : view_(nullptr) {}
+    explicit View(McRecordView* view) noexcept : view_(view) {}
+    View(View&& other) noexcept : view_(std::exchange(other.view_, nullptr))
+        {}
+    View(const View&) = delete;
+    View& operator=(const View&) = delete;
+    View& operator=(View&& other) noexcept {
+        if (this != &other) {
+            mc_record_view_free(view_);
+            view_ = std::exchange(other.view_, nullptr);
+        }
+        return *this;
+    }
+    ~View() { mc_record_view_free(view_); }
+
+    explicit operator bool() const noexcept { return view_ != nullptr; }
+    std::string_view ident() const noexcept
+        { return detail::slice(view_->ident); }
+    PropertyViewRange props() const noexcept
+        { return PropertyViewRange(view_->prop, view_->n_prop); }
+    PropertyViewRange::iterator begin() const noexcept
+        { return props().begin(); }
+    PropertyViewRange::iterator end() const noexcept
+        { return props().end(); }
+    std::size_t size() const noexcept { return view_->n_prop; }
+    PropertyView operator[](std::size_t i) const noexcept
+        { return PropertyView(view_->prop[i]); }
+    const McRecordView* c_ptr() const noexcept { return view_; }
+
+private:
+    McRecordView* view_;
+};
+
+/* Compile-time MECARD field tags, card.get<mc::field::tel>() */
+namespace field {
+
+template<const McStr* ::MeCard::*M>
+struct tag {
+    static constexpr const McStr* ::MeCard::*member = M;
+};
+
+using n = tag<&::MeCard::n>;
+using tel = tag<&::MeCard::tel>;
+using email = tag<&::MeCard::email>;
+using bday = tag<&::MeCard::bday>;
+using adr = tag<&::MeCard::adr>;
+using note = tag<&::MeCard::note>;
+using url = tag<&::MeCard::url>;
+using nickname = tag<&::MeCard::nickname>;
+using org = tag<&::MeCard::org>;
+
+} // namespace field
+
+/* Non-owning card */
+class MeCardRef {
+public:
+    constexpr MeCardRef() noexcept : card_(nullptr) {}
+    constexpr explicit MeCardRef(const ::MeCard* card) noexcept :
+        card_(card) {}
+
+    explicit operator bool() const noexcept { return card_ != nullptr; }
+    template<class F>
+    StrList get() const noexcept { return StrList(card_->*F::member); }
+    const ::MeCard* c_ptr() const noexcept { return card_; }
+
+protected:
+    const ::MeCard* card_;
+};
+
+/* Owning card */
+class MeCard : public MeCardRef {
+public:
+    MeCard() noexcept {}
+    explicit MeCard(::MeCard* card) noexcept : MeCardRef(card) {}
+    MeCard(::MeCard* card, const detail::Block& block) noexcept :
+        MeCardRef(card), block_(block) {}
+    MeCard(MeCard&& other) noexcept : MeCardRef(other), block_(other.block_)
+        { other.card_ = nullptr; other.block_.ptr = nullptr; }
+    MeCard(const MeCard&) = delete;
+    MeCard& operator=(const MeCard&) = delete;
+    MeCard& operator=(MeCard&& other) noexcept {
+        if (this != &other) {
+            reset();
+            card_ = std::exchange(other.card_, nullptr);
+            block_ = other.block_;
+            other.block_.ptr = nullptr;
+        }
+        return *this;
+    }
+    ~MeCard() { reset(); }
+
+    void reset() noexcept {
+        if (block_.ptr) {
+            block_.release();
+        } else if (card_) {
+            mecard_unref(const_cast< ::MeCard*>(card_));
+        }
+        card_ = nullptr;
+    }
+
+private:
+    detail::Block block_;
+};
+
+/* Move-only wrapper for McArena, see mc_arena.h */
+class Arena {
+public:
+    explicit Arena(std::size_t chunk_size = 0) :
+        arena_(mc_arena_new(chunk_size, MC_ARENA_FLAGS_NONE)) {}
+
+    /* Fixed arena over a block taken from the memory resource */
+    Arena(std::size_t size, std::pmr::memory_resource* mr) :
+        arena_(nullptr) {
+        block_.mr = mr;
+        block_.ptr = mr->allocate(size, alignof(std::max_align_t));
+        block_.size = size;
+        arena_ = mc_arena_new_fixed(block_.ptr, size);
+    }
+    Arena(Arena&& other) noexcept :
+        arena_(std::exchange(other.arena_, nullptr)), block_(other.block_)
+        { other.block_.ptr = nullptr; }
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena& operator=(Arena&&) = delete;
+    ~Arena() { mc_arena_free(arena_); block_.release(); }
+
+    void reset() noexcept { mc_arena_reset(arena_); }
+    std::size_t needed() const noexcept { return mc_arena_needed(arena_); }
+    McArena* c_ptr() const noexcept { return arena_; }
+
+private:
+    McArena* arena_;
+    detail::Block block_;
+};
+
+inline Record parse(Bytes data) noexcept
+    { return Record(mc_record_parse_data(data.data(), data.size())); }
+
+inline Record parse(Bytes data, const McParseOptions& opts) noexcept {
+    return Record(mc_record_parse_data_full(data.data(), data.size(),
+        &opts));
+}
+
+/* Valid until the arena is reset or destroyed */
+inline RecordRef parse(Bytes data, Arena& arena) noexcept {
+    return RecordRef(mc_record_parse_data_arena(arena.c_ptr(),
+        data.data(), data.size()));
+}
+
+/* The record is a single block allocated from the memory resource */
+inline Record parse(Bytes data, std::pmr::memory_resource* mr) {
+    detail::Block block;
+    McRecord* rec = detail::parse_into(mc_record_parse_data_arena,
+        data, mr, &block);
+
+    return rec ? Record(rec, block) : Record();
+}
+
+inline Record parse(Bytes data,
+    std::pmr::polymorphic_allocator<std::byte> alloc)
+    { return parse(data, alloc.resource()); }
+
+/* The input buffer must outlive the view */
+inline View parse_view(Bytes data) noexcept
+    { return View(mc_record_view_parse(data.data(), data.size())); }
+
+inline MeCard parse_mecard(Bytes data) noexcept
+    { return MeCard(mecard_parse_data(data.data(), data.size())); }
+
+inline MeCardRef parse_mecard(Bytes data, Arena& arena) noexcept {
+    return MeCardRef(mecard_parse_data_arena(arena.c_ptr(),
+        data.data(), data.size()));
+}
+
+inline MeCard parse_mecard(Bytes data, std::pmr::memory_resource* mr) {
+    detail::Block block;
+    ::MeCard* card = detail::parse_into(mecard_parse_data_arena,
+        data, mr, &block);
+
+    return card ? MeCard(card, block) : MeCard();
+}
+
+inline MeCard parse_mecard(Bytes data,
+    std::pmr::polymorphic_allocator<std::byte> alloc)
+    { return parse_mecard(data, alloc.resource()); }
+
+} // namespace mc
+
+#endif /* MC_HPP */
+
+/*
+ * Local Variables:
+ * mode: C++
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
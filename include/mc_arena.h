@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_ARENA_H
+#define MC_ARENA_H
+
+#include "mc_types.h"
+
+MC_BEGIN_DECLS
+
+/*
+ * Region allocator for bulk parsing. Records and cards parsed with
+ * mc_record_parse_data_arena() and mecard_parse_data_arena() take all
+ * their memory from the arena and are released all at once by
+ * mc_arena_reset() or mc_arena_free(). Referencing and freeing them
+ * (e.g. with mc_record_ref() or mecard_free()) does nothing, they never
+ * outlive the arena.
+ *
+ * A fixed arena never touches the heap. When the data doesn't fit,
+ * the parse call fails and mc_arena_needed() tells how many bytes of
+ * free space that call would have needed.
+ *
+ * The arena is not thread-safe.
+ */
+
+typedef enum mc_arena_flags {
+    MC_ARENA_FLAGS_NONE = 0x00,
+    MC_ARENA_HUGE_PAGES = 0x01  /* Back chunks with huge pages */
+} MC_ARENA_FLAGS;
+
+/* Zero chunk size selects the default one */
+McArena*
+mc_arena_new(
+    size_t chunk_size,
+    MC_ARENA_FLAGS flags);
+
+McArena*
+mc_arena_new_fixed(
+    void* buf,
+    size_t size);
+
+void
+mc_arena_reset(
+    McArena* arena);
+
+void
+mc_arena_free(
+    McArena* arena);
+
+size_t
+mc_arena_needed(
+    const McArena* arena);
+
+MC_END_DECLS
+
+#endif /* MC_ARENA_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
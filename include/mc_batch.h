@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_BATCH_H
+#define MC_BATCH_H
+
+#include "mc_types.h"
+
+MC_BEGIN_DECLS
+
+/*
+ * Parses many payloads at once, spreading them across a process-wide
+ * pool of worker threads (one per core, started on first use). The
+ * calling thread takes part in the work and the call returns when the
+ * whole batch is done. Workers claim chunks of consecutive inputs as
+ * they go, so a few large payloads don't hold the rest of the batch
+ * back. Each thread reuses its own parser scratch state.
+ *
+ * out[i] receives the result of parsing inputs[i], NULL on failure.
+ * The return value is the number of successfully parsed inputs. The
+ * results are independent of each other and are freed as usual.
+ *
+ * Parse options only apply to records. mecard_parse_batch() rejects
+ * them: with non-NULL opts->parse nothing gets parsed, out is left
+ * untouched and zero is returned.
+ */
+
+struct mc_input {
+    const void* data;
+    size_t size;
+};
+
+struct mc_batch_options {
+    const McParseOptions* parse; /* Records only, NULL for defaults */
+    unsigned int max_threads;    /* Including the caller, 0 = all cores */
+    size_t chunk_size;           /* Inputs per claim, 0 = automatic */
+};
+
+/* NULL options select the defaults */
+size_t
+mc_record_parse_batch(
+    const McInput* inputs,
+    size_t n,
+    McRecord** out,
+    const McBatchOptions* opts);
+
+size_t
+mecard_parse_batch(
+    const McInput* inputs,
+    size_t n,
+    MeCard** out,
+    const McBatchOptions* opts);
+
+MC_END_DECLS
+
+#endif /* MC_BATCH_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
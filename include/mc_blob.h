@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_BLOB_H
+#define MC_BLOB_H
+
+#include "mc_view.h"
+
+MC_BEGIN_DECLS
+
+/*
+ * Relocatable serialized form of a record. The blob contains offsets
+ * rather than pointers (little-endian, 32-bit, relative to the start
+ * of the blob) so it can be copied, stored on disk or mapped at any
+ * address and shared between processes. Strings are stored with their
+ * lengths and are NUL-terminated.
+ *
+ * mc_record_to_blob() returns the size of the blob, zero if it's too
+ * large (over 4G) or the record is NULL. The blob is stored only if it
+ * fits, i.e. if the size doesn't exceed the size of the buffer. No
+ * particular alignment of the buffer is required.
+ *
+ * mc_record_view_blob() creates a view of the blob, which is used in
+ * place, i.e. it must stay alive and unchanged for as long as the view
+ * is in use. Nothing gets copied, only the property and value tables
+ * are allocated. Malformed or truncated blobs are rejected, every
+ * offset is checked against the bounds of the blob (but the contents
+ * of the strings are not checked).
+ */
+
+size_t
+mc_record_to_blob(
+    const McRecord* rec,
+    void* buf,
+    size_t size);
+
+McRecordView*
+mc_record_view_blob(
+    const void* blob,
+    size_t size);
+
+/* Keeps a reference to GBytes until the view is freed */
+McRecordView*
+mc_record_view_blob_bytes(
+    struct _GBytes* bytes);
+
+MC_END_DECLS
+
+#endif /* MC_BLOB_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
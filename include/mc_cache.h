@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_CACHE_H
+#define MC_CACHE_H
+
+#include "mc_types.h"
+
+MC_BEGIN_DECLS
+
+/*
+ * Thread-safe cache of parse results, keyed by the payload. Repeated
+ * parsing of the same payload (e.g. the same code seen by the camera
+ * frame after frame) becomes a hash and a lookup. Results are shared,
+ * they must be treated as immutable and released by the caller with
+ * mc_record_unref() or mecard_unref().
+ *
+ * By default failures are cached too, a payload which didn't parse
+ * keeps returning NULL without being parsed again until its entry is
+ * evicted. MC_PARSE_CACHE_NO_FAILURES makes the cache remember only
+ * the payloads which parsed successfully.
+ *
+ * The cache is split into shards with separate locks, each of which
+ * evicts the least recently used entries when it runs out of space.
+ * The size limit covers the copies of the payloads and the parse
+ * results, zero selects the default (1 MiB). Results which alone take
+ * more than a shard can hold are not cached.
+ */
+
+typedef enum mc_parse_cache_flags {
+    MC_PARSE_CACHE_FLAGS_NONE = 0x00,
+    MC_PARSE_CACHE_NO_FAILURES = 0x01  /* Don't cache failed parses */
+} MC_PARSE_CACHE_FLAGS;
+
+McParseCache*
+mc_parse_cache_new(
+    size_t max_bytes);
+
+McParseCache*
+mc_parse_cache_new_full(
+    size_t max_bytes,
+    MC_PARSE_CACHE_FLAGS flags);
+
+void
+mc_parse_cache_free(
+    McParseCache* cache);
+
+void
+mc_parse_cache_clear(
+    McParseCache* cache);
+
+McRecord*
+mc_parse_cache_record(
+    McParseCache* cache,
+    const void* data,
+    size_t size);
+
+MeCard*
+mc_parse_cache_mecard(
+    McParseCache* cache,
+    const void* data,
+    size_t size);
+
+/* Total size of the cached entries */
+size_t
+mc_parse_cache_size(
+    McParseCache* cache);
+
+MC_END_DECLS
+
+#endif /* MC_CACHE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_COMPACT_H
+#define MC_COMPACT_H
+
+#include "mc_types.h"
+
+MC_BEGIN_DECLS
+
+/*
+ * Compact read-only representation of a record, for keeping large
+ * numbers of them in memory. It's a single memory block with 32-bit
+ * offsets instead of pointers and unpadded strings. The identifier and
+ * the well-known property names (those used by the typed structures)
+ * aren't stored in the block at all, they point to static storage
+ * shared by all records.
+ *
+ * Unlike McRecord, there are no public structures to walk, everything
+ * is accessed through the functions below. Properties are indexed from
+ * zero, the values of each property too. All strings are NUL-terminated
+ * and their lengths are returned too (if len isn't NULL). Out of range
+ * indices yield NULL strings and zero lengths.
+ */
+
+McCompactRecord*
+mc_compact_record_parse(
+    const void* data,
+    size_t size);
+
+/* NULL options are equivalent to mc_compact_record_parse() */
+McCompactRecord*
+mc_compact_record_parse_full(
+    const void* data,
+    size_t size,
+    const McParseOptions* opts);
+
+/* Converts an existing record */
+McCompactRecord*
+mc_compact_record_new(
+    const McRecord* rec);
+
+void
+mc_compact_record_free(
+    McCompactRecord* rec);
+
+/* Size of the memory block */
+size_t
+mc_compact_record_size(
+    const McCompactRecord* rec);
+
+const char*
+mc_compact_record_ident(
+    const McCompactRecord* rec,
+    size_t* len);
+
+unsigned int
+mc_compact_record_n_prop(
+    const McCompactRecord* rec);
+
+const char*
+mc_compact_record_name(
+    const McCompactRecord* rec,
+    unsigned int prop,
+    size_t* len);
+
+unsigned int
+mc_compact_record_n_values(
+    const McCompactRecord* rec,
+    unsigned int prop);
+
+const char*
+mc_compact_record_value(
+    const McCompactRecord* rec,
+    unsigned int prop,
+    unsigned int i,
+    size_t* len);
+
+/*
+ * Property lookup by name, using the hash table stored in the record
+ * (like mc_record_lookup()). mc_compact_record_lookup() returns the
+ * index of the first property with this name, -1 if there's none.
+ * mc_compact_record_lookup_next() returns the next property with the
+ * same name as prop.
+ */
+int
+mc_compact_record_lookup(
+    const McCompactRecord* rec,
+    const char* name);
+
+int
+mc_compact_record_lookup_next(
+    const McCompactRecord* rec,
+    unsigned int prop);
+
+MC_END_DECLS
+
+#endif /* MC_COMPACT_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
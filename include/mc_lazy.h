@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_LAZY_H
+#define MC_LAZY_H
+
+#include "mc_types.h"
+#include "mc_view.h"
+
+MC_BEGIN_DECLS
+
+/*
+ * Record which decodes its values only when they are read. Names and
+ * the identifier point into the input buffer (like in McRecordView),
+ * which therefore must stay alive and unchanged for as long as the
+ * record is in use. Each value is stored as the raw slice of the input
+ * plus the needs_unescape bit. Values which don't need unescaping (or
+ * Shift-JIS decoding) are their own raw slices, the rest get decoded
+ * by mc_property_value() the first time they are read, into the space
+ * reserved in the record. Raw slices and lengths are always valid.
+ *
+ * mc_property_value() may be called from several threads at the same
+ * time. The whole record is a single memory block, freed by
+ * mc_lazy_record_free()
+ */
+
+struct mc_lazy_value {
+    McStrSlice raw;
+    size_t len;                     /* Of the decoded value */
+    unsigned int needs_unescape;
+};
+
+struct mc_lazy_property {
+    McStrSlice name;
+    const McLazyValue* values;
+    unsigned int n_values;
+};
+
+struct mc_lazy_record {
+    McStrSlice ident;
+    const McLazyProperty* prop;
+    unsigned int n_prop;
+};
+
+struct _GBytes;
+
+McLazyRecord*
+mc_lazy_record_parse(
+    const void* data,
+    size_t size);
+
+/* Keeps a reference to GBytes until the record is freed */
+McLazyRecord*
+mc_lazy_record_parse_bytes(
+    struct _GBytes* bytes);
+
+void
+mc_lazy_record_free(
+    McLazyRecord* rec);
+
+/*
+ * Returns the decoded value (not NUL-terminated) and its length, NULL
+ * if the index is out of range.
+ */
+const char*
+mc_property_value(
+    const McLazyProperty* prop,
+    unsigned int i,
+    size_t* len);
+
+MC_END_DECLS
+
+#endif /* MC_LAZY_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
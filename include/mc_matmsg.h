@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_MATMSG_H
+#define MC_MATMSG_H
+
+#include "mc_types.h"
+
+MC_BEGIN_DECLS
+
+/*
+ * E-mail message (MATMSG). Missing fields are NULL. The recipients are
+ * a NULL-terminated list of all the TO values. Unescaped commas in the
+ * subject and the body are kept, i.e. "BODY:x,y" gives "x,y" (empty
+ * values are dropped though, "x,,y" gives "x,y" too).
+ */
+struct mat_msg {
+    const McStr* to;  /* TO */
+    const char* sub;  /* SUB */
+    const char* body; /* BODY */
+};
+
+MatMsg*
+matmsg_parse_data(
+    const void* data,
+    size_t size);
+
+MatMsg*
+matmsg_parse(
+    const char* str);
+
+/* Same as mc_record_encode() and mc_record_encode_string() */
+size_t
+matmsg_encode(
+    const MatMsg* matmsg,
+    char* buf,
+    size_t size);
+
+char*
+matmsg_encode_string(
+    const MatMsg* matmsg);
+
+void
+matmsg_free(
+    MatMsg* matmsg);
+
+MC_END_DECLS
+
+#endif /* MC_MATMSG_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2020-2022 by Slava Monich <slava@monich.com>
+ * Copyright (C) 2020-2026 by Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -58,10 +58,41 @@ mecard_parse_data(
     const void* data,
     size_t size);
 
+/* See mc_arena.h */
+MeCard*
+mecard_parse_data_arena(
+    McArena* arena,
+    const void* data,
+    size_t size);
+
 MeCard*
 mecard_parse(
     const char* str);
 
+/* Same as mc_record_encode() and mc_record_encode_string() */
+size_t
+mecard_encode(
+    const MeCard* mecard,
+    char* buf,
+    size_t size);
+
+char*
+mecard_encode_string(
+    const MeCard* mecard);
+
+/*
+ * Cards are reference counted (except for those allocated from an
+ * arena, for which these are no-ops) and may be shared between threads.
+ * mecard_free() is the same as mecard_unref().
+ */
+MeCard*
+mecard_ref(
+    MeCard* mecard);
+
+void
+mecard_unref(
+    MeCard* mecard);
+
 void
 mecard_free(
     MeCard* mecard);
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2020 by Slava Monich <slava@monich.com>
+ * Copyright (C) 2020-2026 by Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -57,10 +57,148 @@ mc_record_parse_data(
     const void* data,
     size_t size);
 
+/* See mc_arena.h */
+McRecord*
+mc_record_parse_data_arena(
+    McArena* arena,
+    const void* data,
+    size_t size);
+
 McRecord*
 mc_record_parse(
     const char* str);
 
+/*
+ * By default non-ASCII characters are decoded one by one as UTF-8 if
+ * possible, then as Shift-JIS and then as ISO8Bit, which is copied to
+ * the output as is. If the source encoding is known in advance, the
+ * other decoders aren't even tried and the characters which the
+ * selected one can't handle make the record invalid.
+ *
+ * MC_CHARSET_DETECT picks one encoding for the whole record, see
+ * mc_record_detect_charset(). With anything but MC_CHARSET_AUTO the
+ * output is always valid UTF-8, Latin-1 gets converted.
+ */
+typedef enum mc_charset {
+    MC_CHARSET_AUTO,
+    MC_CHARSET_UTF8,
+    MC_CHARSET_SHIFT_JIS,
+    MC_CHARSET_LATIN1,
+    MC_CHARSET_DETECT
+} MC_CHARSET;
+
+/*
+ * Limits protect against hostile input, zero means no limit. Lengths
+ * are those of the decoded strings (without the terminating NUL) and
+ * the output size is the total length of the identifier, the names
+ * and the values. Input exceeding any of the limits is rejected before
+ * anything gets allocated.
+ */
+struct mc_parse_options {
+    MC_CHARSET charset;
+    unsigned int max_props;
+    unsigned int max_values;    /* Per property */
+    size_t max_value_len;
+    size_t max_output;
+};
+
+/* NULL options are equivalent to mc_record_parse_data() */
+McRecord*
+mc_record_parse_data_full(
+    const void* data,
+    size_t size,
+    const McParseOptions* opts);
+
+/*
+ * Returns MC_CHARSET_UTF8 if all the non-ASCII bytes form valid UTF-8
+ * (which includes pure ASCII), otherwise MC_CHARSET_SHIFT_JIS if they
+ * all form mapped Shift-JIS pairs, otherwise MC_CHARSET_LATIN1. Never
+ * returns MC_CHARSET_AUTO or MC_CHARSET_DETECT.
+ */
+MC_CHARSET
+mc_record_detect_charset(
+    const void* data,
+    size_t size);
+
+/*
+ * Property lookup by name, using the hash table stored in the record.
+ * mc_record_lookup() returns the first property with the given name.
+ * mc_record_lookup_all() stores up to max matching properties (in the
+ * order in which they appear in the record) and returns the total
+ * number of matches.
+ */
+const McProperty*
+mc_record_lookup(
+    const McRecord* rec,
+    const char* name);
+
+unsigned int
+mc_record_lookup_all(
+    const McRecord* rec,
+    const char* name,
+    const McProperty** props,
+    unsigned int max);
+
+/*
+ * Lengths of the property values (in the same order as prop->values)
+ * and their number, both taken from the table stored in the record.
+ * Returns NULL if the property has no values (or doesn't belong to
+ * the record).
+ */
+const size_t*
+mc_record_value_lengths(
+    const McRecord* rec,
+    const McProperty* prop,
+    unsigned int* n_values);
+
+/*
+ * Encoding, the reverse of parsing. Separators and backslashes in the
+ * values are escaped, empty values are dropped (the grammar has no way
+ * to express them), everything else is copied as is. The identifier and
+ * the names must be valid, the values must be UTF-8 and may not contain
+ * control characters other than CR and LF, otherwise the record can't
+ * be encoded. An encoded record parses back into an identical one.
+ *
+ * mc_record_encode() returns the length of the encoded record, zero if
+ * it can't be encoded. The output is stored and NUL-terminated only if
+ * it fits, i.e. if the length is less than size.
+ *
+ * mc_record_encode_string() and mc_record_encode_batch() allocate the
+ * output which must be deallocated with g_free(). The batch is a single
+ * block holding NUL-terminated records one after another, offsets (if
+ * not NULL) must have room for n + 1 entries and receives the offset of
+ * each record plus the total size of the block. The batch fails if any
+ * of the records can't be encoded, offsets are left untouched then.
+ */
+size_t
+mc_record_encode(
+    const McRecord* rec,
+    char* buf,
+    size_t size);
+
+char*
+mc_record_encode_string(
+    const McRecord* rec);
+
+char*
+mc_record_encode_batch(
+    const McRecord* const* recs,
+    size_t n,
+    size_t* offsets);
+
+/*
+ * Records are reference counted (except for those allocated from an
+ * arena, for which these are no-ops) and may be shared between threads.
+ * mc_record_free() is the same as mc_record_unref().
+ */
+McRecord*
+mc_record_ref(
+    McRecord* rec);
+
+void
+mc_record_unref(
+    McRecord* rec);
+
 void
 mc_record_free(
     McRecord* rec);
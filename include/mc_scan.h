@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_SCAN_H
+#define MC_SCAN_H
+
+#include "mc_types.h"
+
+MC_BEGIN_DECLS
+
+/*
+ * Event-based parsing. mc_record_scan() walks the record and reports
+ * what it finds without allocating anything. The strings point into
+ * the input data and are not NUL-terminated. Empty values are skipped.
+ *
+ * Values are passed as they appear in the input. If needs_unescape is
+ * non-zero, the value contains escape sequences or Shift-JIS characters
+ * and has to be decoded with mc_scan_unescape() to get the same string
+ * as mc_record_parse_data() would produce.
+ *
+ * Any callback can be NULL. Returning zero from a callback stops the
+ * scan. Note that callbacks may be invoked before it turns out that
+ * the record is malformed.
+ *
+ * Returns non-zero if the entire record has been scanned and is well
+ * formed, zero if it's malformed or the scan has been stopped.
+ */
+
+struct mc_scan_callbacks {
+    int (*on_ident)(const char* ident, size_t len, void* user_data);
+    int (*on_property_begin)(const char* name, size_t len, void* user_data);
+    int (*on_value)(const char* ptr, size_t len, int needs_unescape,
+        void* user_data);
+    int (*on_property_end)(void* user_data);
+};
+
+int
+mc_record_scan(
+    const void* data,
+    size_t size,
+    const McScanCallbacks* cb,
+    void* user_data);
+
+/*
+ * Decodes the value into the buffer. Returns the length of the decoded
+ * value, even if it doesn't fit (in which case nothing is written).
+ * The result is not NUL-terminated.
+ */
+size_t
+mc_scan_unescape(
+    const char* ptr,
+    size_t len,
+    char* buf,
+    size_t size);
+
+/*
+ * Finds the first non-empty value of the named property and decodes it
+ * into the buffer. Values of other properties are jumped over without
+ * being decoded or validated, and the rest of the record isn't even
+ * looked at. Returns the length of the value, zero if there's no such
+ * property. The value is stored and NUL-terminated only if it fits,
+ * i.e. if the length is less than out_len.
+ */
+size_t
+mc_extract_value(
+    const void* data,
+    size_t size,
+    const char* name,
+    char* out_buf,
+    size_t out_len);
+
+MC_END_DECLS
+
+#endif /* MC_SCAN_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_STATS_H
+#define MC_STATS_H
+
+#include "mc_types.h"
+
+#include <stdint.h>
+
+MC_BEGIN_DECLS
+
+/*
+ * Runtime statistics. Collection is off by default and costs next to
+ * nothing until it's enabled with mc_stats_enable(). Counters are kept
+ * per thread, mc_stats_get() adds them up (including those of threads
+ * which have already exited). The numbers collected by other threads
+ * while mc_stats_get() or mc_stats_reset() is running may or may not
+ * be included. Everything counted before mc_stats_reset() was called
+ * is gone for good though, a concurrent reset is never undone.
+ *
+ * Only the calls listed in MC_STATS_ENTRY are counted. Each failed call
+ * contributes exactly one failure reason, and values are counted for
+ * the calls which have decoded them, so the totals add up to the
+ * per-entry numbers.
+ */
+
+typedef enum mc_stats_failure {
+    MC_STATS_FAIL_NO_IDENT,         /* Empty input, no identifier */
+    MC_STATS_FAIL_BAD_IDENT,        /* Malformed identifier */
+    MC_STATS_FAIL_TRAILING_GARBAGE, /* Unparseable stuff after properties */
+    MC_STATS_FAIL_WRONG_IDENT,      /* E.g. not MECARD for mecard_parse */
+    MC_STATS_FAIL_LIMIT,            /* McParseOptions limit exceeded */
+    MC_STATS_FAIL_COUNT
+} MC_STATS_FAILURE;
+
+/* Values are attributed to the slowest decoder they have gone through */
+typedef enum mc_stats_path {
+    MC_STATS_PATH_ASCII,
+    MC_STATS_PATH_UTF8,
+    MC_STATS_PATH_SHIFT_JIS,
+    MC_STATS_PATH_ISO8BIT,
+    MC_STATS_PATH_COUNT
+} MC_STATS_PATH;
+
+typedef enum mc_stats_entry {
+    MC_STATS_ENTRY_RECORD,          /* mc_record_parse_data() and co */
+    MC_STATS_ENTRY_MECARD,          /* mecard_parse_data() and co */
+    MC_STATS_ENTRY_TYPED,           /* Other typed records */
+    MC_STATS_ENTRY_SCAN,            /* mc_record_scan() */
+    MC_STATS_ENTRY_COMPACT,         /* mc_compact_record_parse() and co */
+    MC_STATS_ENTRY_COUNT
+} MC_STATS_ENTRY;
+
+/*
+ * Bucket k of the latency histogram counts calls which took between
+ * 2^k and 2^(k+1) nanoseconds, the last one also counts everything
+ * slower than that.
+ */
+#define MC_STATS_LATENCY_BUCKETS (32)
+
+struct mc_stats {
+    uint64_t records;   /* Successfully parsed */
+    uint64_t bytes;     /* Input bytes, parsed or not */
+    uint64_t failures[MC_STATS_FAIL_COUNT];
+    uint64_t values[MC_STATS_PATH_COUNT];
+    uint64_t latency[MC_STATS_ENTRY_COUNT][MC_STATS_LATENCY_BUCKETS];
+};
+
+void
+mc_stats_enable(
+    int enable);
+
+int
+mc_stats_enabled(
+    void);
+
+void
+mc_stats_get(
+    McStats* stats);
+
+void
+mc_stats_reset(
+    void);
+
+MC_END_DECLS
+
+#endif /* MC_STATS_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_STREAM_H
+#define MC_STREAM_H
+
+#include "mc_types.h"
+
+MC_BEGIN_DECLS
+
+/*
+ * Incremental parser for the data arriving in pieces. Chunks may be
+ * split anywhere, including the middle of an escape sequence or of a
+ * multi-byte character. The input doesn't have to stay around after
+ * mc_record_stream_feed() returns, only the decoded data is kept.
+ *
+ * mc_record_stream_feed() returns zero as soon as it becomes clear
+ * that the data can't be parsed. Anything that follows the record
+ * terminator is ignored.
+ *
+ * mc_record_stream_finish() returns the record (to be deallocated with
+ * mc_record_free()) or NULL, and resets the stream so that it can be
+ * reused for the next record.
+ *
+ * A stream must not be used by more than one thread at a time.
+ */
+
+McRecordStream*
+mc_record_stream_new(
+    void);
+
+int
+mc_record_stream_feed(
+    McRecordStream* stream,
+    const void* data,
+    size_t len);
+
+McRecord*
+mc_record_stream_finish(
+    McRecordStream* stream);
+
+void
+mc_record_stream_free(
+    McRecordStream* stream);
+
+MC_END_DECLS
+
+#endif /* MC_STREAM_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2020 by Slava Monich <slava@monich.com>
+ * Copyright (C) 2020-2026 by Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -51,6 +51,26 @@ typedef const char* McStr;
 typedef struct mc_property McProperty;
 typedef struct mc_record McRecord;
 typedef struct me_card MeCard;
+typedef struct me_bkm MeBkm;
+typedef struct mat_msg MatMsg;
+typedef struct me_loc MeLoc;
+typedef struct wi_fi WiFi;
+typedef struct mc_str_slice McStrSlice;
+typedef struct mc_property_view McPropertyView;
+typedef struct mc_record_view McRecordView;
+typedef struct mc_compact_record McCompactRecord;
+typedef struct mc_lazy_value McLazyValue;
+typedef struct mc_lazy_property McLazyProperty;
+typedef struct mc_lazy_record McLazyRecord;
+typedef struct mc_arena McArena;
+typedef struct mc_parser McParser;
+typedef struct mc_parse_cache McParseCache;
+typedef struct mc_parse_options McParseOptions;
+typedef struct mc_record_stream McRecordStream;
+typedef struct mc_scan_callbacks McScanCallbacks;
+typedef struct mc_stats McStats;
+typedef struct mc_input McInput;
+typedef struct mc_batch_options McBatchOptions;
 
 #endif /* MC_TYPES_H */
 
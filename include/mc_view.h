@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_VIEW_H
+#define MC_VIEW_H
+
+#include "mc_types.h"
+
+MC_BEGIN_DECLS
+
+/*
+ * Zero-copy view of a record. Names, identifier and values which don't
+ * need decoding point directly into the input buffer, which therefore
+ * must stay alive (and unchanged) for as long as the view is in use.
+ * Only values containing escapes or Shift-JIS characters are decoded
+ * (into the memory block owned by the view). Slices are NOT NULL
+ * terminated.
+ *
+ * The whole view is a single memory block, freed by mc_record_view_free()
+ */
+
+struct mc_str_slice {
+    const char* ptr;
+    size_t len;
+};
+
+struct mc_property_view {
+    McStrSlice name;
+    const McStrSlice* values;
+    unsigned int n_values;
+};
+
+struct mc_record_view {
+    McStrSlice ident;
+    const McPropertyView* prop;
+    unsigned int n_prop;
+};
+
+struct _GBytes;
+
+McRecordView*
+mc_record_view_parse(
+    const void* data,
+    size_t size);
+
+/* Keeps a reference to GBytes until the view is freed */
+McRecordView*
+mc_record_view_parse_bytes(
+    struct _GBytes* bytes);
+
+void
+mc_record_view_free(
+    McRecordView* view);
+
+MC_END_DECLS
+
+#endif /* MC_VIEW_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
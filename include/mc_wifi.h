@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_WIFI_H
+#define MC_WIFI_H
+
+#include "mc_types.h"
+
+MC_BEGIN_DECLS
+
+/*
+ * Wi-Fi network configuration (WIFI). Missing fields are NULL.
+ * Unescaped commas (e.g. in the SSID) are kept like in MATMSG, see
+ * mc_matmsg.h.
+ */
+struct wi_fi {
+    const char* type;     /* T */
+    const char* ssid;     /* S */
+    const char* password; /* P */
+    const char* hidden;   /* H */
+};
+
+WiFi*
+wifi_parse_data(
+    const void* data,
+    size_t size);
+
+WiFi*
+wifi_parse(
+    const char* str);
+
+/* Same as mc_record_encode() and mc_record_encode_string() */
+size_t
+wifi_encode(
+    const WiFi* wifi,
+    char* buf,
+    size_t size);
+
+char*
+wifi_encode_string(
+    const WiFi* wifi);
+
+void
+wifi_free(
+    WiFi* wifi);
+
+MC_END_DECLS
+
+#endif /* MC_WIFI_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -28,14 +28,22 @@ Requires: %{name} = %{version}
 %description devel
 This package contains the development library for %{name}.
 
+%package tools
+Summary: Command line tools for %{name}
+
+%description tools
+This package contains mc-scan, the bulk mobile code scanner.
+
 %prep
 %setup -q
 
 %build
 make %{_smp_mflags} LIBDIR=%{_libdir} KEEP_SYMBOLS=1 release pkgconfig
+make %{_smp_mflags} KEEP_SYMBOLS=1 tools
 
 %install
 make LIBDIR=%{_libdir} DESTDIR=%{buildroot} install-dev
+make DESTDIR=%{buildroot} install-tools
 
 %check
 make test
@@ -57,3 +65,8 @@ make test
 %{_libdir}/pkgconfig/*.pc
 %{_libdir}/%{name}.so
 %{_includedir}/mc/*.h
+%{_includedir}/mc/*.hpp
+
+%files tools
+%defattr(-,root,root,-)
+%{_bindir}/mc-scan
@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_arena_p.h"
+#include "mc_arena.h"
+
+#include <sys/mman.h>
+
+#define MC_ARENA_DEFAULT_CHUNK_SIZE (64*1024)
+#define MC_ARENA_HUGE_PAGE_SIZE (2*1024*1024)
+
+typedef struct mc_arena_chunk McArenaChunk;
+struct mc_arena_chunk {
+    McArenaChunk* next;
+    gsize size;
+    gsize used;
+    guint8* data;
+    gboolean mapped;
+};
+
+struct mc_arena {
+    McArenaChunk* chunk;
+    McArenaChunk fixed;
+    gsize chunk_size;
+    gsize needed;
+    MC_ARENA_FLAGS flags;
+};
+
+static
+McArenaChunk*
+mc_arena_chunk_map(
+    gsize size)
+{
+#ifdef __linux__
+    /* Round the size up to the huge page boundary */
+    const gsize mapsize = (size + MC_ARENA_HUGE_PAGE_SIZE - 1) &
+        ~((gsize)MC_ARENA_HUGE_PAGE_SIZE - 1);
+    void* mem = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    mem = mmap(NULL, mapsize, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (mem == MAP_FAILED) {
+        /* No reserved huge pages, try transparent ones */
+        mem = mmap(NULL, mapsize, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+        if (mem != MAP_FAILED) {
+            madvise(mem, mapsize, MADV_HUGEPAGE);
+        }
+#endif
+    }
+    if (mem != MAP_FAILED) {
+        McArenaChunk* chunk = g_new0(McArenaChunk, 1);
+
+        chunk->data = mem;
+        chunk->size = mapsize;
+        chunk->mapped = TRUE;
+        return chunk;
+    }
+#endif /* __linux__ */
+    return NULL;
+}
+
+static
+McArenaChunk*
+mc_arena_chunk_new(
+    McArena* arena,
+    gsize min_size)
+{
+    const gsize size = MAX(arena->chunk_size, min_size);
+    McArenaChunk* chunk = NULL;
+
+    if (arena->flags & MC_ARENA_HUGE_PAGES) {
+        chunk = mc_arena_chunk_map(size);
+    }
+    if (!chunk) {
+        /* The header and the data share the same allocation */
+        chunk = g_malloc(SIZE_ALIGN(sizeof(McArenaChunk)) + size);
+        memset(chunk, 0, sizeof(*chunk));
+        chunk->data = ((guint8*)chunk) + SIZE_ALIGN(sizeof(McArenaChunk));
+        chunk->size = size;
+    }
+    return chunk;
+}
+
+static
+void
+mc_arena_chunk_free(
+    McArenaChunk* chunk)
+{
+    if (chunk->mapped) {
+        munmap(chunk->data, chunk->size);
+    }
+    g_free(chunk);
+}
+
+static
+void
+mc_arena_free_chunks(
+    McArenaChunk* chunk)
+{
+    while (chunk) {
+        McArenaChunk* next = chunk->next;
+
+        mc_arena_chunk_free(chunk);
+        chunk = next;
+    }
+}
+
+static
+gboolean
+mc_arena_is_fixed(
+    const McArena* arena)
+{
+    return arena->chunk == &arena->fixed;
+}
+
+McArena*
+mc_arena_new(
+    size_t chunk_size,
+    MC_ARENA_FLAGS flags)
+{
+    McArena* arena = g_new0(McArena, 1);
+
+    arena->chunk_size = chunk_size ? chunk_size : MC_ARENA_DEFAULT_CHUNK_SIZE;
+    arena->flags = flags;
+    return arena;
+}
+
+McArena*
+mc_arena_new_fixed(
+    void* buf,
+    size_t size)
+{
+    McArena* arena = g_new0(McArena, 1);
+    McArenaChunk* chunk = &arena->fixed;
+
+    /* Make sure that allocations are properly aligned */
+    chunk->data = buf;
+    if (buf && size) {
+        const gsize pad = SIZE_ALIGN((gsize)buf) - (gsize)buf;
+
+        if (size > pad) {
+            chunk->data += pad;
+            chunk->size = size - pad;
+        }
+    }
+    arena->chunk = chunk;
+    return arena;
+}
+
+void
+mc_arena_reset(
+    McArena* arena)
+{
+    if (arena) {
+        McArenaChunk* chunk = arena->chunk;
+
+        /* Keep the most recently allocated chunk for reuse */
+        if (chunk) {
+            if (!mc_arena_is_fixed(arena)) {
+                mc_arena_free_chunks(chunk->next);
+                chunk->next = NULL;
+            }
+            chunk->used = 0;
+        }
+        arena->needed = 0;
+    }
+}
+
+void
+mc_arena_free(
+    McArena* arena)
+{
+    if (arena) {
+        if (!mc_arena_is_fixed(arena)) {
+            mc_arena_free_chunks(arena->chunk);
+        }
+        g_free(arena);
+    }
+}
+
+size_t
+mc_arena_needed(
+    const McArena* arena)
+{
+    return arena ? arena->needed : 0;
+}
+
+gpointer
+mc_arena_alloc0(
+    McArena* arena,
+    gsize size)
+{
+    McArenaChunk* chunk = arena->chunk;
+    gpointer ptr;
+
+    size = SIZE_ALIGN(size);
+    if (!chunk || (chunk->size - chunk->used) < size) {
+        if (mc_arena_is_fixed(arena)) {
+            arena->needed = size;
+            return NULL;
+        }
+        chunk = mc_arena_chunk_new(arena, size);
+        chunk->next = arena->chunk;
+        arena->chunk = chunk;
+    }
+    ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+void
+mc_arena_mark(
+    const McArena* arena,
+    McArenaMark* mark)
+{
+    mark->chunk = arena->chunk;
+    mark->used = arena->chunk ? arena->chunk->used : 0;
+}
+
+gsize
+mc_arena_rollback(
+    McArena* arena,
+    const McArenaMark* mark)
+{
+    McArenaChunk* chunk = arena->chunk;
+
+    /* Only allocations from the same chunk can be rolled back */
+    if (chunk && chunk == mark->chunk) {
+        const gsize released = chunk->used - mark->used;
+
+        chunk->used = mark->used;
+        return released;
+    }
+    return 0;
+}
+
+void
+mc_arena_set_needed(
+    McArena* arena,
+    gsize needed)
+{
+    arena->needed = needed;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_ARENA_PRIVATE_H
+#define MC_ARENA_PRIVATE_H
+
+#include "mc_types_p.h"
+
+/*
+ * Position in the arena, for rolling back allocations which turned out
+ * to be useless.
+ */
+typedef struct mc_arena_mark {
+    gconstpointer chunk;
+    gsize used;
+} McArenaMark;
+
+/*
+ * Reference count of the records and typed structures allocated from
+ * an arena. The arena owns them, ref and unref leave them alone.
+ */
+#define MC_ARENA_REF_COUNT (-1)
+
+/* Returns zeroed memory, NULL only if a fixed arena is full */
+gpointer
+mc_arena_alloc0(
+    McArena* arena,
+    gsize size)
+    G_GNUC_INTERNAL;
+
+void
+mc_arena_mark(
+    const McArena* arena,
+    McArenaMark* mark)
+    G_GNUC_INTERNAL;
+
+/* Returns the number of bytes released */
+gsize
+mc_arena_rollback(
+    McArena* arena,
+    const McArenaMark* mark)
+    G_GNUC_INTERNAL;
+
+/* Records the amount of free space required by the failed call */
+void
+mc_arena_set_needed(
+    McArena* arena,
+    gsize needed)
+    G_GNUC_INTERNAL;
+
+#endif /* MC_ARENA_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_record_p.h"
+#include "mc_batch.h"
+#include "mc_mecard.h"
+#include "mc_record.h"
+
+/* Each thread claims about this many chunks of the batch */
+#define MC_BATCH_CHUNKS_PER_THREAD (8)
+#define MC_BATCH_MAX_CHUNK (64)
+
+typedef struct mc_batch_job McBatchJob;
+typedef gpointer (*McBatchParseFunc)(const McBatchJob* job, const McInput* in);
+
+/*
+ * The job is shared by the caller and the pool tasks, each of which
+ * holds a reference. The caller only waits until every chunk is done,
+ * not for the tasks. A task which gets to run after that finds nothing
+ * left to claim and just drops its reference, it never touches the
+ * inputs or the outputs which may be gone by then.
+ */
+struct mc_batch_job {
+    gint ref_count;
+    McBatchParseFunc parse;
+    const McParseOptions* opts;
+    const McInput* inputs;
+    gpointer* out;
+    gsize n;
+    gsize chunk;
+    gsize n_chunks;
+    gsize next;         /* Next input to claim, atomic */
+    gsize done;         /* Completed chunks, atomic */
+    gsize ok;           /* Successfully parsed inputs, atomic */
+    GMutex mutex;
+    GCond cond;
+};
+
+static
+void
+mc_batch_job_unref(
+    McBatchJob* job)
+{
+    if (g_atomic_int_dec_and_test(&job->ref_count)) {
+        g_cond_clear(&job->cond);
+        g_mutex_clear(&job->mutex);
+        g_free(job);
+    }
+}
+
+static
+void
+mc_batch_run(
+    McBatchJob* job)
+{
+    gsize start;
+
+    while ((start = g_atomic_pointer_add(&job->next, job->chunk)) < job->n) {
+        const gsize end = MIN(start + job->chunk, job->n);
+        gsize ok = 0;
+        gsize i;
+
+        for (i = start; i < end; i++) {
+            if ((job->out[i] = job->parse(job, job->inputs + i)) != NULL) {
+                ok++;
+            }
+        }
+        if (ok) {
+            g_atomic_pointer_add(&job->ok, ok);
+        }
+        if (g_atomic_pointer_add(&job->done, 1) + 1 == job->n_chunks) {
+            /* That was the last one */
+            g_mutex_lock(&job->mutex);
+            g_cond_signal(&job->cond);
+            g_mutex_unlock(&job->mutex);
+        }
+    }
+}
+
+static
+void
+mc_batch_worker(
+    gpointer data,
+    gpointer unused)
+{
+    McBatchJob* job = data;
+
+    mc_batch_run(job);
+    mc_batch_job_unref(job);
+}
+
+/* Process-wide and never freed, NULL on a single core machine */
+static
+GThreadPool*
+mc_batch_pool(
+    void)
+{
+    static gsize init = 0;
+    static GThreadPool* pool = NULL;
+
+    if (g_once_init_enter(&init)) {
+        const guint ncpu = g_get_num_processors();
+
+        if (ncpu > 1) {
+            pool = g_thread_pool_new(mc_batch_worker, NULL, ncpu - 1,
+                TRUE, NULL);
+        }
+        g_once_init_leave(&init, 1);
+    }
+    return pool;
+}
+
+static
+gsize
+mc_batch_parse(
+    McBatchParseFunc parse,
+    const McInput* inputs,
+    gsize n,
+    gpointer* out,
+    const McBatchOptions* opts)
+{
+    if (n && inputs && out) {
+        const guint ncpu = g_get_num_processors();
+        const guint max = (opts && opts->max_threads) ?
+            MIN(opts->max_threads, ncpu) : ncpu;
+        McBatchJob* job = g_new0(McBatchJob, 1);
+        gsize ok;
+
+        g_atomic_int_set(&job->ref_count, 1);
+        g_mutex_init(&job->mutex);
+        g_cond_init(&job->cond);
+        job->parse = parse;
+        job->opts = opts ? opts->parse : NULL;
+        job->inputs = inputs;
+        job->out = out;
+        job->n = n;
+        job->chunk = (opts && opts->chunk_size) ? opts->chunk_size :
+            MAX(MIN(n / (max * MC_BATCH_CHUNKS_PER_THREAD),
+            MC_BATCH_MAX_CHUNK), 1);
+        job->n_chunks = (n + job->chunk - 1) / job->chunk;
+
+        if (max > 1 && job->n_chunks > 1) {
+            GThreadPool* pool = mc_batch_pool();
+
+            if (pool) {
+                /* The caller takes one of the chunks itself */
+                const guint tasks = (guint) MIN(max - 1, job->n_chunks - 1);
+                guint i;
+
+                for (i = 0; i < tasks; i++) {
+                    g_atomic_int_inc(&job->ref_count);
+                    g_thread_pool_push(pool, job, NULL);
+                }
+            }
+        }
+
+        /* Wait for the chunks claimed by others, not for the tasks */
+        mc_batch_run(job);
+        g_mutex_lock(&job->mutex);
+        while (g_atomic_pointer_get(&job->done) < job->n_chunks) {
+            g_cond_wait(&job->cond, &job->mutex);
+        }
+        g_mutex_unlock(&job->mutex);
+        ok = g_atomic_pointer_get(&job->ok);
+        mc_batch_job_unref(job);
+        return ok;
+    }
+    return 0;
+}
+
+static
+gpointer
+mc_batch_parse_record(
+    const McBatchJob* job,
+    const McInput* in)
+{
+    return mc_record_new(NULL, in->data, in->size, job->opts, NULL);
+}
+
+static
+gpointer
+mc_batch_parse_mecard(
+    const McBatchJob* job,
+    const McInput* in)
+{
+    return mecard_parse_data(in->data, in->size);
+}
+
+size_t
+mc_record_parse_batch(
+    const McInput* inputs,
+    size_t n,
+    McRecord** out,
+    const McBatchOptions* opts)
+{
+    return mc_batch_parse(mc_batch_parse_record, inputs, n,
+        (gpointer*) out, opts);
+}
+
+size_t
+mecard_parse_batch(
+    const McInput* inputs,
+    size_t n,
+    MeCard** out,
+    const McBatchOptions* opts)
+{
+    /* Typed parsers don't take McParseOptions */
+    return (opts && opts->parse) ? 0 : mc_batch_parse(mc_batch_parse_mecard,
+        inputs, n, (gpointer*) out, opts);
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
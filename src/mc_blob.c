@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_types_p.h"
+#include "mc_view_p.h"
+#include "mc_blob.h"
+#include "mc_record.h"
+
+/*
+ * Blob layout, all numbers are little-endian 32-bit:
+ *
+ *   0  magic "MCB1"
+ *   4  size of the blob
+ *   8  number of properties
+ *  12  total number of values
+ *  16  identifier (offset, length)
+ *  24  properties (name offset, name length, number of values)
+ *   .. values (offset, length)
+ *   .. NUL-terminated strings
+ *
+ * Values of each property immediately follow the values of the previous
+ * one, so their position in the value table is implied.
+ */
+
+#define MC_BLOB_MAGIC "MCB1"
+#define MC_BLOB_HEADER_SIZE (24)
+#define MC_BLOB_PROP_SIZE (12)
+#define MC_BLOB_VALUE_SIZE (8)
+
+static inline
+guint32
+mc_blob_get(
+    const guint8* ptr)
+{
+    guint32 x;
+
+    /* Blobs don't have to be aligned */
+    memcpy(&x, ptr, sizeof(x));
+    return GUINT32_FROM_LE(x);
+}
+
+static inline
+guint8*
+mc_blob_put(
+    guint8* ptr,
+    guint32 x)
+{
+    x = GUINT32_TO_LE(x);
+    memcpy(ptr, &x, sizeof(x));
+    return ptr + sizeof(x);
+}
+
+/* Stores the string and its (offset, length) pair */
+static
+guint8*
+mc_blob_put_string(
+    guint8* blob,
+    guint8* ptr,
+    gsize* off,
+    const char* str)
+{
+    const gsize len = strlen(str);
+
+    memcpy(blob + *off, str, len + 1);
+    ptr = mc_blob_put(ptr, (guint32)*off);
+    ptr = mc_blob_put(ptr, (guint32)len);
+    *off += len + 1;
+    return ptr;
+}
+
+size_t
+mc_record_to_blob(
+    const McRecord* rec,
+    void* buf,
+    size_t size)
+{
+    if (rec) {
+        guint64 total = MC_BLOB_HEADER_SIZE + strlen(rec->ident) + 1;
+        guint64 n_values = 0;
+        guint i, k;
+
+        /* Measure */
+        for (i = 0; i < rec->n_prop; i++) {
+            const McProperty* prop = rec->prop + i;
+
+            total += MC_BLOB_PROP_SIZE + strlen(prop->name) + 1;
+            for (k = 0; prop->values && prop->values[k]; k++) {
+                total += MC_BLOB_VALUE_SIZE + strlen(prop->values[k]) + 1;
+            }
+            n_values += k;
+        }
+
+        if (total <= G_MAXUINT32) {
+            if (buf && total <= size) {
+                guint8* blob = buf;
+                guint8* ptr = blob;
+                guint8* vp = blob + MC_BLOB_HEADER_SIZE +
+                    rec->n_prop * MC_BLOB_PROP_SIZE;
+                gsize off = (vp - blob) + n_values * MC_BLOB_VALUE_SIZE;
+
+                memcpy(ptr, MC_BLOB_MAGIC, 4);
+                ptr = mc_blob_put(ptr + 4, (guint32)total);
+                ptr = mc_blob_put(ptr, rec->n_prop);
+                ptr = mc_blob_put(ptr, (guint32)n_values);
+                ptr = mc_blob_put_string(blob, ptr, &off, rec->ident);
+                for (i = 0; i < rec->n_prop; i++) {
+                    const McProperty* prop = rec->prop + i;
+
+                    ptr = mc_blob_put_string(blob, ptr, &off, prop->name);
+                    for (k = 0; prop->values && prop->values[k]; k++) {
+                        vp = mc_blob_put_string(blob, vp, &off,
+                            prop->values[k]);
+                    }
+                    ptr = mc_blob_put(ptr, k);
+                }
+            }
+            return (size_t)total;
+        }
+    }
+    return 0;
+}
+
+/* Checks the (offset, length) pair and fills in the slice */
+static
+gboolean
+mc_blob_get_string(
+    const guint8* blob,
+    guint32 size,
+    const guint8* ptr,
+    McStrSlice* str)
+{
+    const guint32 off = mc_blob_get(ptr);
+    const guint32 len = mc_blob_get(ptr + 4);
+
+    if ((guint64)off + len < size && !blob[off + len]) {
+        str->ptr = (const char*)blob + off;
+        str->len = len;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static
+McRecordView*
+mc_record_view_blob_new(
+    const void* data,
+    gsize size,
+    GBytes* bytes)
+{
+    const guint8* blob = data;
+
+    if (blob && size >= MC_BLOB_HEADER_SIZE &&
+        !memcmp(blob, MC_BLOB_MAGIC, 4) &&
+        mc_blob_get(blob + 4) <= size) {
+        const guint32 total = mc_blob_get(blob + 4);
+        const guint32 n_props = mc_blob_get(blob + 8);
+        const guint32 n_values = mc_blob_get(blob + 12);
+        const guint8* ptr = blob + MC_BLOB_HEADER_SIZE;
+
+        /* 64-bit arithmetic can't overflow here */
+        if (MC_BLOB_HEADER_SIZE + (guint64)n_props * MC_BLOB_PROP_SIZE +
+            (guint64)n_values * MC_BLOB_VALUE_SIZE <= total) {
+            const guint8* vp = ptr + n_props * MC_BLOB_PROP_SIZE;
+            McRecordView* view;
+            McPropertyView* prop;
+            McStrSlice* value;
+            guint32 left = n_values;
+            guint i, k;
+
+            view = mc_record_view_alloc(n_props, n_values, 0, bytes,
+                &value, NULL);
+            prop = (McPropertyView*)view->prop;
+            if (mc_blob_get_string(blob, total, blob + 16, &view->ident)) {
+                for (i = 0; i < n_props; i++, prop++) {
+                    const guint32 n = mc_blob_get(ptr + 8);
+
+                    if (n > left ||
+                        !mc_blob_get_string(blob, total, ptr, &prop->name)) {
+                        break;
+                    }
+                    if (n) {
+                        prop->values = value;
+                        prop->n_values = n;
+                        for (k = 0; k < n; k++) {
+                            if (!mc_blob_get_string(blob, total, vp,
+                                value++)) {
+                                break;
+                            }
+                            vp += MC_BLOB_VALUE_SIZE;
+                        }
+                        if (k < n) {
+                            break;
+                        }
+                    }
+                    ptr += MC_BLOB_PROP_SIZE;
+                    left -= n;
+                }
+                if (i == n_props && !left) {
+                    return view;
+                }
+            }
+            mc_record_view_free(view);
+        }
+    }
+    return NULL;
+}
+
+McRecordView*
+mc_record_view_blob(
+    const void* blob,
+    size_t size)
+{
+    return mc_record_view_blob_new(blob, size, NULL);
+}
+
+McRecordView*
+mc_record_view_blob_bytes(
+    GBytes* bytes)
+{
+    if (bytes) {
+        gsize size;
+        const void* data = g_bytes_get_data(bytes, &size);
+
+        return mc_record_view_blob_new(data, size, bytes);
+    }
+    return NULL;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
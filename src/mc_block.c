@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2020 by Slava Monich <slava@monich.com>
+ * Copyright (C) 2020-2026 by Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -36,6 +36,577 @@
 
 #include "mc_types_p.h"
 
+#if defined(__x86_64__) && defined(__GNUC__)
+#  define MC_BLOCK_X86 1
+#  include <immintrin.h>
+#endif
+
+/*
+ * Scanning kernels. Each one returns the first byte which doesn't belong
+ * to the class (or the last one which does, when scanning backwards).
+ * The vectorized ones must produce exactly the same results as the
+ * scalar ones.
+ *
+ * Plain text is printable ASCII except for the separators and the
+ * escape character, i.e. what can be copied to the value as is.
+ *
+ * widen_latin1 isn't a scanning kernel, it converts the bytes between
+ * ptr and end (which must all be %x80-FF) from Latin-1 into two-byte
+ * UTF-8 sequences.
+ */
+typedef struct mc_block_kernels {
+    const guint8* (*skip_text)(const guint8* ptr, const guint8* end);
+    const guint8* (*skip_spaces)(const guint8* ptr, const guint8* end);
+    const guint8* (*strip_spaces)(const guint8* ptr, const guint8* end);
+    const guint8* (*skip_id)(const guint8* ptr, const guint8* end);
+    const guint8* (*skip_ascii)(const guint8* ptr, const guint8* end);
+    const guint8* (*skip_8bit)(const guint8* ptr, const guint8* end);
+    void (*widen_latin1)(const guint8* ptr, const guint8* end, guint8* out);
+} McBlockKernels;
+
+static const McBlockKernels* mc_block_active = NULL;
+
+/*
+ * Identifier = 1*(ALPHA / DIGIT / "-")
+ * Property-Name = 1*(ALPHA / DIGIT / "-")
+ */
+static inline
+gboolean
+mc_block_id_char(
+    guchar c)
+{
+    return (g_ascii_table[c] & G_ASCII_ALNUM) || c == (guchar)'-';
+}
+
+static inline
+gboolean
+mc_block_text_char(
+    guchar c)
+{
+    return c >= 0x20 && c < 0x7f &&
+        c != ',' && c != ';' && c != ':' && c != '\\';
+}
+
+/* Scalar kernels */
+
+static
+const guint8*
+mc_block_skip_text_scalar(
+    const guint8* ptr,
+    const guint8* end)
+{
+    while (ptr < end && mc_block_text_char(*ptr)) ptr++;
+    return ptr;
+}
+
+static
+const guint8*
+mc_block_skip_spaces_scalar(
+    const guint8* ptr,
+    const guint8* end)
+{
+    while (ptr < end && g_ascii_isspace(*ptr)) ptr++;
+    return ptr;
+}
+
+static
+const guint8*
+mc_block_strip_spaces_scalar(
+    const guint8* ptr,
+    const guint8* end)
+{
+    while (end > ptr && g_ascii_isspace(end[-1])) end--;
+    return end;
+}
+
+static
+const guint8*
+mc_block_skip_id_scalar(
+    const guint8* ptr,
+    const guint8* end)
+{
+    while (ptr < end && mc_block_id_char(*ptr)) ptr++;
+    return ptr;
+}
+
+static
+const guint8*
+mc_block_skip_ascii_scalar(
+    const guint8* ptr,
+    const guint8* end)
+{
+    while (ptr < end && *ptr < 0x80) ptr++;
+    return ptr;
+}
+
+static
+const guint8*
+mc_block_skip_8bit_scalar(
+    const guint8* ptr,
+    const guint8* end)
+{
+    while (ptr < end && *ptr >= 0x80) ptr++;
+    return ptr;
+}
+
+static
+void
+mc_block_widen_latin1_scalar(
+    const guint8* ptr,
+    const guint8* end,
+    guint8* out)
+{
+    while (ptr < end) {
+        const guint8 c = *ptr++;
+
+        *out++ = 0xc0 | (c >> 6);
+        *out++ = 0x80 | (c & 0x3f);
+    }
+}
+
+static const McBlockKernels mc_block_kernels_scalar = {
+    mc_block_skip_text_scalar,
+    mc_block_skip_spaces_scalar,
+    mc_block_strip_spaces_scalar,
+    mc_block_skip_id_scalar,
+    mc_block_skip_ascii_scalar,
+    mc_block_skip_8bit_scalar,
+    mc_block_widen_latin1_scalar
+};
+
+#ifdef MC_BLOCK_X86
+
+/*
+ * SSE2 kernels. Note that comparisons are signed, which puts bytes
+ * above 0x7f below everything else.
+ */
+
+static inline
+__m128i
+mc_block_sse2_range(
+    __m128i x,
+    char lo,
+    char hi)
+{
+    return _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8(lo - 1)),
+        _mm_cmplt_epi8(x, _mm_set1_epi8(hi + 1)));
+}
+
+static inline
+__m128i
+mc_block_sse2_text(
+    __m128i x)
+{
+    const __m128i bad = _mm_or_si128(
+        _mm_or_si128(_mm_cmplt_epi8(x, _mm_set1_epi8(0x20)),
+            _mm_cmpeq_epi8(x, _mm_set1_epi8(0x7f))),
+        _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(',')),
+                _mm_cmpeq_epi8(x, _mm_set1_epi8(';'))),
+            _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(':')),
+                _mm_cmpeq_epi8(x, _mm_set1_epi8('\\')))));
+
+    return _mm_andnot_si128(bad, _mm_set1_epi8(-1));
+}
+
+static inline
+__m128i
+mc_block_sse2_space(
+    __m128i x)
+{
+    /* HT, LF, FF, CR and space (but not VT) */
+    return _mm_andnot_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(0x0b)),
+        _mm_or_si128(mc_block_sse2_range(x, 0x09, 0x0d),
+            _mm_cmpeq_epi8(x, _mm_set1_epi8(0x20))));
+}
+
+static inline
+__m128i
+mc_block_sse2_id(
+    __m128i x)
+{
+    return _mm_or_si128(
+        _mm_or_si128(mc_block_sse2_range(x, '0', '9'),
+            mc_block_sse2_range(_mm_or_si128(x, _mm_set1_epi8(0x20)),
+                'a', 'z')),
+        _mm_cmpeq_epi8(x, _mm_set1_epi8('-')));
+}
+
+static inline
+__m128i
+mc_block_sse2_ascii(
+    __m128i x)
+{
+    return _mm_cmpgt_epi8(x, _mm_set1_epi8(-1));
+}
+
+static inline
+__m128i
+mc_block_sse2_8bit(
+    __m128i x)
+{
+    return _mm_cmplt_epi8(x, _mm_setzero_si128());
+}
+
+static inline __attribute__((always_inline))
+const guint8*
+mc_block_sse2_skip(
+    const guint8* ptr,
+    const guint8* end,
+    __m128i (*match)(__m128i),
+    const guint8* (*tail)(const guint8*, const guint8*))
+{
+    while ((end - ptr) >= 16) {
+        const __m128i x = _mm_loadu_si128((const __m128i*)ptr);
+        const guint mask = ~_mm_movemask_epi8(match(x)) & 0xffff;
+
+        if (mask) {
+            return ptr + __builtin_ctz(mask);
+        }
+        ptr += 16;
+    }
+    return tail(ptr, end);
+}
+
+static
+const guint8*
+mc_block_skip_text_sse2(
+    const guint8* ptr,
+    const guint8* end)
+{
+    return mc_block_sse2_skip(ptr, end, mc_block_sse2_text,
+        mc_block_skip_text_scalar);
+}
+
+static
+const guint8*
+mc_block_skip_spaces_sse2(
+    const guint8* ptr,
+    const guint8* end)
+{
+    return mc_block_sse2_skip(ptr, end, mc_block_sse2_space,
+        mc_block_skip_spaces_scalar);
+}
+
+static
+const guint8*
+mc_block_skip_id_sse2(
+    const guint8* ptr,
+    const guint8* end)
+{
+    return mc_block_sse2_skip(ptr, end, mc_block_sse2_id,
+        mc_block_skip_id_scalar);
+}
+
+static
+const guint8*
+mc_block_strip_spaces_sse2(
+    const guint8* ptr,
+    const guint8* end)
+{
+    while ((end - ptr) >= 16) {
+        const __m128i x = _mm_loadu_si128((const __m128i*)(end - 16));
+        const guint mask = ~_mm_movemask_epi8(mc_block_sse2_space(x)) &
+            0xffff;
+
+        if (mask) {
+            return end - 16 + (32 - __builtin_clz(mask));
+        }
+        end -= 16;
+    }
+    return mc_block_strip_spaces_scalar(ptr, end);
+}
+
+static
+const guint8*
+mc_block_skip_ascii_sse2(
+    const guint8* ptr,
+    const guint8* end)
+{
+    return mc_block_sse2_skip(ptr, end, mc_block_sse2_ascii,
+        mc_block_skip_ascii_scalar);
+}
+
+static
+const guint8*
+mc_block_skip_8bit_sse2(
+    const guint8* ptr,
+    const guint8* end)
+{
+    return mc_block_sse2_skip(ptr, end, mc_block_sse2_8bit,
+        mc_block_skip_8bit_scalar);
+}
+
+/*
+ * The lead byte is %xC3 for %xC0-FF and %xC2 for the rest, the trail
+ * byte is the input with bit 6 cleared. Interleaving the two doubles
+ * the width.
+ */
+static
+void
+mc_block_widen_latin1_sse2(
+    const guint8* ptr,
+    const guint8* end,
+    guint8* out)
+{
+    while ((end - ptr) >= 16) {
+        const __m128i x = _mm_loadu_si128((const __m128i*)ptr);
+        /* Signed comparison works since all bytes are negative */
+        const __m128i lead = _mm_add_epi8(_mm_set1_epi8((char)0xc3),
+            _mm_cmplt_epi8(x, _mm_set1_epi8((char)0xc0)));
+        const __m128i trail = _mm_and_si128(x, _mm_set1_epi8((char)0xbf));
+
+        _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi8(lead, trail));
+        _mm_storeu_si128((__m128i*)(out + 16),
+            _mm_unpackhi_epi8(lead, trail));
+        ptr += 16;
+        out += 32;
+    }
+    mc_block_widen_latin1_scalar(ptr, end, out);
+}
+
+static const McBlockKernels mc_block_kernels_sse2 = {
+    mc_block_skip_text_sse2,
+    mc_block_skip_spaces_sse2,
+    mc_block_strip_spaces_sse2,
+    mc_block_skip_id_sse2,
+    mc_block_skip_ascii_sse2,
+    mc_block_skip_8bit_sse2,
+    mc_block_widen_latin1_sse2
+};
+
+/* AVX2 kernels */
+
+#define MC_BLOCK_AVX2 __attribute__((target("avx2")))
+
+static inline MC_BLOCK_AVX2
+__m256i
+mc_block_avx2_range(
+    __m256i x,
+    char lo,
+    char hi)
+{
+    return _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8(lo - 1)),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), x));
+}
+
+static inline MC_BLOCK_AVX2
+__m256i
+mc_block_avx2_text(
+    __m256i x)
+{
+    const __m256i bad = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), x),
+            _mm256_cmpeq_epi8(x, _mm256_set1_epi8(0x7f))),
+        _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(',')),
+                _mm256_cmpeq_epi8(x, _mm256_set1_epi8(';'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(':')),
+                _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\')))));
+
+    return _mm256_andnot_si256(bad, _mm256_set1_epi8(-1));
+}
+
+static inline MC_BLOCK_AVX2
+__m256i
+mc_block_avx2_space(
+    __m256i x)
+{
+    return _mm256_andnot_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(0x0b)),
+        _mm256_or_si256(mc_block_avx2_range(x, 0x09, 0x0d),
+            _mm256_cmpeq_epi8(x, _mm256_set1_epi8(0x20))));
+}
+
+static inline MC_BLOCK_AVX2
+__m256i
+mc_block_avx2_id(
+    __m256i x)
+{
+    return _mm256_or_si256(
+        _mm256_or_si256(mc_block_avx2_range(x, '0', '9'),
+            mc_block_avx2_range(_mm256_or_si256(x, _mm256_set1_epi8(0x20)),
+                'a', 'z')),
+        _mm256_cmpeq_epi8(x, _mm256_set1_epi8('-')));
+}
+
+static inline MC_BLOCK_AVX2
+__m256i
+mc_block_avx2_ascii(
+    __m256i x)
+{
+    return _mm256_cmpgt_epi8(x, _mm256_set1_epi8(-1));
+}
+
+static inline MC_BLOCK_AVX2
+__m256i
+mc_block_avx2_8bit(
+    __m256i x)
+{
+    return _mm256_cmpgt_epi8(_mm256_setzero_si256(), x);
+}
+
+static inline MC_BLOCK_AVX2 __attribute__((always_inline))
+const guint8*
+mc_block_avx2_skip(
+    const guint8* ptr,
+    const guint8* end,
+    __m256i (*match)(__m256i),
+    const guint8* (*tail)(const guint8*, const guint8*))
+{
+    while ((end - ptr) >= 32) {
+        const __m256i x = _mm256_loadu_si256((const __m256i*)ptr);
+        const guint mask = ~(guint)_mm256_movemask_epi8(match(x));
+
+        if (mask) {
+            return ptr + __builtin_ctz(mask);
+        }
+        ptr += 32;
+    }
+    return tail(ptr, end);
+}
+
+static MC_BLOCK_AVX2
+const guint8*
+mc_block_skip_text_avx2(
+    const guint8* ptr,
+    const guint8* end)
+{
+    return mc_block_avx2_skip(ptr, end, mc_block_avx2_text,
+        mc_block_skip_text_sse2);
+}
+
+static MC_BLOCK_AVX2
+const guint8*
+mc_block_skip_spaces_avx2(
+    const guint8* ptr,
+    const guint8* end)
+{
+    return mc_block_avx2_skip(ptr, end, mc_block_avx2_space,
+        mc_block_skip_spaces_sse2);
+}
+
+static MC_BLOCK_AVX2
+const guint8*
+mc_block_skip_id_avx2(
+    const guint8* ptr,
+    const guint8* end)
+{
+    return mc_block_avx2_skip(ptr, end, mc_block_avx2_id,
+        mc_block_skip_id_sse2);
+}
+
+static MC_BLOCK_AVX2
+const guint8*
+mc_block_strip_spaces_avx2(
+    const guint8* ptr,
+    const guint8* end)
+{
+    while ((end - ptr) >= 32) {
+        const __m256i x = _mm256_loadu_si256((const __m256i*)(end - 32));
+        const guint mask = ~(guint)_mm256_movemask_epi8(
+            mc_block_avx2_space(x));
+
+        if (mask) {
+            return end - 32 + (32 - __builtin_clz(mask));
+        }
+        end -= 32;
+    }
+    return mc_block_strip_spaces_sse2(ptr, end);
+}
+
+static MC_BLOCK_AVX2
+const guint8*
+mc_block_skip_ascii_avx2(
+    const guint8* ptr,
+    const guint8* end)
+{
+    return mc_block_avx2_skip(ptr, end, mc_block_avx2_ascii,
+        mc_block_skip_ascii_sse2);
+}
+
+static MC_BLOCK_AVX2
+const guint8*
+mc_block_skip_8bit_avx2(
+    const guint8* ptr,
+    const guint8* end)
+{
+    return mc_block_avx2_skip(ptr, end, mc_block_avx2_8bit,
+        mc_block_skip_8bit_sse2);
+}
+
+/*
+ * AVX2 unpacking works within 128-bit lanes, which makes it no better
+ * than SSE2 for widening.
+ */
+static const McBlockKernels mc_block_kernels_avx2 = {
+    mc_block_skip_text_avx2,
+    mc_block_skip_spaces_avx2,
+    mc_block_strip_spaces_avx2,
+    mc_block_skip_id_avx2,
+    mc_block_skip_ascii_avx2,
+    mc_block_skip_8bit_avx2,
+    mc_block_widen_latin1_sse2
+};
+
+#endif /* MC_BLOCK_X86 */
+
+static
+const McBlockKernels*
+mc_block_kernels(
+    MC_BLOCK_IMPL impl)
+{
+    switch (impl) {
+    case MC_BLOCK_IMPL_SCALAR:
+        return &mc_block_kernels_scalar;
+#ifdef MC_BLOCK_X86
+    case MC_BLOCK_IMPL_SSE2:
+        /* SSE2 is part of x86_64 */
+        return &mc_block_kernels_sse2;
+    case MC_BLOCK_IMPL_AVX2:
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return &mc_block_kernels_avx2;
+        }
+        break;
+#endif
+    default:
+        break;
+    }
+    return NULL;
+}
+
+gboolean
+mc_block_select(
+    MC_BLOCK_IMPL impl)
+{
+    const McBlockKernels* kernels = mc_block_kernels(impl);
+
+    if (kernels) {
+        g_atomic_pointer_set(&mc_block_active, kernels);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static inline
+const McBlockKernels*
+mc_block_ops(
+    void)
+{
+    const McBlockKernels* kernels = g_atomic_pointer_get(&mc_block_active);
+
+    if (G_UNLIKELY(!kernels)) {
+        /* Pick the best one (racing threads would pick the same) */
+        MC_BLOCK_IMPL impl = MC_BLOCK_IMPL_COUNT;
+
+        while (!kernels && impl > MC_BLOCK_IMPL_SCALAR) {
+            kernels = mc_block_kernels(--impl);
+        }
+        g_atomic_pointer_set(&mc_block_active, kernels);
+    }
+    return kernels;
+}
+
 gboolean
 mc_block_equals(
     const McBlock* blk,
@@ -55,7 +626,9 @@ gboolean
 mc_block_skip_spaces(
     McBlock* blk)
 {
-    while (!mc_block_end(blk) && g_ascii_isspace(*blk->ptr)) blk->ptr++;
+    if (!mc_block_end(blk)) {
+        blk->ptr = mc_block_ops()->skip_spaces(blk->ptr, blk->end);
+    }
     return !mc_block_end(blk);
 }
 
@@ -63,7 +636,9 @@ gboolean
 mc_block_strip_spaces(
     McBlock* blk)
 {
-    while (!mc_block_end(blk) && g_ascii_isspace(blk->end[-1])) blk->end--;
+    if (!mc_block_end(blk)) {
+        blk->end = mc_block_ops()->strip_spaces(blk->ptr, blk->end);
+    }
     return !mc_block_end(blk);
 }
 
@@ -72,24 +647,143 @@ mc_block_skip_until(
     McBlock* blk,
     guint8 sep)
 {
-    while (!mc_block_end(blk) && *blk->ptr != sep) blk->ptr++;
+    if (!mc_block_end(blk)) {
+        /* memchr is vectorized by libc */
+        const guint8* found = memchr(blk->ptr, sep, blk->end - blk->ptr);
+
+        blk->ptr = found ? found : blk->end;
+    }
     return !mc_block_end(blk);
 }
 
-gboolean
-mc_block_check(
-    const McBlock* blk,
-    gboolean (*check)(guchar))
+gsize
+mc_block_skip_id(
+    McBlock* blk)
+{
+    const guint8* start = blk->ptr;
+
+    if (!mc_block_end(blk)) {
+        blk->ptr = mc_block_ops()->skip_id(blk->ptr, blk->end);
+    }
+    return blk->ptr - start;
+}
+
+gsize
+mc_block_skip_text(
+    McBlock* blk)
+{
+    const guint8* start = blk->ptr;
+
+    if (!mc_block_end(blk)) {
+        blk->ptr = mc_block_ops()->skip_text(blk->ptr, blk->end);
+    }
+    return blk->ptr - start;
+}
+
+gsize
+mc_block_skip_ascii(
+    McBlock* blk)
+{
+    const guint8* start = blk->ptr;
+
+    if (!mc_block_end(blk)) {
+        blk->ptr = mc_block_ops()->skip_ascii(blk->ptr, blk->end);
+    }
+    return blk->ptr - start;
+}
+
+gsize
+mc_block_widen_latin1(
+    McBlock* blk,
+    guint8* out)
 {
-    const guint8* ptr;
+    const guint8* start = blk->ptr;
 
+    if (!mc_block_end(blk)) {
+        const McBlockKernels* ops = mc_block_ops();
+
+        blk->ptr = ops->skip_8bit(start, blk->end);
+        if (out) {
+            ops->widen_latin1(start, blk->ptr, out);
+        }
+    }
+    return 2 * (blk->ptr - start);
+}
+
+gboolean
+mc_block_check_id(
+    const McBlock* blk)
+{
     /* Caller makes sure that block is not empty */
-    for (ptr = blk->ptr; ptr < blk->end; ptr++) {
-        if (!check(*ptr)) {
+    return mc_block_ops()->skip_id(blk->ptr, blk->end) == blk->end;
+}
+
+/*
+ * Strict UTF-8 validation, DFA by Bjoern Hoehrmann:
+ *
+ * Copyright (c) 2008-2010 Bjoern Hoehrmann <bjoern@hoehrmann.de>
+ * See http://bjoern.hoehrmann.de/utf-8/decoder/dfa/ for details.
+ *
+ * Rejects overlong forms, surrogates, code points beyond U+10FFFF
+ * and the obsolete 5- and 6-byte sequences.
+ */
+
+#define MC_UTF8_ACCEPT (0)
+#define MC_UTF8_REJECT (12)
+
+static const guint8 mc_block_utf8_class[256] = {
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, 9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,
+    7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7, 7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,
+    8,8,2,2,2,2,2,2,2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,
+    10,3,3,3,3,3,3,3,3,3,3,3,3,4,3,3, 11,6,6,6,5,8,8,8,8,8,8,8,8,8,8,8
+};
+
+static const guint8 mc_block_utf8_state[] = {
+    0,12,24,36,60,96,84,12,12,12,48,72, 12,12,12,12,12,12,12,12,12,12,12,12,
+    12,0,12,12,12,12,12,0,12,0,12,12, 12,24,12,12,12,12,12,24,12,24,12,12,
+    12,12,12,12,12,12,12,24,12,12,12,12, 12,24,12,12,12,12,12,12,12,24,12,12,
+    12,12,12,12,12,12,12,36,12,36,12,12, 12,36,12,12,12,12,12,36,12,36,12,12,
+    12,36,12,12,12,12,12,12,12,12,12,12
+};
+
+gsize
+mc_block_skip_utf8(
+    McBlock* blk)
+{
+    const guint8* start = blk->ptr;
+    const guint8* ptr = start;
+    guint state = MC_UTF8_ACCEPT;
+
+    /* ASCII either ends the run or makes the last sequence invalid */
+    while (ptr < blk->end && *ptr >= 0x80) {
+        state = mc_block_utf8_state[state + mc_block_utf8_class[*ptr++]];
+        if (state == MC_UTF8_ACCEPT) {
+            blk->ptr = ptr;
+        } else if (state == MC_UTF8_REJECT) {
+            break;
+        }
+    }
+    return blk->ptr - start;
+}
+
+gboolean
+mc_block_utf8_incomplete(
+    const McBlock* blk)
+{
+    const guint8* ptr = blk->ptr;
+    guint state = MC_UTF8_ACCEPT;
+
+    while (ptr < blk->end) {
+        state = mc_block_utf8_state[state + mc_block_utf8_class[*ptr++]];
+        if (state == MC_UTF8_ACCEPT || state == MC_UTF8_REJECT) {
             return FALSE;
         }
     }
-    return TRUE;
+    return state != MC_UTF8_ACCEPT;
 }
 
 /*
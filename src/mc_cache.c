@@ -0,0 +1,471 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_record_p.h"
+#include "mc_schema_p.h"
+#include "mc_cache.h"
+#include "mc_mecard.h"
+#include "mc_record.h"
+
+#define MC_PARSE_CACHE_SHARDS (16)
+#define MC_PARSE_CACHE_DEFAULT_SIZE (1024 * 1024)
+#define MC_PARSE_CACHE_MIN_BUCKETS (16)
+
+typedef enum mc_parse_cache_kind {
+    MC_PARSE_CACHE_RECORD,
+    MC_PARSE_CACHE_MECARD
+} MC_PARSE_CACHE_KIND;
+
+typedef struct mc_parse_cache_ops {
+    gpointer (*parse)(const void* data, size_t size);
+    gpointer (*ref)(gpointer obj);
+    void (*unref)(gpointer obj);
+    gsize (*size)(gconstpointer obj);
+} McParseCacheOps;
+
+static
+gpointer
+mc_parse_cache_record_parse(
+    const void* data,
+    size_t size)
+{
+    return mc_record_parse_data(data, size);
+}
+
+static
+gpointer
+mc_parse_cache_record_ref(
+    gpointer obj)
+{
+    return mc_record_ref(obj);
+}
+
+static
+void
+mc_parse_cache_record_unref(
+    gpointer obj)
+{
+    mc_record_unref(obj);
+}
+
+static
+gsize
+mc_parse_cache_record_size(
+    gconstpointer obj)
+{
+    return mc_record_size(obj);
+}
+
+static
+gpointer
+mc_parse_cache_mecard_parse(
+    const void* data,
+    size_t size)
+{
+    return mecard_parse_data(data, size);
+}
+
+static const McParseCacheOps mc_parse_cache_ops[] = {
+    {   /* MC_PARSE_CACHE_RECORD */
+        mc_parse_cache_record_parse,
+        mc_parse_cache_record_ref,
+        mc_parse_cache_record_unref,
+        mc_parse_cache_record_size
+    },{ /* MC_PARSE_CACHE_MECARD */
+        mc_parse_cache_mecard_parse,
+        mc_schema_ref,
+        mc_schema_unref,
+        mc_schema_size
+    }
+};
+
+/* The payload immediately follows the entry */
+typedef struct mc_parse_cache_entry McParseCacheEntry;
+struct mc_parse_cache_entry {
+    McParseCacheEntry* next;    /* Hash chain */
+    McParseCacheEntry* newer;   /* LRU list */
+    McParseCacheEntry* older;
+    guint64 hash;
+    MC_PARSE_CACHE_KIND kind;
+    gpointer obj;               /* NULL if the payload didn't parse */
+    gsize cost;
+    gsize size;
+};
+
+typedef struct mc_parse_cache_shard {
+    GMutex mutex;
+    McParseCacheEntry** buckets;
+    guint32 mask;
+    guint count;
+    McParseCacheEntry* newest;
+    McParseCacheEntry* oldest;
+    gsize bytes;
+} McParseCacheShard;
+
+struct mc_parse_cache {
+    gsize shard_bytes;
+    MC_PARSE_CACHE_FLAGS flags;
+    McParseCacheShard shard[MC_PARSE_CACHE_SHARDS];
+};
+
+/* Word at a time multiply-xorshift hash, not meant to be cryptographic */
+static
+guint64
+mc_parse_cache_hash(
+    const guint8* data,
+    gsize size)
+{
+    const guint64 k = G_GUINT64_CONSTANT(0x9e3779b97f4a7c15);
+    guint64 h = size * k;
+    guint64 x;
+
+    for (; size >= 8; size -= 8, data += 8) {
+        memcpy(&x, data, 8);
+        x *= k;
+        h = (h ^ (x ^ (x >> 31))) * k;
+    }
+    if (size) {
+        x = 0;
+        memcpy(&x, data, size);
+        x *= k;
+        h = (h ^ (x ^ (x >> 31))) * k;
+    }
+
+    /* Final avalanche (from MurmurHash3) */
+    h ^= h >> 33;
+    h *= G_GUINT64_CONSTANT(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= G_GUINT64_CONSTANT(0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+    return h;
+}
+
+static
+McParseCacheEntry*
+mc_parse_cache_lookup(
+    McParseCacheShard* shard,
+    MC_PARSE_CACHE_KIND kind,
+    guint64 hash,
+    const void* data,
+    gsize size)
+{
+    McParseCacheEntry* entry = shard->buckets[hash & shard->mask];
+
+    while (entry && !(entry->hash == hash && entry->kind == kind &&
+        entry->size == size && !memcmp(entry + 1, data, size))) {
+        entry = entry->next;
+    }
+    return entry;
+}
+
+static
+void
+mc_parse_cache_lru_unlink(
+    McParseCacheShard* shard,
+    McParseCacheEntry* entry)
+{
+    if (entry->newer) {
+        entry->newer->older = entry->older;
+    } else {
+        shard->newest = entry->older;
+    }
+    if (entry->older) {
+        entry->older->newer = entry->newer;
+    } else {
+        shard->oldest = entry->newer;
+    }
+}
+
+static
+void
+mc_parse_cache_lru_push(
+    McParseCacheShard* shard,
+    McParseCacheEntry* entry)
+{
+    entry->newer = NULL;
+    entry->older = shard->newest;
+    if (shard->newest) {
+        shard->newest->newer = entry;
+    } else {
+        shard->oldest = entry;
+    }
+    shard->newest = entry;
+}
+
+static
+gpointer
+mc_parse_cache_hit(
+    McParseCacheShard* shard,
+    McParseCacheEntry* entry)
+{
+    if (shard->newest != entry) {
+        mc_parse_cache_lru_unlink(shard, entry);
+        mc_parse_cache_lru_push(shard, entry);
+    }
+    return mc_parse_cache_ops[entry->kind].ref(entry->obj);
+}
+
+static
+void
+mc_parse_cache_grow(
+    McParseCacheShard* shard)
+{
+    const guint32 n = 2 * (shard->mask + 1);
+    McParseCacheEntry** buckets = g_new0(McParseCacheEntry*, n);
+    guint32 i;
+
+    for (i = 0; i <= shard->mask; i++) {
+        McParseCacheEntry* entry = shard->buckets[i];
+
+        while (entry) {
+            McParseCacheEntry* next = entry->next;
+            McParseCacheEntry** bucket = buckets + (entry->hash & (n - 1));
+
+            entry->next = *bucket;
+            *bucket = entry;
+            entry = next;
+        }
+    }
+    g_free(shard->buckets);
+    shard->buckets = buckets;
+    shard->mask = n - 1;
+}
+
+static
+void
+mc_parse_cache_remove(
+    McParseCacheShard* shard,
+    McParseCacheEntry* entry)
+{
+    McParseCacheEntry** link = shard->buckets + (entry->hash & shard->mask);
+
+    while (*link != entry) {
+        link = &(*link)->next;
+    }
+    *link = entry->next;
+    mc_parse_cache_lru_unlink(shard, entry);
+    shard->bytes -= entry->cost;
+    shard->count--;
+    mc_parse_cache_ops[entry->kind].unref(entry->obj);
+    g_free(entry);
+}
+
+static
+gpointer
+mc_parse_cache_get(
+    McParseCache* cache,
+    MC_PARSE_CACHE_KIND kind,
+    const void* data,
+    gsize size)
+{
+    if (cache && data) {
+        const McParseCacheOps* ops = mc_parse_cache_ops + kind;
+        const guint64 hash = mc_parse_cache_hash(data, size);
+        McParseCacheShard* shard = cache->shard +
+            (hash >> 60) % MC_PARSE_CACHE_SHARDS;
+        McParseCacheEntry* entry;
+        gpointer obj;
+        gsize cost;
+
+        g_mutex_lock(&shard->mutex);
+        entry = mc_parse_cache_lookup(shard, kind, hash, data, size);
+        if (entry) {
+            obj = mc_parse_cache_hit(shard, entry);
+            g_mutex_unlock(&shard->mutex);
+            return obj;
+        }
+        g_mutex_unlock(&shard->mutex);
+
+        /* Parse without holding the lock */
+        obj = ops->parse(data, size);
+        if (!obj && (cache->flags & MC_PARSE_CACHE_NO_FAILURES)) {
+            return NULL;
+        }
+        cost = sizeof(McParseCacheEntry) + size + ops->size(obj);
+        if (cost <= cache->shard_bytes) {
+            gpointer result;
+
+            g_mutex_lock(&shard->mutex);
+            entry = mc_parse_cache_lookup(shard, kind, hash, data, size);
+            if (entry) {
+                /* Another thread has been faster */
+                result = mc_parse_cache_hit(shard, entry);
+                g_mutex_unlock(&shard->mutex);
+                ops->unref(obj);
+                return result;
+            }
+
+            /* The cache takes the reference returned by the parser */
+            entry = g_malloc(sizeof(McParseCacheEntry) + size);
+            entry->hash = hash;
+            entry->kind = kind;
+            entry->obj = obj;
+            entry->cost = cost;
+            entry->size = size;
+            memcpy(entry + 1, data, size);
+            if (shard->count > shard->mask) {
+                mc_parse_cache_grow(shard);
+            }
+            entry->next = shard->buckets[hash & shard->mask];
+            shard->buckets[hash & shard->mask] = entry;
+            mc_parse_cache_lru_push(shard, entry);
+            shard->bytes += cost;
+            shard->count++;
+
+            /* The new entry alone always fits */
+            while (shard->bytes > cache->shard_bytes) {
+                mc_parse_cache_remove(shard, shard->oldest);
+            }
+            result = ops->ref(obj);
+            g_mutex_unlock(&shard->mutex);
+            return result;
+        }
+        return obj;
+    }
+    return NULL;
+}
+
+McParseCache*
+mc_parse_cache_new(
+    size_t max_bytes)
+{
+    return mc_parse_cache_new_full(max_bytes, MC_PARSE_CACHE_FLAGS_NONE);
+}
+
+McParseCache*
+mc_parse_cache_new_full(
+    size_t max_bytes,
+    MC_PARSE_CACHE_FLAGS flags)
+{
+    McParseCache* cache = g_new0(McParseCache, 1);
+    guint i;
+
+    cache->flags = flags;
+    cache->shard_bytes = (max_bytes ? max_bytes :
+        MC_PARSE_CACHE_DEFAULT_SIZE) / MC_PARSE_CACHE_SHARDS;
+    for (i = 0; i < MC_PARSE_CACHE_SHARDS; i++) {
+        McParseCacheShard* shard = cache->shard + i;
+
+        g_mutex_init(&shard->mutex);
+        shard->buckets = g_new0(McParseCacheEntry*,
+            MC_PARSE_CACHE_MIN_BUCKETS);
+        shard->mask = MC_PARSE_CACHE_MIN_BUCKETS - 1;
+    }
+    return cache;
+}
+
+void
+mc_parse_cache_clear(
+    McParseCache* cache)
+{
+    if (cache) {
+        guint i;
+
+        for (i = 0; i < MC_PARSE_CACHE_SHARDS; i++) {
+            McParseCacheShard* shard = cache->shard + i;
+
+            g_mutex_lock(&shard->mutex);
+            while (shard->oldest) {
+                mc_parse_cache_remove(shard, shard->oldest);
+            }
+            g_mutex_unlock(&shard->mutex);
+        }
+    }
+}
+
+void
+mc_parse_cache_free(
+    McParseCache* cache)
+{
+    if (cache) {
+        guint i;
+
+        mc_parse_cache_clear(cache);
+        for (i = 0; i < MC_PARSE_CACHE_SHARDS; i++) {
+            McParseCacheShard* shard = cache->shard + i;
+
+            g_mutex_clear(&shard->mutex);
+            g_free(shard->buckets);
+        }
+        g_free(cache);
+    }
+}
+
+McRecord*
+mc_parse_cache_record(
+    McParseCache* cache,
+    const void* data,
+    size_t size)
+{
+    return mc_parse_cache_get(cache, MC_PARSE_CACHE_RECORD, data, size);
+}
+
+MeCard*
+mc_parse_cache_mecard(
+    McParseCache* cache,
+    const void* data,
+    size_t size)
+{
+    return mc_parse_cache_get(cache, MC_PARSE_CACHE_MECARD, data, size);
+}
+
+size_t
+mc_parse_cache_size(
+    McParseCache* cache)
+{
+    gsize total = 0;
+
+    if (cache) {
+        guint i;
+
+        for (i = 0; i < MC_PARSE_CACHE_SHARDS; i++) {
+            McParseCacheShard* shard = cache->shard + i;
+
+            g_mutex_lock(&shard->mutex);
+            total += shard->bytes;
+            g_mutex_unlock(&shard->mutex);
+        }
+    }
+    return total;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
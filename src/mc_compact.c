@@ -0,0 +1,649 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_parser_p.h"
+#include "mc_probe_p.h"
+#include "mc_record_p.h"
+#include "mc_stats_p.h"
+#include "mc_compact.h"
+
+/*
+ * The memory block looks like this:
+ *
+ *   McCompactRecord   header
+ *   McCompactProp     prop[n_prop]
+ *   guint32           buckets[mask + 1]
+ *   guint32           off[n_str + 1]
+ *   char              strings[off[n_str]]
+ *
+ * String k occupies [off[k], off[k+1]) of the string area, including
+ * the NUL terminator. Names and the identifier are either string
+ * indices or MC_COMPACT_INTERNED combined with an index in
+ * mc_compact_names.
+ *
+ * The buckets and the next links of the properties form a hash table
+ * of property names (same as in McRecord). Each bucket holds the index
+ * (plus one) of the first property which hashes into it.
+ */
+
+#define MC_COMPACT_INTERNED (0x80000000)
+
+typedef struct mc_compact_prop {
+    guint32 name;
+    guint32 first;      /* Index of the first value */
+    guint32 n_values;
+    guint32 next;       /* Next property in the same bucket plus one */
+} McCompactProp;
+
+struct mc_compact_record {
+    guint32 size;
+    guint32 ident;
+    guint32 n_prop;
+    guint32 n_str;
+    guint32 mask;       /* Number of buckets minus one */
+};
+
+typedef struct mc_compact_name {
+    const char* str;
+    guint32 len;
+} McCompactName;
+
+#define MC_COMPACT_NAME(s) { s, sizeof(s) - 1 }
+
+/* Identifiers and names used by the typed structures and the like */
+static const McCompactName mc_compact_names[] = {
+    MC_COMPACT_NAME("MECARD"),
+    MC_COMPACT_NAME("MEBKM"),
+    MC_COMPACT_NAME("MATMSG"),
+    MC_COMPACT_NAME("MELOC"),
+    MC_COMPACT_NAME("WIFI"),
+    MC_COMPACT_NAME("N"),
+    MC_COMPACT_NAME("SOUND"),
+    MC_COMPACT_NAME("TEL"),
+    MC_COMPACT_NAME("TEL-AV"),
+    MC_COMPACT_NAME("EMAIL"),
+    MC_COMPACT_NAME("NOTE"),
+    MC_COMPACT_NAME("BDAY"),
+    MC_COMPACT_NAME("ADR"),
+    MC_COMPACT_NAME("URL"),
+    MC_COMPACT_NAME("NICKNAME"),
+    MC_COMPACT_NAME("ORG"),
+    MC_COMPACT_NAME("TITLE"),
+    MC_COMPACT_NAME("TO"),
+    MC_COMPACT_NAME("SUB"),
+    MC_COMPACT_NAME("BODY"),
+    MC_COMPACT_NAME("LAT"),
+    MC_COMPACT_NAME("LNG"),
+    MC_COMPACT_NAME("ALT"),
+    MC_COMPACT_NAME("NAME"),
+    MC_COMPACT_NAME("T"),
+    MC_COMPACT_NAME("S"),
+    MC_COMPACT_NAME("P"),
+    MC_COMPACT_NAME("H")
+};
+
+/*
+ * Open addressing table of the well-known names, holding their indices
+ * plus one. It's filled in once and kept at most half full, so that
+ * the probe sequences stay short.
+ */
+#define MC_COMPACT_INTERN_SIZE (64)
+G_STATIC_ASSERT(MC_COMPACT_INTERN_SIZE >= 2 * G_N_ELEMENTS(mc_compact_names));
+static guint8 mc_compact_intern_table[MC_COMPACT_INTERN_SIZE];
+
+typedef struct mc_compact_builder {
+    McCompactRecord* rec;
+    McCompactProp* prop;
+    guint32* buckets;
+    guint32* off;
+    char* strings;
+    guint32 n_str;
+} McCompactBuilder;
+
+static inline
+const McCompactProp*
+mc_compact_record_props(
+    const McCompactRecord* rec)
+{
+    return (const McCompactProp*)(rec + 1);
+}
+
+static inline
+const guint32*
+mc_compact_record_buckets(
+    const McCompactRecord* rec)
+{
+    return (const guint32*)(mc_compact_record_props(rec) + rec->n_prop);
+}
+
+static inline
+const guint32*
+mc_compact_record_offsets(
+    const McCompactRecord* rec)
+{
+    return mc_compact_record_buckets(rec) + rec->mask + 1;
+}
+
+static
+const guint8*
+mc_compact_intern_init(
+    void)
+{
+    static gsize init = 0;
+
+    if (g_once_init_enter(&init)) {
+        guint i;
+
+        for (i = 0; i < G_N_ELEMENTS(mc_compact_names); i++) {
+            const McCompactName* name = mc_compact_names + i;
+            guint k = mc_record_name_hash(name->str, name->len) &
+                (MC_COMPACT_INTERN_SIZE - 1);
+
+            while (mc_compact_intern_table[k]) {
+                k = (k + 1) & (MC_COMPACT_INTERN_SIZE - 1);
+            }
+            mc_compact_intern_table[k] = i + 1;
+        }
+        g_once_init_leave(&init, 1);
+    }
+    return mc_compact_intern_table;
+}
+
+static
+guint32
+mc_compact_intern(
+    const void* str,
+    gsize len,
+    guint32 hash)
+{
+    const guint8* table = mc_compact_intern_init();
+    guint k = hash & (MC_COMPACT_INTERN_SIZE - 1);
+
+    while (table[k]) {
+        const guint i = table[k] - 1;
+        const McCompactName* name = mc_compact_names + i;
+
+        if (name->len == len && !memcmp(name->str, str, len)) {
+            return MC_COMPACT_INTERNED | i;
+        }
+        k = (k + 1) & (MC_COMPACT_INTERN_SIZE - 1);
+    }
+    return 0;
+}
+
+/* Accounts for a name, returns its size unless it's interned */
+static inline
+gsize
+mc_compact_name_size(
+    const void* str,
+    gsize len,
+    guint32* n_str)
+{
+    if (mc_compact_intern(str, len, mc_record_name_hash(str, len))) {
+        return 0;
+    } else {
+        (*n_str)++;
+        return len + 1;
+    }
+}
+
+static inline
+guint32
+mc_compact_buckets(
+    guint n_prop)
+{
+    guint32 n = 1;
+
+    while (n < n_prop) {
+        n <<= 1;
+    }
+    return n;
+}
+
+/* NULL if the record can't be addressed with 32-bit offsets */
+static
+McCompactRecord*
+mc_compact_builder_init(
+    McCompactBuilder* b,
+    guint n_prop,
+    guint32 n_str,
+    gsize bytes)
+{
+    const guint32 n_buckets = mc_compact_buckets(n_prop);
+    const gsize total = sizeof(McCompactRecord) +
+        n_prop * sizeof(McCompactProp) + n_buckets * sizeof(guint32) +
+        (n_str + 1) * sizeof(guint32) + bytes;
+
+    if (total <= G_MAXUINT32) {
+        McCompactRecord* rec = g_malloc(total);
+
+        rec->size = (guint32) total;
+        rec->n_prop = n_prop;
+        rec->n_str = n_str;
+        rec->mask = n_buckets - 1;
+        b->rec = rec;
+        b->prop = (McCompactProp*)(rec + 1);
+        b->buckets = (guint32*)(b->prop + n_prop);
+        b->off = b->buckets + n_buckets;
+        b->strings = (char*)(b->off + n_str + 1);
+        memset(b->buckets, 0, n_buckets * sizeof(guint32));
+        b->off[0] = 0;
+        b->n_str = 0;
+        return rec;
+    }
+    return NULL;
+}
+
+/* Reserves the next string and terminates it, returns its index */
+static inline
+guint32
+mc_compact_builder_add(
+    McCompactBuilder* b,
+    gsize len,
+    char** out)
+{
+    const guint32 k = b->n_str++;
+
+    *out = b->strings + b->off[k];
+    (*out)[len] = 0;
+    b->off[k + 1] = b->off[k] + (guint32) len + 1;
+    return k;
+}
+
+static
+guint32
+mc_compact_builder_copy(
+    McCompactBuilder* b,
+    const void* str,
+    gsize len)
+{
+    char* out;
+    const guint32 k = mc_compact_builder_add(b, len, &out);
+
+    memcpy(out, str, len);
+    return k;
+}
+
+static
+guint32
+mc_compact_builder_name(
+    McCompactBuilder* b,
+    const void* str,
+    gsize len,
+    guint32* hash)
+{
+    guint32 interned;
+
+    *hash = mc_record_name_hash(str, len);
+    interned = mc_compact_intern(str, len, *hash);
+    return interned ? interned : mc_compact_builder_copy(b, str, len);
+}
+
+/* Going backwards keeps the chains in the original order */
+static
+void
+mc_compact_builder_finish(
+    McCompactBuilder* b,
+    const guint32* hash)
+{
+    guint i;
+
+    for (i = b->rec->n_prop; i > 0; i--) {
+        guint32* bucket = b->buckets + (hash[i - 1] & b->rec->mask);
+
+        b->prop[i - 1].next = *bucket;
+        *bucket = i;
+    }
+}
+
+static
+McCompactRecord*
+mc_compact_record_build(
+    const McParser* parser)
+{
+    const McParserProp* src = parser->props;
+    const McParserValue* val = parser->values;
+    guint32 n_str = parser->n_values;
+    gsize bytes = 0;
+    McCompactBuilder b;
+    guint32* hash;
+    guint32 unused;
+    guint i, k;
+
+    /* Calculate the size */
+    bytes += mc_compact_name_size(parser->id.ptr,
+        parser->id.end - parser->id.ptr, &n_str);
+    for (i = 0; i < parser->n_props; i++) {
+        bytes += mc_compact_name_size(src[i].name.ptr,
+            src[i].name.end - src[i].name.ptr, &n_str);
+    }
+    for (i = 0; i < parser->n_values; i++) {
+        bytes += val[i].len + 1;
+    }
+
+    /* And fill it in */
+    if (!mc_compact_builder_init(&b, parser->n_props, n_str, bytes)) {
+        return NULL;
+    }
+    hash = g_new(guint32, parser->n_props);
+    b.rec->ident = mc_compact_builder_name(&b, parser->id.ptr,
+        parser->id.end - parser->id.ptr, &unused);
+    for (i = 0; i < parser->n_props; i++, src++) {
+        McCompactProp* prop = b.prop + i;
+
+        prop->name = mc_compact_builder_name(&b, src->name.ptr,
+            src->name.end - src->name.ptr, hash + i);
+        prop->first = b.n_str;
+        prop->n_values = src->n_values;
+        for (k = 0; k < src->n_values; k++, val++) {
+            char* out;
+
+            mc_compact_builder_add(&b, val->len, &out);
+            if (val->verbatim) {
+                memcpy(out, val->raw.ptr, val->len);
+            } else {
+                mc_record_decode_value(&val->raw, parser->charset,
+                    (guint8*)out);
+            }
+        }
+    }
+    mc_compact_builder_finish(&b, hash);
+    g_free(hash);
+    return b.rec;
+}
+
+McCompactRecord*
+mc_compact_record_parse(
+    const void* data,
+    size_t size)
+{
+    return mc_compact_record_parse_full(data, size, NULL);
+}
+
+McCompactRecord*
+mc_compact_record_parse_full(
+    const void* data,
+    size_t size,
+    const McParseOptions* opts)
+{
+    McParser* parser = mc_parser_default();
+    McStatsCall stats;
+    McCompactRecord* rec;
+
+    mc_stats_begin(&stats);
+    MC_PROBE2(record__start, data, size);
+    rec = mc_parser_scan(parser, data, size, opts, &stats) ?
+        mc_compact_record_build(parser) : NULL;
+    mc_parser_trim(parser);
+    mc_stats_end(&stats, MC_STATS_ENTRY_COMPACT, size, rec != NULL);
+    MC_PROBE2(record__end, size, rec != NULL);
+    return rec;
+}
+
+McCompactRecord*
+mc_compact_record_new(
+    const McRecord* src)
+{
+    if (src) {
+        guint32 n_str = 0;
+        gsize bytes = 0;
+        McCompactBuilder b;
+        guint i, k;
+
+        /* Calculate the size */
+        bytes += mc_compact_name_size(src->ident, strlen(src->ident),
+            &n_str);
+        for (i = 0; i < src->n_prop; i++) {
+            const McProperty* p = src->prop + i;
+            const size_t* len;
+            guint n;
+
+            len = mc_record_value_lengths(src, p, &n);
+            bytes += mc_compact_name_size(p->name, strlen(p->name), &n_str);
+            for (k = 0; k < n; k++) {
+                bytes += len[k] + 1;
+            }
+            n_str += n;
+        }
+
+        /* And fill it in */
+        if (mc_compact_builder_init(&b, src->n_prop, n_str, bytes)) {
+            guint32* hash = g_new(guint32, src->n_prop);
+            guint32 unused;
+
+            b.rec->ident = mc_compact_builder_name(&b, src->ident,
+                strlen(src->ident), &unused);
+            for (i = 0; i < src->n_prop; i++) {
+                const McProperty* p = src->prop + i;
+                McCompactProp* prop = b.prop + i;
+                const size_t* len;
+                guint n;
+
+                len = mc_record_value_lengths(src, p, &n);
+                prop->name = mc_compact_builder_name(&b, p->name,
+                    strlen(p->name), hash + i);
+                prop->first = b.n_str;
+                prop->n_values = n;
+                for (k = 0; k < n; k++) {
+                    mc_compact_builder_copy(&b, p->values[k], len[k]);
+                }
+            }
+            mc_compact_builder_finish(&b, hash);
+            g_free(hash);
+            return b.rec;
+        }
+    }
+    return NULL;
+}
+
+void
+mc_compact_record_free(
+    McCompactRecord* rec)
+{
+    g_free(rec);
+}
+
+size_t
+mc_compact_record_size(
+    const McCompactRecord* rec)
+{
+    return rec ? rec->size : 0;
+}
+
+static
+const char*
+mc_compact_record_string(
+    const McCompactRecord* rec,
+    guint32 k,
+    size_t* len)
+{
+    if (k & MC_COMPACT_INTERNED) {
+        const McCompactName* name = mc_compact_names +
+            (k & ~MC_COMPACT_INTERNED);
+
+        if (len) {
+            *len = name->len;
+        }
+        return name->str;
+    } else {
+        const guint32* off = mc_compact_record_offsets(rec);
+
+        if (len) {
+            *len = off[k + 1] - off[k] - 1;
+        }
+        return (const char*)(off + rec->n_str + 1) + off[k];
+    }
+}
+
+const char*
+mc_compact_record_ident(
+    const McCompactRecord* rec,
+    size_t* len)
+{
+    if (rec) {
+        return mc_compact_record_string(rec, rec->ident, len);
+    }
+    if (len) {
+        *len = 0;
+    }
+    return NULL;
+}
+
+unsigned int
+mc_compact_record_n_prop(
+    const McCompactRecord* rec)
+{
+    return rec ? rec->n_prop : 0;
+}
+
+const char*
+mc_compact_record_name(
+    const McCompactRecord* rec,
+    unsigned int prop,
+    size_t* len)
+{
+    if (rec && prop < rec->n_prop) {
+        return mc_compact_record_string(rec,
+            mc_compact_record_props(rec)[prop].name, len);
+    }
+    if (len) {
+        *len = 0;
+    }
+    return NULL;
+}
+
+unsigned int
+mc_compact_record_n_values(
+    const McCompactRecord* rec,
+    unsigned int prop)
+{
+    return (rec && prop < rec->n_prop) ?
+        mc_compact_record_props(rec)[prop].n_values : 0;
+}
+
+const char*
+mc_compact_record_value(
+    const McCompactRecord* rec,
+    unsigned int prop,
+    unsigned int i,
+    size_t* len)
+{
+    if (rec && prop < rec->n_prop) {
+        const McCompactProp* p = mc_compact_record_props(rec) + prop;
+
+        if (i < p->n_values) {
+            return mc_compact_record_string(rec, p->first + i, len);
+        }
+    }
+    if (len) {
+        *len = 0;
+    }
+    return NULL;
+}
+
+/* Follows the chain starting at next, looking for the name */
+static
+int
+mc_compact_record_find(
+    const McCompactRecord* rec,
+    guint32 next,
+    const char* name,
+    gsize len,
+    guint32 interned)
+{
+    const McCompactProp* prop = mc_compact_record_props(rec);
+
+    while (next) {
+        const guint i = next - 1;
+
+        if (interned) {
+            /* Interned names never get stored in the block */
+            if (prop[i].name == interned) {
+                return i;
+            }
+        } else if (!(prop[i].name & MC_COMPACT_INTERNED)) {
+            gsize n;
+            const char* str = mc_compact_record_string(rec, prop[i].name,
+                &n);
+
+            if (n == len && !memcmp(str, name, len)) {
+                return i;
+            }
+        }
+        next = prop[i].next;
+    }
+    return -1;
+}
+
+int
+mc_compact_record_lookup(
+    const McCompactRecord* rec,
+    const char* name)
+{
+    if (rec && name) {
+        const gsize len = strlen(name);
+        const guint32 hash = mc_record_name_hash(name, len);
+
+        return mc_compact_record_find(rec,
+            mc_compact_record_buckets(rec)[hash & rec->mask], name, len,
+            mc_compact_intern(name, len, hash));
+    }
+    return -1;
+}
+
+int
+mc_compact_record_lookup_next(
+    const McCompactRecord* rec,
+    unsigned int prop)
+{
+    if (rec && prop < rec->n_prop) {
+        const McCompactProp* p = mc_compact_record_props(rec) + prop;
+        gsize len;
+        const char* name = mc_compact_record_string(rec, p->name, &len);
+
+        return mc_compact_record_find(rec, p->next, name, len,
+            (p->name & MC_COMPACT_INTERNED) ? p->name : 0);
+    }
+    return -1;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_encode_p.h"
+#include "mc_record.h"
+
+static inline
+void
+mc_encoder_put(
+    McEncoder* enc,
+    const void* data,
+    gsize len)
+{
+    if (enc->out) {
+        memcpy(enc->out + enc->len, data, len);
+    }
+    enc->len += len;
+}
+
+static inline
+void
+mc_encoder_putc(
+    McEncoder* enc,
+    guint8 c)
+{
+    if (enc->out) {
+        enc->out[enc->len] = c;
+    }
+    enc->len++;
+}
+
+/* Identifier = 1*(ALPHA / DIGIT / "-") and so is Property-Name */
+static
+void
+mc_encoder_id(
+    McEncoder* enc,
+    const char* id)
+{
+    McBlock blk;
+
+    blk.ptr = (const guint8*)id;
+    blk.end = blk.ptr + (id ? strlen(id) : 0);
+    if (!mc_block_end(&blk) && mc_block_check_id(&blk)) {
+        mc_encoder_put(enc, blk.ptr, blk.end - blk.ptr);
+    } else {
+        enc->bad = TRUE;
+    }
+}
+
+/*
+ * The reverse of mc_record_parse_value(). Plain text and UTF-8 are
+ * copied as is, separators and the backslash get escaped (except for
+ * ':' in URL blocks, which the parser accepts unescaped). CR and LF go
+ * as is too. Other control characters and bytes which aren't valid
+ * UTF-8 can't be encoded in a way that would survive the round trip.
+ */
+static
+void
+mc_encoder_value(
+    McEncoder* enc,
+    const char* value,
+    gboolean url_block)
+{
+    McBlock blk;
+
+    blk.ptr = (const guint8*)value;
+    blk.end = blk.ptr + strlen(value);
+    while (!mc_block_end(&blk)) {
+        const guint8* start = blk.ptr;
+        gsize n = mc_block_skip_text(&blk);
+
+        if (!n) {
+            n = mc_block_skip_utf8(&blk);
+        }
+        if (n) {
+            mc_encoder_put(enc, start, n);
+        } else {
+            const guint8 c = *blk.ptr++;
+
+            switch (c) {
+            case ':':
+                if (url_block) {
+                    mc_encoder_putc(enc, c);
+                    break;
+                }
+                /* fallthrough */
+            case ',': case ';': case '\\':
+                mc_encoder_putc(enc, '\\');
+                /* fallthrough */
+            case '\r': case '\n':
+                mc_encoder_putc(enc, c);
+                break;
+            default:
+                enc->bad = TRUE;
+                return;
+            }
+        }
+    }
+}
+
+void
+mc_encoder_ident(
+    McEncoder* enc,
+    const char* ident)
+{
+    mc_encoder_id(enc, ident);
+    mc_encoder_putc(enc, ':');
+}
+
+void
+mc_encoder_property(
+    McEncoder* enc,
+    const char* name,
+    const McStr* values)
+{
+    mc_encoder_id(enc, name);
+    mc_encoder_putc(enc, ':');
+    if (values && !enc->bad) {
+        const gboolean url_block = !strcmp(name, "URL");
+        gboolean first = TRUE;
+
+        /* Empty values can't be represented, the parser skips them */
+        for (; *values && !enc->bad; values++) {
+            if (**values) {
+                if (!first) {
+                    mc_encoder_putc(enc, ',');
+                }
+                mc_encoder_value(enc, *values, url_block);
+                first = FALSE;
+            }
+        }
+    }
+    mc_encoder_putc(enc, ';');
+}
+
+void
+mc_encoder_end(
+    McEncoder* enc)
+{
+    mc_encoder_putc(enc, ';');
+}
+
+gsize
+mc_encode(
+    McEncodeFunc fn,
+    gconstpointer obj,
+    char* buf,
+    gsize size)
+{
+    McEncoder enc;
+
+    memset(&enc, 0, sizeof(enc));
+    fn(&enc, obj);
+    if (enc.bad) {
+        return 0;
+    }
+    if (buf && enc.len < size) {
+        enc.out = (guint8*)buf;
+        enc.len = 0;
+        fn(&enc, obj);
+        buf[enc.len] = 0;
+    }
+    return enc.len;
+}
+
+char*
+mc_encode_string(
+    McEncodeFunc fn,
+    gconstpointer obj)
+{
+    McEncoder enc;
+
+    memset(&enc, 0, sizeof(enc));
+    fn(&enc, obj);
+    if (!enc.bad) {
+        enc.out = g_malloc(enc.len + 1);
+        enc.len = 0;
+        fn(&enc, obj);
+        enc.out[enc.len] = 0;
+        return (char*)enc.out;
+    }
+    return NULL;
+}
+
+static
+void
+mc_record_encoder(
+    McEncoder* enc,
+    gconstpointer obj)
+{
+    const McRecord* rec = obj;
+
+    if (rec) {
+        guint i;
+
+        mc_encoder_ident(enc, rec->ident);
+        for (i = 0; i < rec->n_prop && !enc->bad; i++) {
+            mc_encoder_property(enc, rec->prop[i].name, rec->prop[i].values);
+        }
+        mc_encoder_end(enc);
+    } else {
+        enc->bad = TRUE;
+    }
+}
+
+size_t
+mc_record_encode(
+    const McRecord* rec,
+    char* buf,
+    size_t size)
+{
+    return mc_encode(mc_record_encoder, rec, buf, size);
+}
+
+char*
+mc_record_encode_string(
+    const McRecord* rec)
+{
+    return mc_encode_string(mc_record_encoder, rec);
+}
+
+char*
+mc_record_encode_batch(
+    const McRecord* const* recs,
+    size_t n,
+    size_t* offsets)
+{
+    if (recs && n) {
+        McEncoder enc;
+        size_t i;
+
+        /* Measure everything first */
+        memset(&enc, 0, sizeof(enc));
+        for (i = 0; i < n && !enc.bad; i++) {
+            mc_record_encoder(&enc, recs[i]);
+            mc_encoder_putc(&enc, 0);
+        }
+
+        /* And then write it into a single block, offsets along the way */
+        if (!enc.bad) {
+            enc.out = g_malloc(enc.len);
+            enc.len = 0;
+            for (i = 0; i < n; i++) {
+                if (offsets) {
+                    offsets[i] = enc.len;
+                }
+                mc_record_encoder(&enc, recs[i]);
+                mc_encoder_putc(&enc, 0);
+            }
+            if (offsets) {
+                offsets[n] = enc.len;
+            }
+            return (char*)enc.out;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_ENCODE_PRIVATE_H
+#define MC_ENCODE_PRIVATE_H
+
+#include "mc_types_p.h"
+
+/*
+ * Encoding is done in two passes, the first one (with NULL output)
+ * measures the exact size and validates the input, the second one
+ * writes the output. The same functions are used for both.
+ */
+typedef struct mc_encoder {
+    guint8* out;        /* NULL when measuring */
+    gsize len;
+    gboolean bad;       /* Something can't be encoded */
+} McEncoder;
+
+typedef
+void
+(*McEncodeFunc)(
+    McEncoder* enc,
+    gconstpointer obj);
+
+/* Writes "ident:" */
+void
+mc_encoder_ident(
+    McEncoder* enc,
+    const char* ident)
+    G_GNUC_INTERNAL;
+
+/* Writes "name:value,value...;", values is a NULL-terminated list */
+void
+mc_encoder_property(
+    McEncoder* enc,
+    const char* name,
+    const McStr* values)
+    G_GNUC_INTERNAL;
+
+/* Terminates the record */
+void
+mc_encoder_end(
+    McEncoder* enc)
+    G_GNUC_INTERNAL;
+
+/* Both passes, output semantics as for mc_record_encode() */
+gsize
+mc_encode(
+    McEncodeFunc fn,
+    gconstpointer obj,
+    char* buf,
+    gsize size)
+    G_GNUC_INTERNAL;
+
+/* Both passes into a single allocation, NULL if it can't be encoded */
+char*
+mc_encode_string(
+    McEncodeFunc fn,
+    gconstpointer obj)
+    G_GNUC_INTERNAL;
+
+#endif /* MC_ENCODE_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_parser_p.h"
+#include "mc_record_p.h"
+#include "mc_lazy.h"
+
+typedef struct mc_lazy_record_priv {
+    McLazyRecord pub;
+    GBytes* bytes;
+} McLazyRecordPriv;
+
+/*
+ * The values of each property are preceded by the same number of
+ * slots, which tell where the decoded values go and whether they
+ * have already been decoded.
+ */
+typedef enum mc_lazy_state {
+    MC_LAZY_PENDING,
+    MC_LAZY_BUSY,
+    MC_LAZY_DONE
+} MC_LAZY_STATE;
+
+typedef struct mc_lazy_slot {
+    guint8* out;
+    gint state;
+} McLazySlot;
+
+static
+McLazyRecord*
+mc_lazy_record_new(
+    const void* data,
+    gsize size,
+    GBytes* bytes)
+{
+    McParser* parser = mc_parser_default();
+    McLazyRecord* rec = NULL;
+
+    if (mc_parser_scan(parser, data, size, NULL, NULL)) {
+        const McParserProp* src = parser->props;
+        const McParserValue* val = parser->values;
+        const gsize values_size = parser->n_values *
+            (sizeof(McLazySlot) + sizeof(McLazyValue));
+        McLazyRecordPriv* priv;
+        McLazyProperty* prop;
+        gsize decoded = 0;
+        guint8* ptr;
+        guint8* out;
+        guint i, k;
+
+        /* Only the values which need decoding take extra space */
+        for (i = 0; i < parser->n_values; i++) {
+            if (!val[i].verbatim) {
+                decoded += val[i].len;
+            }
+        }
+
+        /* Allocate a single memory block for the whole thing */
+        priv = g_malloc0(SIZE_ALIGN(sizeof(McLazyRecordPriv)) +
+            SIZE_ALIGN(parser->n_props * sizeof(McLazyProperty)) +
+            values_size + decoded);
+        rec = &priv->pub;
+        ptr = ((guint8*)priv) + SIZE_ALIGN(sizeof(McLazyRecordPriv));
+        rec->prop = prop = (McLazyProperty*)ptr;
+        rec->n_prop = parser->n_props;
+        ptr += SIZE_ALIGN(parser->n_props * sizeof(McLazyProperty));
+        out = ptr + values_size;
+        if (bytes) {
+            priv->bytes = g_bytes_ref(bytes);
+        }
+
+        rec->ident.ptr = (const char*)parser->id.ptr;
+        rec->ident.len = parser->id.end - parser->id.ptr;
+        for (i = 0; i < parser->n_props; i++, src++, prop++) {
+            prop->name.ptr = (const char*)src->name.ptr;
+            prop->name.len = src->name.end - src->name.ptr;
+            if (src->n_values) {
+                McLazySlot* slot = (McLazySlot*)ptr;
+                McLazyValue* value = (McLazyValue*)(slot + src->n_values);
+
+                prop->values = value;
+                prop->n_values = src->n_values;
+                ptr = (guint8*)(value + src->n_values);
+                for (k = 0; k < src->n_values; k++, val++, value++, slot++) {
+                    value->raw.ptr = (const char*)val->raw.ptr;
+                    value->raw.len = val->raw.end - val->raw.ptr;
+                    value->len = val->len;
+                    if (!val->verbatim) {
+                        value->needs_unescape = TRUE;
+                        slot->out = out;
+                        out += val->len;
+                    }
+                }
+            }
+        }
+    }
+    mc_parser_trim(parser);
+    return rec;
+}
+
+McLazyRecord*
+mc_lazy_record_parse(
+    const void* data,
+    size_t size)
+{
+    return mc_lazy_record_new(data, size, NULL);
+}
+
+McLazyRecord*
+mc_lazy_record_parse_bytes(
+    GBytes* bytes)
+{
+    if (bytes) {
+        gsize size;
+        const void* data = g_bytes_get_data(bytes, &size);
+
+        return mc_lazy_record_new(data, size, bytes);
+    }
+    return NULL;
+}
+
+void
+mc_lazy_record_free(
+    McLazyRecord* rec)
+{
+    if (rec) {
+        McLazyRecordPriv* priv = (McLazyRecordPriv*)((guint8*)rec -
+            G_STRUCT_OFFSET(McLazyRecordPriv, pub));
+
+        if (priv->bytes) {
+            g_bytes_unref(priv->bytes);
+        }
+        g_free(priv);
+    }
+}
+
+const char*
+mc_property_value(
+    const McLazyProperty* prop,
+    unsigned int i,
+    size_t* len)
+{
+    if (prop && i < prop->n_values) {
+        const McLazyValue* value = prop->values + i;
+
+        if (len) {
+            *len = value->len;
+        }
+        if (value->needs_unescape) {
+            McLazySlot* slot = (McLazySlot*)prop->values -
+                prop->n_values + i;
+
+            if (g_atomic_int_get(&slot->state) != MC_LAZY_DONE) {
+                if (g_atomic_int_compare_and_exchange(&slot->state,
+                    MC_LAZY_PENDING, MC_LAZY_BUSY)) {
+                    McBlock raw;
+
+                    raw.ptr = (const guint8*)value->raw.ptr;
+                    raw.end = raw.ptr + value->raw.len;
+                    mc_record_decode_value(&raw, MC_CHARSET_AUTO,
+                        slot->out);
+                    g_atomic_int_set(&slot->state, MC_LAZY_DONE);
+                } else {
+                    /* Another thread is decoding it right now */
+                    while (g_atomic_int_get(&slot->state) != MC_LAZY_DONE) {
+                        g_thread_yield();
+                    }
+                }
+            }
+            return (const char*)slot->out;
+        }
+        return value->raw.ptr;
+    }
+    if (len) {
+        *len = 0;
+    }
+    return NULL;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
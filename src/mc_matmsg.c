@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_schema_p.h"
+#include "mc_matmsg.h"
+
+static const McSchemaField matmsg_fields[] = {
+    MC_SCHEMA_FIELD(MatMsg, to, "TO", LIST),
+    MC_SCHEMA_FIELD(MatMsg, sub, "SUB", SINGLE),
+    MC_SCHEMA_FIELD(MatMsg, body, "BODY", SINGLE)
+};
+
+static McSchema matmsg_schema = MC_SCHEMA("MATMSG", MatMsg, matmsg_fields,
+    TYPED);
+
+MatMsg*
+matmsg_parse_data(
+    const void* data,
+    size_t size)
+{
+    return mc_schema_parse(&matmsg_schema, data, size, NULL);
+}
+
+MatMsg*
+matmsg_parse(
+    const char* str)
+{
+    return str ? matmsg_parse_data(str, strlen(str)) : NULL;
+}
+
+static
+void
+matmsg_encoder(
+    McEncoder* enc,
+    gconstpointer obj)
+{
+    mc_schema_encode(enc, &matmsg_schema, obj);
+}
+
+size_t
+matmsg_encode(
+    const MatMsg* matmsg,
+    char* buf,
+    size_t size)
+{
+    return mc_encode(matmsg_encoder, matmsg, buf, size);
+}
+
+char*
+matmsg_encode_string(
+    const MatMsg* matmsg)
+{
+    return mc_encode_string(matmsg_encoder, matmsg);
+}
+
+void
+matmsg_free(
+    MatMsg* matmsg)
+{
+    mc_schema_unref(matmsg);
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_schema_p.h"
+#include "mc_mebkm.h"
+
+static const McSchemaField mebkm_fields[] = {
+    MC_SCHEMA_FIELD(MeBkm, title, "TITLE", SINGLE),
+    MC_SCHEMA_FIELD(MeBkm, url, "URL", SINGLE)
+};
+
+static McSchema mebkm_schema = MC_SCHEMA("MEBKM", MeBkm, mebkm_fields,
+    TYPED);
+
+MeBkm*
+mebkm_parse_data(
+    const void* data,
+    size_t size)
+{
+    return mc_schema_parse(&mebkm_schema, data, size, NULL);
+}
+
+MeBkm*
+mebkm_parse(
+    const char* str)
+{
+    return str ? mebkm_parse_data(str, strlen(str)) : NULL;
+}
+
+static
+void
+mebkm_encoder(
+    McEncoder* enc,
+    gconstpointer obj)
+{
+    mc_schema_encode(enc, &mebkm_schema, obj);
+}
+
+size_t
+mebkm_encode(
+    const MeBkm* mebkm,
+    char* buf,
+    size_t size)
+{
+    return mc_encode(mebkm_encoder, mebkm, buf, size);
+}
+
+char*
+mebkm_encode_string(
+    const MeBkm* mebkm)
+{
+    return mc_encode_string(mebkm_encoder, mebkm);
+}
+
+void
+mebkm_free(
+    MeBkm* mebkm)
+{
+    mc_schema_unref(mebkm);
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
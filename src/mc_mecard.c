@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2020-2022 by Slava Monich <slava@monich.com>
+ * Copyright (C) 2020-2026 by Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -34,162 +34,43 @@
  * any official policies, either expressed or implied.
  */
 
-#include "mc_types_p.h"
+#include "mc_arena_p.h"
+#include "mc_schema_p.h"
+#include "mc_arena.h"
 #include "mc_mecard.h"
-#include "mc_record.h"
 
-enum me_card_field {
-    MECARD_FIELD_N,
-    MECARD_FIELD_TEL,
-    MECARD_FIELD_EMAIL,
-    MECARD_FIELD_BDAY,
-    MECARD_FIELD_ADR,
-    MECARD_FIELD_NOTE,
-    MECARD_FIELD_URL,
-    MECARD_FIELD_NICKNAME,
-    MECARD_FIELD_ORG,
-    MECARD_FIELD_COUNT
+static const McSchemaField mecard_fields[] = {
+    MC_SCHEMA_FIELD(MeCard, n, "N", LIST),
+    MC_SCHEMA_FIELD(MeCard, tel, "TEL", MULTI),
+    MC_SCHEMA_FIELD(MeCard, email, "EMAIL", MULTI),
+    MC_SCHEMA_FIELD(MeCard, bday, "BDAY", MULTI),
+    MC_SCHEMA_FIELD(MeCard, adr, "ADR", LIST),
+    MC_SCHEMA_FIELD(MeCard, note, "NOTE", MULTI),
+    MC_SCHEMA_FIELD(MeCard, url, "URL", MULTI),
+    MC_SCHEMA_FIELD(MeCard, nickname, "NICKNAME", MULTI),
+    MC_SCHEMA_FIELD(MeCard, org, "ORG", MULTI)
 };
 
-typedef struct me_card_fields {
-    const McStr* field[MECARD_FIELD_COUNT];
-} MeCardFields;
+static McSchema mecard_schema = MC_SCHEMA("MECARD", MeCard, mecard_fields,
+    MECARD);
 
-typedef struct me_card_priv {
-    union me_card_data {
-        MeCard pub;
-        MeCardFields fields;
-    } data;
-    McRecord* rec;
-} MeCardPriv;
-
-#define MECARD_ID_LEN (6)
-static const char MECARD_ID[] = "MECARD";
-static const char* MECARD_FIELDS[] = {
-    "N",        /* MECARD_FIELD_N */
-    "TEL",      /* MECARD_FIELD_TEL */
-    "EMAIL",    /* MECARD_FIELD_EMAIL */
-    "BDAY",     /* MECARD_FIELD_BDAY */
-    "ADR",      /* MECARD_FIELD_ADR */
-    "NOTE",     /* MECARD_FIELD_NOTE */
-    "URL",      /* MECARD_FIELD_URL */
-    "NICKNAME", /* MECARD_FIELD_NICKNAME */
-    "ORG"       /* MECARD_FIELD_ORG */
-};
-
-G_STATIC_ASSERT(sizeof(MeCardFields) == sizeof(MeCard));
-G_STATIC_ASSERT(G_N_ELEMENTS(MECARD_FIELDS) == MECARD_FIELD_COUNT);
-
-static
 MeCard*
-mecard_from_record(
-    McRecord* rec)
+mecard_parse_data(
+    const void* data,
+    size_t size)
 {
-    MeCardPriv* priv;
-    MeCardFields* fields;
-    guint8* ptr;
-    guint count[MECARD_FIELD_COUNT];
-    gboolean combine[MECARD_FIELD_COUNT];
-    gsize total = SIZE_ALIGN(sizeof(MeCardPriv));
-    guint i, k;
-
-    memset(count, 0, sizeof(count));
-    memset(combine, 0, sizeof(combine));
-
-    /*
-     * Count total number of values for each name. The same name may
-     * occur several times and each occasion may have several properties.
-     * If there are several non-empty occasions then we need to allocate
-     * additional storage for combining lists of values.
-     */
-    for (i = 0; i < rec->n_prop; i++) {
-        const McProperty* prop = rec->prop + i;
-
-        for (k = 0; k < MECARD_FIELD_COUNT; k++) {
-            if (!strcmp(MECARD_FIELDS[k], prop->name)) {
-                if (prop->values) {
-                    gsize len = g_strv_length((char**)prop->values);
-
-                    if (len > 0) {
-                        if (count[k]) combine[k] = TRUE;
-                        count[k] += len;
-                    }
-                }
-                break;
-            }
-        }
-    }
-
-    for (k = 0; k < MECARD_FIELD_COUNT; k++) {
-        if (combine[k]) {
-            total += SIZE_ALIGN((count[k] + 1) * sizeof(char*));
-        }
-    }
-
-    priv = g_malloc0(total);
-    fields = &priv->data.fields;
-    priv->rec = rec;
-
-    ptr = ((guint8*)priv) + SIZE_ALIGN(sizeof(*priv));
-    for (k = 0; k < MECARD_FIELD_COUNT; k++) {
-        const char* name = MECARD_FIELDS[k];
-
-        if (count[k]) {
-            if (combine[k]) {
-                /* Multiple occasions */
-                McStr* dest = (McStr*)ptr;
-
-                fields->field[k] = (McStr*)ptr;
-                ptr += SIZE_ALIGN((count[k] + 1) * sizeof(char*));
-                for (i = 0; i < rec->n_prop; i++) {
-                    const McProperty* prop = rec->prop + i;
-
-                    if (prop->values && !strcmp(name, prop->name)) {
-                        const McStr* src = prop->values;
-
-                        while (*src) *dest++ = *src++;
-                    }
-                }
-            } else {
-                /* Single occasion (and it must be there) */
-                for (i = 0; i < rec->n_prop; i++) {
-                    const McProperty* prop = rec->prop + i;
-
-                    if (prop->values && prop->values[0] &&
-                        !strcmp(name, prop->name)) {
-                        fields->field[k] = prop->values;
-                        break;
-                    }
-                }
-            }
-        }
-    }
-    return &priv->data.pub;
+    return mc_schema_parse(&mecard_schema, data, size, NULL);
 }
 
 MeCard*
-mecard_parse_data(
+mecard_parse_data_arena(
+    McArena* arena,
     const void* data,
     size_t size)
 {
-    if (data && size > MECARD_ID_LEN) {
-        McBlock blk;
-
-        /* Quick check to see if it makes sense to parse the whole thing */
-        blk.ptr = data;
-        blk.end = blk.ptr + size;
-        if (mc_block_skip_spaces(&blk) &&
-            !memcmp(blk.ptr, MECARD_ID, MECARD_ID_LEN)) {
-            /* Could be an MECARD, give it a shot */
-            McRecord* rec = mc_record_parse_data(blk.ptr, blk.end - blk.ptr);
-
-            if (rec) {
-                if (!strcmp(rec->ident, MECARD_ID)) {
-                    return mecard_from_record(rec);
-                }
-                mc_record_free(rec);
-            }
-        }
+    if (arena) {
+        mc_arena_set_needed(arena, 0);
+        return mc_schema_parse(&mecard_schema, data, size, arena);
     }
     return NULL;
 }
@@ -201,17 +82,50 @@ mecard_parse(
     return str ? mecard_parse_data(str, strlen(str)) : NULL;
 }
 
+static
 void
-mecard_free(
+mecard_encoder(
+    McEncoder* enc,
+    gconstpointer obj)
+{
+    mc_schema_encode(enc, &mecard_schema, obj);
+}
+
+size_t
+mecard_encode(
+    const MeCard* mecard,
+    char* buf,
+    size_t size)
+{
+    return mc_encode(mecard_encoder, mecard, buf, size);
+}
+
+char*
+mecard_encode_string(
+    const MeCard* mecard)
+{
+    return mc_encode_string(mecard_encoder, mecard);
+}
+
+MeCard*
+mecard_ref(
     MeCard* mecard)
 {
-    if (mecard) {
-        MeCardPriv* priv = (MeCardPriv*)((guint8*)mecard -
-            G_STRUCT_OFFSET(MeCardPriv, data.pub));
+    return mc_schema_ref(mecard);
+}
 
-        mc_record_free(priv->rec);
-        g_free(priv);
-    }
+void
+mecard_unref(
+    MeCard* mecard)
+{
+    mc_schema_unref(mecard);
+}
+
+void
+mecard_free(
+    MeCard* mecard)
+{
+    mc_schema_unref(mecard);
 }
 
 /*
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_schema_p.h"
+#include "mc_meloc.h"
+
+static const McSchemaField meloc_fields[] = {
+    MC_SCHEMA_FIELD(MeLoc, lat, "LAT", SINGLE),
+    MC_SCHEMA_FIELD(MeLoc, lng, "LNG", SINGLE),
+    MC_SCHEMA_FIELD(MeLoc, alt, "ALT", SINGLE),
+    MC_SCHEMA_FIELD(MeLoc, name, "NAME", SINGLE)
+};
+
+static McSchema meloc_schema = MC_SCHEMA("MELOC", MeLoc, meloc_fields,
+    TYPED);
+
+MeLoc*
+meloc_parse_data(
+    const void* data,
+    size_t size)
+{
+    return mc_schema_parse(&meloc_schema, data, size, NULL);
+}
+
+MeLoc*
+meloc_parse(
+    const char* str)
+{
+    return str ? meloc_parse_data(str, strlen(str)) : NULL;
+}
+
+static
+void
+meloc_encoder(
+    McEncoder* enc,
+    gconstpointer obj)
+{
+    mc_schema_encode(enc, &meloc_schema, obj);
+}
+
+size_t
+meloc_encode(
+    const MeLoc* meloc,
+    char* buf,
+    size_t size)
+{
+    return mc_encode(meloc_encoder, meloc, buf, size);
+}
+
+char*
+meloc_encode_string(
+    const MeLoc* meloc)
+{
+    return mc_encode_string(meloc_encoder, meloc);
+}
+
+void
+meloc_free(
+    MeLoc* meloc)
+{
+    mc_schema_unref(meloc);
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_parser_p.h"
+#include "mc_record_p.h"
+#include "mc_stats_p.h"
+#include "mc_parser.h"
+
+static GPrivate mc_parser_private = G_PRIVATE_INIT((GDestroyNotify)
+    mc_parser_free);
+
+/* Accounts for another decoded string, FALSE if it's too much */
+static
+gboolean
+mc_parser_output(
+    McParser* parser,
+    gsize len)
+{
+    const McParseOptions* opts = parser->opts;
+
+    parser->output += len;
+    if (opts && opts->max_output && parser->output > opts->max_output) {
+        mc_stats_fail(parser->stats, MC_STATS_FAIL_LIMIT);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static
+gboolean
+mc_parser_scan_ident(
+    const McBlock* id,
+    gpointer user_data)
+{
+    McParser* parser = user_data;
+
+    parser->id = *id;
+    return mc_parser_output(parser, id->end - id->ptr);
+}
+
+McParserProp*
+mc_parser_add_property(
+    McParser* parser,
+    const McBlock* name)
+{
+    McParserProp* prop;
+
+    if (parser->n_props == parser->props_alloc) {
+        const guint n = parser->props_alloc * 2;
+
+        if (parser->props == parser->inline_props) {
+            parser->props = g_new(McParserProp, n);
+            memcpy(parser->props, parser->inline_props,
+                sizeof(parser->inline_props));
+        } else {
+            parser->props = g_renew(McParserProp, parser->props, n);
+        }
+        parser->props_alloc = n;
+    }
+    prop = parser->props + parser->n_props++;
+    prop->name = *name;
+    prop->n_values = 0;
+    prop->tag = 0;
+    return prop;
+}
+
+McParserValue*
+mc_parser_add_value(
+    McParser* parser,
+    const McBlock* raw,
+    gsize len,
+    gboolean verbatim)
+{
+    McParserValue* value;
+
+    if (parser->n_values == parser->values_alloc) {
+        const guint n = parser->values_alloc * 2;
+
+        if (parser->values == parser->inline_values) {
+            parser->values = g_new(McParserValue, n);
+            memcpy(parser->values, parser->inline_values,
+                sizeof(parser->inline_values));
+        } else {
+            parser->values = g_renew(McParserValue, parser->values, n);
+        }
+        parser->values_alloc = n;
+    }
+    value = parser->values + parser->n_values++;
+    value->raw = *raw;
+    value->len = len;
+    value->verbatim = verbatim;
+    parser->props[parser->n_props - 1].n_values++;
+    return value;
+}
+
+static
+MC_RECORD_PROPERTY_ACTION
+mc_parser_scan_property(
+    const McBlock* name,
+    gpointer user_data)
+{
+    McParser* parser = user_data;
+    const McParseOptions* opts = parser->opts;
+
+    if (opts && opts->max_props && parser->n_props >= opts->max_props) {
+        mc_stats_fail(parser->stats, MC_STATS_FAIL_LIMIT);
+        return MC_RECORD_PROPERTY_STOP;
+    }
+    mc_parser_add_property(parser, name);
+    return mc_parser_output(parser, name->end - name->ptr) ?
+        MC_RECORD_PROPERTY_VALUES : MC_RECORD_PROPERTY_STOP;
+}
+
+static
+gboolean
+mc_parser_scan_value(
+    const McBlock* raw,
+    gsize len,
+    gboolean verbatim,
+    gpointer user_data)
+{
+    McParser* parser = user_data;
+    const McParseOptions* opts = parser->opts;
+
+    if (opts && ((opts->max_value_len && len > opts->max_value_len) ||
+        (opts->max_values && parser->props[parser->n_props - 1].n_values >=
+        opts->max_values))) {
+        mc_stats_fail(parser->stats, MC_STATS_FAIL_LIMIT);
+        return FALSE;
+    }
+    mc_parser_add_value(parser, raw, len, verbatim);
+    return mc_parser_output(parser, len);
+}
+
+static
+gboolean
+mc_parser_scan_property_end(
+    gpointer user_data)
+{
+    return TRUE;
+}
+
+gboolean
+mc_parser_scan(
+    McParser* parser,
+    const void* data,
+    gsize size,
+    const McParseOptions* opts,
+    McStatsCall* stats)
+{
+    static const McRecordWalkCallbacks scan_cb = {
+        mc_parser_scan_ident,
+        mc_parser_scan_property,
+        mc_parser_scan_value,
+        mc_parser_scan_property_end
+    };
+
+    gboolean ok;
+
+    parser->n_props = 0;
+    parser->n_values = 0;
+    parser->output = 0;
+    parser->opts = opts;
+    parser->stats = stats;
+    parser->charset = opts ? opts->charset : MC_CHARSET_AUTO;
+    if (parser->charset == MC_CHARSET_DETECT) {
+        parser->charset = mc_record_detect_charset(data, size);
+    }
+    ok = mc_record_walk_full(data, size, parser->charset, &scan_cb, parser,
+        stats);
+    parser->opts = NULL;
+    parser->stats = NULL;
+    return ok;
+}
+
+McParser*
+mc_parser_default(
+    void)
+{
+    McParser* parser = g_private_get(&mc_parser_private);
+
+    if (G_UNLIKELY(!parser)) {
+        parser = mc_parser_new();
+        g_private_set(&mc_parser_private, parser);
+    }
+    return parser;
+}
+
+McParser*
+mc_parser_new(
+    void)
+{
+    McParser* parser = g_new0(McParser, 1);
+
+    parser->props = parser->inline_props;
+    parser->values = parser->inline_values;
+    parser->props_alloc = G_N_ELEMENTS(parser->inline_props);
+    parser->values_alloc = G_N_ELEMENTS(parser->inline_values);
+    return parser;
+}
+
+void
+mc_parser_trim(
+    McParser* parser)
+{
+    parser->n_props = 0;
+    parser->n_values = 0;
+    if (G_UNLIKELY(parser->props_alloc > MC_PARSER_MAX_PROPS)) {
+        parser->props = g_renew(McParserProp, parser->props,
+            MC_PARSER_MAX_PROPS);
+        parser->props_alloc = MC_PARSER_MAX_PROPS;
+    }
+    if (G_UNLIKELY(parser->values_alloc > MC_PARSER_MAX_VALUES)) {
+        parser->values = g_renew(McParserValue, parser->values,
+            MC_PARSER_MAX_VALUES);
+        parser->values_alloc = MC_PARSER_MAX_VALUES;
+    }
+}
+
+McRecord*
+mc_parser_parse(
+    McParser* parser,
+    const void* data,
+    size_t size)
+{
+    return parser ? mc_record_new(parser, data, size, NULL, NULL) : NULL;
+}
+
+void
+mc_parser_free(
+    McParser* parser)
+{
+    if (parser) {
+        if (parser->props != parser->inline_props) {
+            g_free(parser->props);
+        }
+        if (parser->values != parser->inline_values) {
+            g_free(parser->values);
+        }
+        g_free(parser);
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
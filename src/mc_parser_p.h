@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_PARSER_PRIVATE_H
+#define MC_PARSER_PRIVATE_H
+
+#include "mc_types_p.h"
+#include "mc_stats_p.h"
+#include "mc_record.h"
+
+/*
+ * Results of the first pass. Typical records fit into the inline
+ * arrays, larger ones are stored in the heap and those allocations
+ * are reused by the subsequent calls. Tables which have grown beyond
+ * the maximum size (e.g. for a huge payload) are shrunk back to it by
+ * mc_parser_trim() so that the parser doesn't keep holding that much
+ * memory for the lifetime of the thread.
+ */
+
+#define MC_PARSER_INLINE_PROPS (16)
+#define MC_PARSER_INLINE_VALUES (32)
+#define MC_PARSER_MAX_PROPS (8 * MC_PARSER_INLINE_PROPS)
+#define MC_PARSER_MAX_VALUES (8 * MC_PARSER_INLINE_VALUES)
+
+typedef struct mc_parser_value {
+    McBlock raw;
+    gsize len;
+    gboolean verbatim;
+} McParserValue;
+
+typedef struct mc_parser_prop {
+    McBlock name;
+    guint n_values;
+    guint tag;          /* Free for use by the caller */
+} McParserProp;
+
+struct mc_parser {
+    McBlock id;
+    const McParseOptions* opts; /* Only valid during the scan */
+    McStatsCall* stats;         /* Only valid during the scan */
+    MC_CHARSET charset;
+    gsize output;
+    McParserProp* props;
+    McParserValue* values;
+    guint n_props;
+    guint n_values;
+    guint props_alloc;
+    guint values_alloc;
+    McParserProp inline_props[MC_PARSER_INLINE_PROPS];
+    McParserValue inline_values[MC_PARSER_INLINE_VALUES];
+};
+
+/* Per-thread parser */
+McParser*
+mc_parser_default(
+    void)
+    G_GNUC_INTERNAL;
+
+/* Shrinks the tables, to be called when the results are no longer needed */
+void
+mc_parser_trim(
+    McParser* parser)
+    G_GNUC_INTERNAL;
+
+/* Appends a property to the tables */
+McParserProp*
+mc_parser_add_property(
+    McParser* parser,
+    const McBlock* name)
+    G_GNUC_INTERNAL;
+
+/* Appends a value to the last property */
+McParserValue*
+mc_parser_add_value(
+    McParser* parser,
+    const McBlock* raw,
+    gsize len,
+    gboolean verbatim)
+    G_GNUC_INTERNAL;
+
+/*
+ * Fills in the tables, returns FALSE if the data can't be parsed or
+ * exceeds the limits. NULL options mean the defaults, NULL stats mean
+ * that the scan isn't counted.
+ */
+gboolean
+mc_parser_scan(
+    McParser* parser,
+    const void* data,
+    gsize size,
+    const McParseOptions* opts,
+    McStatsCall* stats)
+    G_GNUC_INTERNAL;
+
+#endif /* MC_PARSER_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_PROBE_PRIVATE_H
+#define MC_PROBE_PRIVATE_H
+
+#include "mc_types_p.h"
+
+/*
+ * USDT static probes of the "libmc" provider, compiled in only when
+ * MC_PROBES is defined ("make profiling" defines it if sys/sdt.h is
+ * available, otherwise the probes are no-ops). Until a tracer like
+ * perf, bpftrace or systemtap attaches to them, each one is a single
+ * nop instruction. The probes are:
+ *
+ *   record__start(data, size)      record__end(size, ok)
+ *   schema__start(ident, size)     schema__end(ident, ok)
+ *   property(name, len)            value(path, len, verbatim)
+ *
+ * where path is the MC_STATS_PATH of the slowest decoder used for the
+ * value and len is the length of the decoded value.
+ */
+
+#ifdef MC_PROBES
+#  include <sys/sdt.h>
+#  define MC_PROBE2(name,a,b) DTRACE_PROBE2(libmc, name, a, b)
+#  define MC_PROBE3(name,a,b,c) DTRACE_PROBE3(libmc, name, a, b, c)
+#else
+#  define MC_PROBE2(name,a,b) ((void)0)
+#  define MC_PROBE3(name,a,b,c) ((void)0)
+#endif
+
+#endif /* MC_PROBE_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
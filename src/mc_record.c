@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2020-2021 by Slava Monich <slava@monich.com>
+ * Copyright (C) 2020-2026 by Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -34,7 +34,12 @@
  * any official policies, either expressed or implied.
  */
 
-#include "mc_types_p.h"
+#include "mc_arena_p.h"
+#include "mc_parser_p.h"
+#include "mc_probe_p.h"
+#include "mc_record_p.h"
+#include "mc_sjis_p.h"
+#include "mc_stats_p.h"
 #include "mc_record.h"
 
 /*
@@ -43,126 +48,6 @@
  * 7.1.2 Direct MC Format (DMF)
  */
 
-#define MAX_CHAR_SIZE (6)
-
-static
-gsize
-mc_property_data_size(
-    gsize name_len,
-    char** values)
-{
-    guint i;
-    gsize size = SIZE_ALIGN(sizeof(McProperty)) + SIZE_ALIGN(name_len + 1);
-    const guint nval = values ? g_strv_length(values) : 0;
-
-    if (nval) {
-        size += SIZE_ALIGN((nval + 1) * sizeof(char*));
-        for (i = 0; i < nval; i++) {
-            size += SIZE_ALIGN(strlen(values[i]) + 1);
-        }
-    }
-    return size;
-}
-
-static
-void*
-mc_property_data_copy(
-    McProperty* prop,
-    char* ptr,
-    const void* name,
-    gsize name_len,
-    char** values)
-{
-    const guint nval = values ? g_strv_length(values) : 0;
-
-    prop->name = ptr;
-    memcpy(ptr, name, name_len);
-    ptr += SIZE_ALIGN(name_len + 1);
-    if (nval) {
-        guint i;
-        char** dest = (char**)ptr;
-
-        prop->values = (const McStr*)dest;
-        ptr += SIZE_ALIGN((nval + 1) * sizeof(char*));
-        for (i = 0; i < nval; i++) {
-            const char* val = values[i];
-
-            dest[i] = ptr;
-            strcpy(ptr, val);
-            ptr += SIZE_ALIGN(strlen(val) + 1);
-        }
-    }
-    return ptr;
-}
-
-static
-McProperty*
-mc_property_new(
-    const void* name,
-    gsize name_len,
-    char** values)
-{
-    /* Allocate a single memory block for the whole thing. Align string
-     * pointers at 8-byte boundary for better efficiency. */
-    McProperty* prop = g_malloc0(SIZE_ALIGN(sizeof(McProperty)) +
-        mc_property_data_size(name_len, values));
-
-    mc_property_data_copy(prop, ((char*)prop) + SIZE_ALIGN(sizeof(*prop)),
-        name, name_len, values);
-    return prop;
-}
-
-static
-McRecord*
-mc_record_alloc(
-    const McBlock* id,
-    GPtrArray* props)
-{
-    guint i;
-    McRecord* rec;
-    McProperty* prop;
-    char* ptr;
-    gsize total = SIZE_ALIGN(sizeof(McRecord)) +
-        SIZE_ALIGN(props->len * sizeof(McProperty)) +
-        SIZE_ALIGN(id->end - id->ptr + 1);
-
-    for (i = 0; i < props->len; i++) {
-        const McProperty* src = props->pdata[i];
-
-        total += mc_property_data_size(strlen(src->name), (char**)src->values);
-    }
-
-    /* Allocate a single memory block for the whole thing. Align string
-     * pointers at 8-byte boundary for better efficiency. */
-    rec = g_malloc0(total);
-    prop = (McProperty*)(((char*)rec) + SIZE_ALIGN(sizeof(McRecord)));
-    ptr = ((char*)prop) + SIZE_ALIGN(props->len * sizeof(McProperty));
-    rec->prop = prop;
-    rec->n_prop = props->len;
-    for (i = 0; i < props->len; i++) {
-        const McProperty* src = props->pdata[i];
-
-        ptr = mc_property_data_copy(prop + i, ptr, src->name,
-            strlen(src->name), (char**)src->values);
-    }
-
-    rec->ident = ptr;
-    memcpy(ptr, id->ptr, id->end - id->ptr);
-    return rec;
-}
-
-/*
- * Identifier = 1*(ALPHA / DIGIT / "-")
- * Property-Name = 1*(ALPHA / DIGIT / "-")
- */
-static
-gboolean
-mc_block_id(
-    guchar c)
-{
-    return (g_ascii_table[c] & G_ASCII_ALNUM) || c == (guchar)'-';
-}
-
 /*
  * Printable-ASCII-character = %x20-2B / %x2D-39 / %3C-%x5B / %x5D-7E / CRLF
  * CRLF = %x0D %x0A
@@ -189,32 +74,33 @@ mc_block_printable_ascii_char(
     }
 }
 
+/*
+ * ShiftJISChar = (%x81-9F / %xE0-FC) (%x40-7E / %x80-FC)
+ *
+ * Apparently, only two-byte sequences are allowed. The pair is decoded
+ * into UTF-8 (never more than 3 bytes since all the mapped characters
+ * are in the BMP) and the block advances by the 2 input bytes.
+ */
 static
 gsize
-mc_block_utf8_char(
+mc_block_shift_jis_char(
     McBlock* blk,
     guchar* out)
 {
-    const gsize maxlen = blk->end - blk->ptr;
-
-    if (maxlen > 1) {
-        const char c = (char)blk->ptr[0];
-        char mask, value;
-        guint i, n;
-
-        /* Note: we are relying on signed shift to replicate the sign bit */
-        for (mask = 0xe0, value = 0xc0, n = 2;  n < 7; n++,
-             mask >>= 1, value >>= 1) {
-            if ((c & mask) == value) {
-                if (maxlen >= n) {
-                    for (i = 1; i < n && ((blk->ptr[i] & 0xc0) == 0x80); i++);
-                    if (i == n) {
-                        memcpy(out, blk->ptr, n);
-                        blk->ptr += n;
-                        return n;
-                    }
-                }
-                break;
+    if (blk->end > (blk->ptr + 1)) {
+        const guint cp = mc_sjis_lookup(blk->ptr[0], blk->ptr[1]);
+
+        if (cp) {
+            blk->ptr += 2;
+            if (cp < 0x800) {
+                out[0] = (guchar)(0xc0 | (cp >> 6));
+                out[1] = (guchar)(0x80 | (cp & 0x3f));
+                return 2;
+            } else {
+                out[0] = (guchar)(0xe0 | (cp >> 12));
+                out[1] = (guchar)(0x80 | ((cp >> 6) & 0x3f));
+                out[2] = (guchar)(0x80 | (cp & 0x3f));
+                return 3;
             }
         }
     }
@@ -222,38 +108,43 @@ mc_block_utf8_char(
 }
 
 /*
- * ShiftJISChar = (%x81-9F / %xE0-FC) (%x40-7E / %x80-FC)
- *
- * Apparently, only two-byte sequences are allowed.
+ * Decodes the rest of a run of Shift-JIS pairs, after the first one has
+ * been decoded by mc_block_shift_jis_char(). Stops where the character
+ * by character decoding would pick something other than Shift-JIS, i.e.
+ * at ASCII or where the bytes form a valid UTF-8 sequence (unless UTF-8
+ * isn't an option). The latter is only possible for %xE0-F4 lead bytes,
+ * %x81-9F can't start UTF-8.
  */
 static
 gsize
-mc_block_shift_jis_char(
+mc_block_shift_jis_run(
     McBlock* blk,
-    guchar* out)
+    guint8* out,
+    gboolean utf8)
 {
-    if (blk->end > (blk->ptr + 1)) {
-        const guchar c0 = blk->ptr[0];
+    gsize len = 0;
 
-        if ((c0 >= 0x81 && c0 <= 0x9F) || (c0 >= 0xE0 && c0 <= 0xFC)) {
-            const guchar c1 = blk->ptr[1];
+    while (blk->end > (blk->ptr + 1) && blk->ptr[0] >= 0x81) {
+        guchar c[MC_RECORD_MAX_CHAR_SIZE];
+        gsize n;
 
-            if ((c1 >= 0x40 && c1 <= 0x7E) || (c1 >= 0x80 && c1 <= 0xFC)) {
-                gsize in = 0, n = 0;
-                gchar* ret = g_convert((const gchar*)blk->ptr, 2,
-                    "UTF-8", "SHIFT-JIS", &in, &n, NULL);
+        if (utf8 && blk->ptr[0] >= 0xe0) {
+            McBlock tmp = *blk;
 
-                if (ret && in == 2 && n > 0 && n <= MAX_CHAR_SIZE) {
-                    memcpy(out, ret, n);
-                    blk->ptr += n;
-                    g_free(ret);
-                    return n;
-                }
-                g_free(ret);
+            if (mc_block_skip_utf8(&tmp)) {
+                break;
             }
         }
+        n = mc_block_shift_jis_char(blk, c);
+        if (!n) {
+            break;
+        }
+        if (out) {
+            memcpy(out + len, c, n);
+        }
+        len += n;
     }
-    return 0;
+    return len;
 }
 
 /*
@@ -276,6 +167,22 @@ mc_block_iso_8bit_char(
     }
 }
 
+gsize
+mc_record_decode_char(
+    McBlock* blk,
+    guchar* out)
+{
+    gsize n = mc_block_printable_ascii_char(blk, out);
+
+    if (!n) {
+        n = mc_block_shift_jis_char(blk, out);
+        if (!n) {
+            n = mc_block_iso_8bit_char(blk, out);
+        }
+    }
+    return n;
+}
+
 /*
  * Property-Value = *(printable-ASCII-char / ISO8Bit/ ShiftJISChar / UTF8-char)
  *
@@ -283,35 +190,99 @@ mc_block_iso_8bit_char(
  * and "\", SHALL be denoted by using the escape sequence with a backslash "\".
  *
  * The spec doesn't tell how to distinguish ISO8Bit from UTF8 or ShiftJIS :/
- * So we try UTF8 and ShiftJIS first and if that fails, then ISO8Bit.
+ * So we try UTF8 and ShiftJIS first and if that fails, then ISO8Bit,
+ * unless the charset is known in advance. Known Latin-1 is converted to
+ * UTF-8, guessed ISO8Bit is copied as is. A single value is not enough
+ * to detect the charset of the record, so MC_CHARSET_DETECT must have
+ * been resolved by the caller (see mc_record_walk_full()).
+ *
+ * If out is NULL, the value is only measured. Returns the length of the
+ * decoded value. The verbatim flag is cleared if the decoded value differs
+ * from the raw input, i.e. if it contains escapes or Shift-JIS characters.
+ * The path is the slowest decoder that has been used (for statistics).
  */
 static
-void
+gsize
 mc_record_parse_value(
     McBlock* blk,
-    GByteArray* buf,
-    gboolean url_block)
+    guint8* out,
+    MC_CHARSET charset,
+    gboolean url_block,
+    gboolean* verbatim,
+    MC_STATS_PATH* path)
 {
+    const gboolean auto_charset = (charset == MC_CHARSET_AUTO);
+    const gboolean try_utf8 = auto_charset || charset == MC_CHARSET_UTF8;
+    const gboolean try_sjis = auto_charset ||
+        charset == MC_CHARSET_SHIFT_JIS;
+    const gboolean widen = (charset == MC_CHARSET_LATIN1);
     gboolean backslash = FALSE;
-    g_byte_array_set_size(buf, 0);
+    gboolean same = TRUE;
+    gboolean sjis = FALSE;
+    guint paths = 0;
+    gsize len = 0;
+
+    g_assert(charset != MC_CHARSET_DETECT);
     while (!mc_block_end(blk)) {
-        guchar c[MAX_CHAR_SIZE];
-        gsize n = mc_block_printable_ascii_char(blk, c);
+        guchar c[MC_RECORD_MAX_CHAR_SIZE];
+        const guint8* text = blk->ptr;
+        gsize n = mc_block_skip_text(blk);
+
+        if (!n && try_utf8) {
+            /* UTF-8 is tried before anything else for non-ASCII */
+            n = mc_block_skip_utf8(blk);
+            paths |= (n ? (1 << MC_STATS_PATH_UTF8) : 0);
+        }
+        if (!n && widen) {
+            n = mc_block_widen_latin1(blk, out ? (out + len) : NULL);
+            if (n) {
+                backslash = FALSE;
+                same = FALSE;
+                paths |= (1 << MC_STATS_PATH_ISO8BIT);
+                len += n;
+                continue;
+            }
+        }
+        if (n) {
+            /* Fast path for plain text and UTF-8 */
+            if (backslash) {
+                backslash = FALSE;
+                same = FALSE;
+            }
+            if (out) {
+                memcpy(out + len, text, n);
+            }
+            len += n;
+            continue;
+        }
 
+        n = mc_block_printable_ascii_char(blk, c);
         if (!n) {
-            n = mc_block_utf8_char(blk, c);
-            if (!n) {
-                n = mc_block_shift_jis_char(blk, c);
-                if (!n) {
-                    n = mc_block_iso_8bit_char(blk, c);
-                }
+            n = try_sjis ? mc_block_shift_jis_char(blk, c) : 0;
+            if (n) {
+                same = FALSE;
+                sjis = TRUE;
+                paths |= (1 << MC_STATS_PATH_SHIFT_JIS);
+            } else if (auto_charset) {
+                n = mc_block_iso_8bit_char(blk, c);
+                paths |= (n ? (1 << MC_STATS_PATH_ISO8BIT) : 0);
             }
         }
         if (n) {
             if (backslash) {
                 backslash = FALSE;
+                same = FALSE;
+            }
+            if (out) {
+                memcpy(out + len, c, n);
+            }
+            len += n;
+            if (sjis) {
+                /* Shift-JIS characters tend to come in runs */
+                len += mc_block_shift_jis_run(blk, out ? (out + len) : NULL,
+                    try_utf8);
+                sjis = FALSE;
             }
-            g_byte_array_append(buf, c, n);
         } else {
             const char p = mc_block_peek(blk);
 
@@ -330,8 +301,14 @@ mc_record_parse_value(
                  * be illegal but people do it anyway, so let's allow it.
                  */
                 if (backslash || (p == ':' && url_block)) {
-                    backslash = FALSE;
-                    g_byte_array_append(buf, blk->ptr, 1);
+                    if (backslash) {
+                        backslash = FALSE;
+                        same = FALSE;
+                    }
+                    if (out) {
+                        out[len] = p;
+                    }
+                    len++;
                     blk->ptr++;
                     continue;
                 }
@@ -344,8 +321,85 @@ mc_record_parse_value(
         /* Unget the backslash */
         blk->ptr--;
     }
+    if (verbatim) {
+        *verbatim = same;
+    }
+    if (path) {
+        *path = (paths & (1 << MC_STATS_PATH_ISO8BIT)) ?
+            MC_STATS_PATH_ISO8BIT :
+            (paths & (1 << MC_STATS_PATH_SHIFT_JIS)) ?
+            MC_STATS_PATH_SHIFT_JIS :
+            (paths & (1 << MC_STATS_PATH_UTF8)) ?
+            MC_STATS_PATH_UTF8 :
+            MC_STATS_PATH_ASCII;
+    }
+    return len;
+}
+
+gsize
+mc_record_decode_value(
+    const McBlock* raw,
+    MC_CHARSET charset,
+    guint8* out)
+{
+    McBlock blk = *raw;
+
+    /* The only unescaped ':' that may occur in a raw value is the URL one */
+    return mc_record_parse_value(&blk, out, charset, TRUE, NULL, NULL);
+}
+
+/*
+ * Jumps over the values of a property to the ';' which terminates it
+ * (or to the end of the block), without decoding anything. A ';' is
+ * escaped if it's preceded by an odd number of backslashes.
+ *
+ * That only holds for ASCII though. A backslash byte may also be the
+ * second half of a Shift-JIS character, so if the skipped part has any
+ * non-ASCII bytes, the values are measured the same way the parser
+ * does it, to end up at the same ';' as the parser would.
+ */
+static
+void
+mc_record_skip_values(
+    McBlock* blk,
+    MC_CHARSET charset,
+    gboolean url_block)
+{
+    const guint8* start = blk->ptr;
+    const guint8* p;
+
+    while (mc_block_skip_until(blk, ';')) {
+        p = blk->ptr;
+        while (p > start && p[-1] == '\\') {
+            p--;
+        }
+        if (!((blk->ptr - p) & 1)) {
+            break;
+        }
+        blk->ptr++; /* Escaped, keep going */
+    }
+
+    for (p = start; p < blk->ptr && *p < 0x80; p++);
+    if (p < blk->ptr) {
+        blk->ptr = start;
+        for (;;) {
+            mc_record_parse_value(blk, NULL, charset, url_block, NULL,
+                NULL);
+            if (mc_block_peek(blk) == ',') {
+                blk->ptr++; /* Eat the separator */
+            } else {
+                break;
+            }
+        }
+    }
 }
 
+typedef enum mc_record_walk_result {
+    MC_RECORD_WALK_FAIL,
+    MC_RECORD_WALK_OK,
+    MC_RECORD_WALK_STOP     /* Stopped by a callback */
+} MC_RECORD_WALK_RESULT;
+
 /*
  * Property = Property-Name ":" Property-Value *("," Property-Value) ";"
  * Property-Name = 1* (ALPHA / DIGIT / "-")
@@ -355,34 +409,48 @@ mc_record_parse_value(
  * So we try UTF8 and ShiftJIS first and if that fails, then ISO8Bit.
  */
 static
-gboolean
-mc_record_parse_property(
+MC_RECORD_WALK_RESULT
+mc_record_walk_property(
     McBlock* blk,
-    GPtrArray* props,
-    GPtrArray* values,
-    GByteArray* buf)
+    MC_CHARSET charset,
+    const McRecordWalkCallbacks* cb,
+    gpointer user_data,
+    McStatsCall* stats)
 {
     const McBlock save = *blk;
 
     if (mc_block_skip_spaces(blk)) {
         McBlock name = *blk;
 
-        while (!mc_block_end(blk) && mc_block_id(*blk->ptr)) blk->ptr++;
+        mc_block_skip_id(blk);
         name.end = blk->ptr;
         if (name.end > name.ptr && mc_block_peek(blk) == ':') {
-            McProperty* prop;
             const gboolean url_block = mc_block_equals(&name, "URL");
+            MC_RECORD_PROPERTY_ACTION action;
 
             blk->ptr++; /* Eat the separator */
-            g_ptr_array_set_size(values, 0);
-            while (!mc_block_end(blk)) {
-                mc_record_parse_value(blk, buf, url_block);
-                if (buf->len > 0) {
-                    char* val = g_malloc(buf->len + 1);
-
-                    memcpy(val, buf->data, buf->len);
-                    val[buf->len] = 0;
-                    g_ptr_array_add(values, val);
+            MC_PROBE2(property, name.ptr, name.end - name.ptr);
+            action = cb->property(&name, user_data);
+            if (action == MC_RECORD_PROPERTY_STOP) {
+                return MC_RECORD_WALK_STOP;
+            } else if (action == MC_RECORD_PROPERTY_SKIP) {
+                mc_record_skip_values(blk, charset, url_block);
+            }
+            while (action == MC_RECORD_PROPERTY_VALUES &&
+                !mc_block_end(blk)) {
+                McBlock raw = *blk;
+                gboolean verbatim;
+                MC_STATS_PATH path;
+                const gsize len = mc_record_parse_value(blk, NULL,
+                    charset, url_block, &verbatim, &path);
+
+                if (len > 0) {
+                    raw.end = blk->ptr;
+                    mc_stats_value(stats, path);
+                    MC_PROBE3(value, path, len, verbatim);
+                    if (!cb->value(&raw, len, verbatim, user_data)) {
+                        return MC_RECORD_WALK_STOP;
+                    }
                 }
                 if (mc_block_peek(blk) == ',') {
                     blk->ptr++; /* Eat the separator */
@@ -390,31 +458,44 @@ mc_record_parse_property(
                     break;
                 }
             }
-            if (values->len) {
-                g_ptr_array_add(values, NULL);
-                prop = mc_property_new(name.ptr, name.end - name.ptr, (char**)
-                    values->pdata);
-            } else {
-                prop = mc_property_new(name.ptr, name.end - name.ptr, NULL);
-            }
-            g_ptr_array_add(props, prop);
-            return TRUE;
+            return cb->property_end(user_data) ?
+                MC_RECORD_WALK_OK :
+                MC_RECORD_WALK_STOP;
         }
     }
 
     /* Restore the state on failure */
     *blk = save;
-    return FALSE;
+    return MC_RECORD_WALK_FAIL;
 }
 
-McRecord*
-mc_record_parse_data(
+gboolean
+mc_record_walk(
     const void* data,
-    size_t size)
+    gsize size,
+    const McRecordWalkCallbacks* cb,
+    gpointer user_data,
+    McStatsCall* stats)
+{
+    return mc_record_walk_full(data, size, MC_CHARSET_AUTO, cb, user_data,
+        stats);
+}
+
+gboolean
+mc_record_walk_full(
+    const void* data,
+    gsize size,
+    MC_CHARSET charset,
+    const McRecordWalkCallbacks* cb,
+    gpointer user_data,
+    McStatsCall* stats)
 {
     if (data && size) {
         McBlock blk;
 
+        if (charset == MC_CHARSET_DETECT) {
+            charset = mc_record_detect_charset(data, size);
+        }
         blk.ptr = data;
         blk.end = blk.ptr + size;
         if (mc_block_skip_spaces(&blk)) {
@@ -428,33 +509,303 @@ mc_record_parse_data(
             if (mc_block_skip_until(&blk, ':')) {
                 id.end = blk.ptr++;
                 if (mc_block_strip_spaces(&id) &&
-                    mc_block_check(&id, mc_block_id)) {
-                    GPtrArray* props = g_ptr_array_new_with_free_func(g_free);
-                    GPtrArray* vals = g_ptr_array_new_with_free_func(g_free);
-                    GByteArray* buf = g_byte_array_new();
-                    McRecord* rec;
+                    mc_block_check_id(&id)) {
+                    MC_RECORD_WALK_RESULT result;
 
-                    while (mc_record_parse_property(&blk, props, vals, buf)) {
+                    if (!cb->ident(&id, user_data)) {
+                        return FALSE;
+                    }
+                    while ((result = mc_record_walk_property(&blk, charset,
+                        cb, user_data, stats)) == MC_RECORD_WALK_OK) {
                         if (mc_block_peek(&blk) == ';') {
                             blk.ptr++; /* Eat the separator */
                         } else {
                             break;
                         }
                     }
-                    mc_block_skip_spaces(&blk);
-                    if (mc_block_end(&blk) || *blk.ptr == (guchar)';') {
-                        rec = mc_record_alloc(&id, props);
-                    } else {
-                        rec = NULL;
+                    if (result != MC_RECORD_WALK_STOP) {
+                        mc_block_skip_spaces(&blk);
+                        if (mc_block_end(&blk) || *blk.ptr == (guchar)';') {
+                            return TRUE;
+                        }
+                        mc_stats_fail(stats,
+                            MC_STATS_FAIL_TRAILING_GARBAGE);
                     }
-                    g_ptr_array_free(props, TRUE);
-                    g_ptr_array_free(vals, TRUE);
-                    g_byte_array_free(buf, TRUE);
-                    return rec;
+                    return FALSE;
+                }
+                mc_stats_fail(stats, MC_STATS_FAIL_BAD_IDENT);
+                return FALSE;
+            }
+        }
+    }
+    mc_stats_fail(stats, MC_STATS_FAIL_NO_IDENT);
+    return FALSE;
+}
+
+/*
+ * The record is parsed in two passes. The first one scans the input and
+ * calculates the exact size of the block, the second one fills it in.
+ * The layout is:
+ *
+ * +---------------------------------+
+ * | McRecordPriv                    |
+ * +---------------------------------+
+ * | McProperty[n_prop]              |
+ * +---------------------------------+
+ * | NULL-terminated value arrays    |
+ * +---------------------------------+
+ * | McRecordName[n_prop]            |
+ * +---------------------------------+
+ * | Value lengths                   |
+ * +---------------------------------+
+ * | Hash buckets                    |
+ * +---------------------------------+
+ * | Identifier, names and values    |
+ * +---------------------------------+
+ *
+ * Strings are aligned at 8-byte boundary for better efficiency.
+ *
+ * The name table and the buckets form a hash table of property names.
+ * Each bucket holds the index (plus one) of the first property which
+ * hashes into it, the rest are chained in the order in which they
+ * appear in the record. The name table also locates the lengths of
+ * the values of each property in the value length table.
+ */
+
+typedef struct mc_record_name {
+    guint32 hash;
+    guint32 len;
+    guint32 next;   /* Next property in the same bucket plus one */
+    guint32 first;  /* Index of the first value length */
+    guint32 n_values;
+} McRecordName;
+
+typedef struct mc_record_priv {
+    McRecord pub;
+    gint ref_count;
+    guint32 mask;   /* Number of buckets minus one */
+    gsize size;     /* Of the whole block */
+    const McRecordName* names;
+    const gsize* lengths;
+    const guint32* buckets;
+} McRecordPriv;
+
+static inline
+McRecordPriv*
+mc_record_cast(
+    const McRecord* rec)
+{
+    return (McRecordPriv*)rec;
+}
+
+static
+guint32
+mc_record_buckets(
+    guint n_prop)
+{
+    guint32 n = 1;
+
+    /* Power of two, no less than the number of properties */
+    while (n < n_prop) {
+        n <<= 1;
+    }
+    return n;
+}
+
+static
+char*
+mc_record_copy_string(
+    char** ptr,
+    const McBlock* blk)
+{
+    char* str = *ptr;
+    const gsize len = blk->end - blk->ptr;
+
+    memcpy(str, blk->ptr, len);
+    *ptr += SIZE_ALIGN(len + 1);
+    return str;
+}
+
+McRecord*
+mc_record_build(
+    const McParser* parser,
+    McArena* arena)
+{
+    const McParserProp* src = parser->props;
+    const McParserValue* val = parser->values;
+    const guint32 n_buckets = mc_record_buckets(parser->n_props);
+    gsize total = SIZE_ALIGN(sizeof(McRecordPriv)) +
+        SIZE_ALIGN(parser->n_props * sizeof(McProperty)) +
+        SIZE_ALIGN(parser->n_props * sizeof(McRecordName)) +
+        SIZE_ALIGN(parser->n_values * sizeof(gsize)) +
+        SIZE_ALIGN(n_buckets * sizeof(guint32)) +
+        SIZE_ALIGN(parser->id.end - parser->id.ptr + 1);
+    guint n_slots = 0;
+    McRecordPriv* priv;
+    McRecord* rec;
+    McRecordName* names;
+    gsize* lengths;
+    guint32* buckets;
+    McProperty* prop;
+    const char** slot;
+    char* ptr;
+    guint i, k;
+
+    /* Calculate the size */
+    for (i = 0; i < parser->n_props; i++) {
+        const McParserProp* p = src + i;
+
+        total += SIZE_ALIGN(p->name.end - p->name.ptr + 1);
+        if (p->n_values) {
+            n_slots += p->n_values + 1;
+        }
+    }
+    for (i = 0; i < parser->n_values; i++) {
+        total += SIZE_ALIGN(val[i].len + 1);
+    }
+    total += SIZE_ALIGN(n_slots * sizeof(char*));
+
+    /* Allocate the block */
+    priv = arena ? mc_arena_alloc0(arena, total) : g_malloc0(total);
+    if (!priv) {
+        /* Fixed arena is full */
+        return NULL;
+    }
+
+    /* And fill it in */
+    priv->ref_count = arena ? MC_ARENA_REF_COUNT : 1;
+    priv->size = total;
+    rec = &priv->pub;
+    ptr = ((char*)priv) + SIZE_ALIGN(sizeof(McRecordPriv));
+    rec->prop = prop = (McProperty*)ptr;
+    rec->n_prop = parser->n_props;
+    ptr += SIZE_ALIGN(parser->n_props * sizeof(McProperty));
+    slot = (const char**)ptr;
+    ptr += SIZE_ALIGN(n_slots * sizeof(char*));
+    priv->names = names = (McRecordName*)ptr;
+    ptr += SIZE_ALIGN(parser->n_props * sizeof(McRecordName));
+    priv->lengths = lengths = (gsize*)ptr;
+    ptr += SIZE_ALIGN(parser->n_values * sizeof(gsize));
+    priv->buckets = buckets = (guint32*)ptr;
+    priv->mask = n_buckets - 1;
+    ptr += SIZE_ALIGN(n_buckets * sizeof(guint32));
+    rec->ident = mc_record_copy_string(&ptr, &parser->id);
+    for (i = 0; i < parser->n_props; i++, src++, prop++) {
+        names[i].len = src->name.end - src->name.ptr;
+        names[i].hash = mc_record_name_hash(src->name.ptr, names[i].len);
+        names[i].first = val - parser->values;
+        names[i].n_values = src->n_values;
+        prop->name = mc_record_copy_string(&ptr, &src->name);
+        if (src->n_values) {
+            prop->values = slot;
+            for (k = 0; k < src->n_values; k++, val++) {
+                *lengths++ = val->len;
+                if (val->verbatim) {
+                    memcpy(ptr, val->raw.ptr, val->len);
+                } else {
+                    mc_record_decode_value(&val->raw, parser->charset,
+                        (guint8*)ptr);
                 }
+                *slot++ = ptr;
+                ptr += SIZE_ALIGN(val->len + 1);
             }
+            *slot++ = NULL;
         }
     }
+
+    /* Going backwards keeps the chains in the original order */
+    for (i = rec->n_prop; i > 0; i--) {
+        guint32* bucket = buckets + (names[i - 1].hash & priv->mask);
+
+        names[i - 1].next = *bucket;
+        *bucket = i;
+    }
+    return rec;
+}
+
+McRecord*
+mc_record_new(
+    McParser* parser,
+    const void* data,
+    gsize size,
+    const McParseOptions* opts,
+    McArena* arena)
+{
+    McStatsCall stats;
+    McRecord* rec;
+
+    mc_stats_begin(&stats);
+    MC_PROBE2(record__start, data, size);
+    if (!parser) {
+        parser = mc_parser_default();
+    }
+    rec = mc_parser_scan(parser, data, size, opts, &stats) ?
+        mc_record_build(parser, arena) : NULL;
+    mc_parser_trim(parser);
+    mc_stats_end(&stats, MC_STATS_ENTRY_RECORD, size, rec != NULL);
+    MC_PROBE2(record__end, size, rec != NULL);
+    return rec;
+}
+
+McRecord*
+mc_record_parse_data(
+    const void* data,
+    size_t size)
+{
+    return mc_record_new(NULL, data, size, NULL, NULL);
+}
+
+MC_CHARSET
+mc_record_detect_charset(
+    const void* data,
+    size_t size)
+{
+    McBlock blk;
+    const guint8* first;
+
+    blk.ptr = data;
+    blk.end = blk.ptr + (data ? size : 0);
+    mc_block_skip_ascii(&blk);
+    first = blk.ptr;
+
+    /* Incomplete or invalid sequences stop at a byte above %x7F */
+    while (!mc_block_end(&blk) && mc_block_skip_utf8(&blk) &&
+        (mc_block_end(&blk) || blk.ptr[0] < 0x80)) {
+        mc_block_skip_ascii(&blk);
+    }
+    if (mc_block_end(&blk)) {
+        return MC_CHARSET_UTF8;
+    }
+
+    /* Every byte above %x7F must start a mapped Shift-JIS pair */
+    blk.ptr = first;
+    while (blk.end > (blk.ptr + 1) && mc_sjis_lookup(blk.ptr[0],
+        blk.ptr[1])) {
+        blk.ptr += 2;
+        mc_block_skip_ascii(&blk);
+    }
+    return mc_block_end(&blk) ? MC_CHARSET_SHIFT_JIS : MC_CHARSET_LATIN1;
+}
+
+McRecord*
+mc_record_parse_data_full(
+    const void* data,
+    size_t size,
+    const McParseOptions* opts)
+{
+    return mc_record_new(NULL, data, size, opts, NULL);
+}
+
+McRecord*
+mc_record_parse_data_arena(
+    McArena* arena,
+    const void* data,
+    size_t size)
+{
+    if (arena) {
+        mc_arena_set_needed(arena, 0);
+        return mc_record_new(NULL, data, size, NULL, arena);
+    }
     return NULL;
 }
 
@@ -465,11 +816,134 @@ mc_record_parse(
     return str ? mc_record_parse_data(str, strlen(str)) : NULL;
 }
 
+static
+const McProperty*
+mc_record_find(
+    const McRecordPriv* priv,
+    guint32 next,
+    guint32 hash,
+    gsize len,
+    const char* name)
+{
+    while (next) {
+        const guint i = next - 1;
+        const McRecordName* entry = priv->names + i;
+
+        if (entry->hash == hash && entry->len == len &&
+            !memcmp(priv->pub.prop[i].name, name, len)) {
+            return priv->pub.prop + i;
+        }
+        next = entry->next;
+    }
+    return NULL;
+}
+
+const McProperty*
+mc_record_lookup_next(
+    const McRecord* rec,
+    const McProperty* prop)
+{
+    const McRecordPriv* priv = mc_record_cast(rec);
+    const McRecordName* entry = priv->names + (prop - rec->prop);
+
+    return mc_record_find(priv, entry->next, entry->hash, entry->len,
+        prop->name);
+}
+
+const McProperty*
+mc_record_lookup(
+    const McRecord* rec,
+    const char* name)
+{
+    if (rec && name) {
+        const McRecordPriv* priv = mc_record_cast(rec);
+        const gsize len = strlen(name);
+        const guint32 hash = mc_record_name_hash((const guint8*)name, len);
+
+        return mc_record_find(priv, priv->buckets[hash & priv->mask],
+            hash, len, name);
+    }
+    return NULL;
+}
+
+unsigned int
+mc_record_lookup_all(
+    const McRecord* rec,
+    const char* name,
+    const McProperty** props,
+    unsigned int max)
+{
+    const McProperty* prop = mc_record_lookup(rec, name);
+    guint n = 0;
+
+    while (prop) {
+        if (n < max) {
+            props[n] = prop;
+        }
+        n++;
+        prop = mc_record_lookup_next(rec, prop);
+    }
+    return n;
+}
+
+const size_t*
+mc_record_value_lengths(
+    const McRecord* rec,
+    const McProperty* prop,
+    unsigned int* n_values)
+{
+    const McRecordName* entry = NULL;
+
+    if (rec && prop && prop >= rec->prop && prop < rec->prop + rec->n_prop) {
+        entry = mc_record_cast(rec)->names + (prop - rec->prop);
+    }
+    if (n_values) {
+        *n_values = entry ? entry->n_values : 0;
+    }
+    return (entry && entry->n_values) ?
+        (mc_record_cast(rec)->lengths + entry->first) : NULL;
+}
+
 void
 mc_record_free(
     McRecord* rec)
 {
-    g_free(rec);
+    mc_record_unref(rec);
+}
+
+McRecord*
+mc_record_ref(
+    McRecord* rec)
+{
+    if (rec) {
+        McRecordPriv* priv = mc_record_cast(rec);
+
+        if (g_atomic_int_get(&priv->ref_count) != MC_ARENA_REF_COUNT) {
+            g_atomic_int_inc(&priv->ref_count);
+        }
+    }
+    return rec;
+}
+
+void
+mc_record_unref(
+    McRecord* rec)
+{
+    if (rec) {
+        McRecordPriv* priv = mc_record_cast(rec);
+
+        if (g_atomic_int_get(&priv->ref_count) != MC_ARENA_REF_COUNT &&
+            g_atomic_int_dec_and_test(&priv->ref_count)) {
+            g_free(priv);
+        }
+    }
+}
+
+gsize
+mc_record_size(
+    const McRecord* rec)
+{
+    return rec ? mc_record_cast(rec)->size : 0;
 }
 
 /*
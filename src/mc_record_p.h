@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_RECORD_PRIVATE_H
+#define MC_RECORD_PRIVATE_H
+
+#include "mc_types_p.h"
+#include "mc_stats_p.h"
+#include "mc_record.h"
+
+/*
+ * Walks the DMF grammar and reports what it finds. Empty values are
+ * skipped. The raw value block covers the value exactly as it appears
+ * in the input, len is the length of the decoded value and verbatim
+ * means that the decoded value is identical to the raw one (i.e. there
+ * were no escapes and nothing had to be transcoded).
+ *
+ * Callbacks may be invoked even if the walk eventually fails. If any
+ * of them returns FALSE (or the property callback returns
+ * MC_RECORD_PROPERTY_STOP), the walk stops and fails. Malformed input
+ * and the decoders used for the values are counted in the statistics of
+ * the call (if it's not NULL).
+ *
+ * MC_RECORD_PROPERTY_SKIP jumps straight to the separator terminating
+ * the property. The values of a skipped property are neither decoded
+ * nor reported to the value callback or counted anywhere. Only those
+ * containing non-ASCII bytes are measured (and therefore validated),
+ * because in Shift-JIS a backslash byte may belong to a character.
+ *
+ * mc_record_walk() is mc_record_walk_full() with MC_CHARSET_AUTO.
+ * MC_CHARSET_DETECT is resolved for the whole record before walking.
+ */
+typedef enum mc_record_property_action {
+    MC_RECORD_PROPERTY_STOP,
+    MC_RECORD_PROPERTY_VALUES,
+    MC_RECORD_PROPERTY_SKIP
+} MC_RECORD_PROPERTY_ACTION;
+
+typedef struct mc_record_walk_callbacks {
+    gboolean (*ident)(const McBlock* id, gpointer user_data);
+    MC_RECORD_PROPERTY_ACTION (*property)(const McBlock* name,
+        gpointer user_data);
+    gboolean (*value)(const McBlock* raw, gsize len, gboolean verbatim,
+        gpointer user_data);
+    gboolean (*property_end)(gpointer user_data);
+} McRecordWalkCallbacks;
+
+gboolean
+mc_record_walk(
+    const void* data,
+    gsize size,
+    const McRecordWalkCallbacks* cb,
+    gpointer user_data,
+    McStatsCall* stats)
+    G_GNUC_INTERNAL;
+
+gboolean
+mc_record_walk_full(
+    const void* data,
+    gsize size,
+    MC_CHARSET charset,
+    const McRecordWalkCallbacks* cb,
+    gpointer user_data,
+    McStatsCall* stats)
+    G_GNUC_INTERNAL;
+
+/*
+ * Allocates the record from the arena, or from the heap if it's NULL.
+ * NULL parser means the per-thread one, NULL options mean the defaults.
+ */
+McRecord*
+mc_record_new(
+    McParser* parser,
+    const void* data,
+    gsize size,
+    const McParseOptions* opts,
+    McArena* arena)
+    G_GNUC_INTERNAL;
+
+/* Builds the record from the tables filled in by mc_parser_scan() */
+McRecord*
+mc_record_build(
+    const McParser* parser,
+    McArena* arena)
+    G_GNUC_INTERNAL;
+
+/*
+ * Decodes a single printable ASCII, Shift-JIS or ISO8Bit character into
+ * at most MC_RECORD_MAX_CHAR_SIZE bytes. UTF-8 is expected to be handled
+ * by the caller. Returns zero if the character can't be a part of the
+ * value as is (separators, backslash and control characters).
+ */
+#define MC_RECORD_MAX_CHAR_SIZE (3)
+
+gsize
+mc_record_decode_char(
+    McBlock* blk,
+    guchar* out)
+    G_GNUC_INTERNAL;
+
+/* Size of the memory block holding the record */
+gsize
+mc_record_size(
+    const McRecord* rec)
+    G_GNUC_INTERNAL;
+
+/* Next property with the same name, NULL if there's none */
+const McProperty*
+mc_record_lookup_next(
+    const McRecord* rec,
+    const McProperty* prop)
+    G_GNUC_INTERNAL;
+
+/*
+ * Decodes the raw value reported by mc_record_walk_full(). The charset
+ * must not be MC_CHARSET_DETECT, resolve it first.
+ */
+gsize
+mc_record_decode_value(
+    const McBlock* raw,
+    MC_CHARSET charset,
+    guint8* out)
+    G_GNUC_INTERNAL;
+
+/* Hash of a property name, as used by the record's name table */
+static inline
+guint32
+mc_record_name_hash(
+    const void* name,
+    gsize len)
+{
+    const guint8* ptr = name;
+    guint32 hash = 5381;
+
+    while (len--) {
+        hash = (hash << 5) + hash + *ptr++;
+    }
+    return hash;
+}
+
+#endif /* MC_RECORD_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
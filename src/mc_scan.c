@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_record_p.h"
+#include "mc_stats_p.h"
+#include "mc_scan.h"
+
+/* Scan */
+
+typedef struct mc_scan {
+    const McScanCallbacks* cb;
+    void* user_data;
+} McScan;
+
+static
+gboolean
+mc_scan_ident(
+    const McBlock* id,
+    gpointer user_data)
+{
+    const McScan* scan = user_data;
+
+    return !scan->cb->on_ident || scan->cb->on_ident((const char*)id->ptr,
+        id->end - id->ptr, scan->user_data);
+}
+
+static
+MC_RECORD_PROPERTY_ACTION
+mc_scan_property(
+    const McBlock* name,
+    gpointer user_data)
+{
+    const McScan* scan = user_data;
+
+    return (!scan->cb->on_property_begin ||
+        scan->cb->on_property_begin((const char*)name->ptr,
+            name->end - name->ptr, scan->user_data)) ?
+        MC_RECORD_PROPERTY_VALUES : MC_RECORD_PROPERTY_STOP;
+}
+
+static
+gboolean
+mc_scan_value(
+    const McBlock* raw,
+    gsize len,
+    gboolean verbatim,
+    gpointer user_data)
+{
+    const McScan* scan = user_data;
+
+    return !scan->cb->on_value || scan->cb->on_value((const char*)raw->ptr,
+        raw->end - raw->ptr, !verbatim, scan->user_data);
+}
+
+static
+gboolean
+mc_scan_property_end(
+    gpointer user_data)
+{
+    const McScan* scan = user_data;
+
+    return !scan->cb->on_property_end ||
+        scan->cb->on_property_end(scan->user_data);
+}
+
+int
+mc_record_scan(
+    const void* data,
+    size_t size,
+    const McScanCallbacks* cb,
+    void* user_data)
+{
+    static const McScanCallbacks no_cb = { NULL, NULL, NULL, NULL };
+    static const McRecordWalkCallbacks walk_cb = {
+        mc_scan_ident,
+        mc_scan_property,
+        mc_scan_value,
+        mc_scan_property_end
+    };
+    McStatsCall stats;
+    McScan scan;
+    gboolean ok;
+
+    /* No callbacks at all is a way to validate the data */
+    mc_stats_begin(&stats);
+    scan.cb = cb ? cb : &no_cb;
+    scan.user_data = user_data;
+    ok = mc_record_walk(data, size, &walk_cb, &scan, &stats);
+    mc_stats_end(&stats, MC_STATS_ENTRY_SCAN, size, ok);
+    return ok;
+}
+
+/* Extract */
+
+typedef struct mc_scan_extract {
+    const char* name;
+    char* buf;
+    gsize size;
+    gsize len;
+    gboolean match;
+} McScanExtract;
+
+static
+gboolean
+mc_scan_extract_ident(
+    const McBlock* id,
+    gpointer user_data)
+{
+    return TRUE;
+}
+
+static
+MC_RECORD_PROPERTY_ACTION
+mc_scan_extract_property(
+    const McBlock* name,
+    gpointer user_data)
+{
+    McScanExtract* extract = user_data;
+
+    /* Values of other properties are skipped without being decoded */
+    extract->match = mc_block_equals(name, extract->name);
+    return extract->match ? MC_RECORD_PROPERTY_VALUES :
+        MC_RECORD_PROPERTY_SKIP;
+}
+
+static
+gboolean
+mc_scan_extract_value(
+    const McBlock* raw,
+    gsize len,
+    gboolean verbatim,
+    gpointer user_data)
+{
+    McScanExtract* extract = user_data;
+
+    if (extract->match) {
+        extract->len = len;
+        if (extract->buf && len < extract->size) {
+            if (verbatim) {
+                memcpy(extract->buf, raw->ptr, len);
+            } else {
+                mc_record_decode_value(raw, MC_CHARSET_AUTO,
+                    (guint8*)extract->buf);
+            }
+            extract->buf[len] = 0;
+        }
+        /* Found it, stop the walk */
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static
+gboolean
+mc_scan_extract_property_end(
+    gpointer user_data)
+{
+    return TRUE;
+}
+
+size_t
+mc_extract_value(
+    const void* data,
+    size_t size,
+    const char* name,
+    char* out_buf,
+    size_t out_len)
+{
+    if (name) {
+        static const McRecordWalkCallbacks walk_cb = {
+            mc_scan_extract_ident,
+            mc_scan_extract_property,
+            mc_scan_extract_value,
+            mc_scan_extract_property_end
+        };
+        McScanExtract extract;
+
+        memset(&extract, 0, sizeof(extract));
+        extract.name = name;
+        extract.buf = out_buf;
+        extract.size = out_len;
+        /* Not an entry point for the statistics */
+        mc_record_walk(data, size, &walk_cb, &extract, NULL);
+        return extract.len;
+    }
+    return 0;
+}
+
+/* Unescape */
+
+size_t
+mc_scan_unescape(
+    const char* ptr,
+    size_t len,
+    char* buf,
+    size_t size)
+{
+    if (ptr && len) {
+        McBlock raw;
+        gsize n;
+
+        raw.ptr = (const guint8*)ptr;
+        raw.end = raw.ptr + len;
+        n = mc_record_decode_value(&raw, MC_CHARSET_AUTO, NULL);
+        if (buf && n <= size) {
+            mc_record_decode_value(&raw, MC_CHARSET_AUTO, (guint8*)buf);
+        }
+        return n;
+    }
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,459 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_arena_p.h"
+#include "mc_parser_p.h"
+#include "mc_probe_p.h"
+#include "mc_record_p.h"
+#include "mc_schema_p.h"
+#include "mc_stats_p.h"
+
+typedef struct mc_schema_walk {
+    const McSchema* schema;
+    McParser* parser;
+    McStatsCall* stats;
+    gboolean known;     /* Current property is one of the fields */
+} McSchemaWalk;
+
+static inline
+guint32
+mc_schema_hash(
+    const guint8* name,
+    gsize len,
+    guint32 seed)
+{
+    guint32 h = seed ^ (guint32)len;
+
+    while (len--) {
+        h = (h ^ *name++) * 0x01000193;
+    }
+    return h ^ (h >> 15);
+}
+
+static
+void
+mc_schema_index_init(
+    McSchema* schema)
+{
+    McSchemaIndex* index = &schema->index;
+    guint32 size = 1;
+    guint32 seed;
+    guint i;
+
+    g_assert(schema->n_fields <= MC_SCHEMA_MAX_FIELDS);
+    while (size < 2 * schema->n_fields) {
+        size <<= 1;
+    }
+
+    /* Keep trying until there are no collisions */
+    for (seed = 0;; seed++) {
+        memset(index->slot, 0, sizeof(index->slot));
+        for (i = 0; i < schema->n_fields; i++) {
+            const char* name = schema->fields[i].name;
+            const guint32 h = mc_schema_hash((const guint8*)name,
+                strlen(name), seed) & (size - 1);
+
+            if (index->slot[h]) {
+                break;
+            }
+            index->slot[h] = i + 1;
+        }
+        if (i == schema->n_fields) {
+            break;
+        }
+    }
+    index->seed = seed;
+    index->mask = size - 1;
+}
+
+static
+const McSchemaIndex*
+mc_schema_index(
+    McSchema* schema)
+{
+    if (g_once_init_enter(&schema->index_ready)) {
+        mc_schema_index_init(schema);
+        g_once_init_leave(&schema->index_ready, 1);
+    }
+    return &schema->index;
+}
+
+/* Returns the field index + 1, zero if there's no such field */
+static
+guint
+mc_schema_lookup(
+    const McSchema* schema,
+    const McBlock* name)
+{
+    const McSchemaIndex* index = &schema->index;
+    const guint slot = index->slot[mc_schema_hash(name->ptr,
+        name->end - name->ptr, index->seed) & index->mask];
+
+    return (slot && mc_block_equals(name, schema->fields[slot - 1].name)) ?
+        slot : 0;
+}
+
+static
+gboolean
+mc_schema_walk_ident(
+    const McBlock* id,
+    gpointer user_data)
+{
+    McSchemaWalk* walk = user_data;
+
+    if (mc_block_equals(id, walk->schema->ident)) {
+        return TRUE;
+    }
+    mc_stats_fail(walk->stats, MC_STATS_FAIL_WRONG_IDENT);
+    return FALSE;
+}
+
+static
+MC_RECORD_PROPERTY_ACTION
+mc_schema_walk_property(
+    const McBlock* name,
+    gpointer user_data)
+{
+    McSchemaWalk* walk = user_data;
+    const guint slot = mc_schema_lookup(walk->schema, name);
+
+    if (slot) {
+        mc_parser_add_property(walk->parser, name)->tag = slot - 1;
+        walk->known = TRUE;
+    }
+    /* Unknown properties are still validated */
+    return MC_RECORD_PROPERTY_VALUES;
+}
+
+static
+gboolean
+mc_schema_walk_value(
+    const McBlock* raw,
+    gsize len,
+    gboolean verbatim,
+    gpointer user_data)
+{
+    McSchemaWalk* walk = user_data;
+
+    if (walk->known) {
+        mc_parser_add_value(walk->parser, raw, len, verbatim);
+    }
+    return TRUE;
+}
+
+static
+gboolean
+mc_schema_walk_property_end(
+    gpointer user_data)
+{
+    McSchemaWalk* walk = user_data;
+
+    walk->known = FALSE;
+    return TRUE;
+}
+
+/* Space taken by the values joined with commas, including the NUL */
+static
+gsize
+mc_schema_values_size(
+    const McParserValue* val,
+    guint n)
+{
+    gsize len = n;
+    guint k;
+
+    for (k = 0; k < n; k++) {
+        len += val[k].len;
+    }
+    return SIZE_ALIGN(len);
+}
+
+/* The memory is zeroed, the NUL terminator is already there */
+static
+const char*
+mc_schema_copy_values(
+    char** ptr,
+    const McParserValue* val,
+    guint n)
+{
+    char* str = *ptr;
+    gsize len = 0;
+    guint k;
+
+    for (k = 0; k < n; k++, val++) {
+        if (k) {
+            str[len++] = ',';
+        }
+        if (val->verbatim) {
+            memcpy(str + len, val->raw.ptr, val->len);
+        } else {
+            mc_record_decode_value(&val->raw, MC_CHARSET_AUTO,
+                (guint8*)str + len);
+        }
+        len += val->len;
+    }
+    *ptr += SIZE_ALIGN(len + 1);
+    return str;
+}
+
+static
+gpointer
+mc_schema_build(
+    const McSchema* schema,
+    const McParser* parser,
+    McArena* arena)
+{
+    const McParserValue* first[MC_SCHEMA_MAX_FIELDS];
+    const char** list[MC_SCHEMA_MAX_FIELDS];
+    guint count[MC_SCHEMA_MAX_FIELDS];
+    guint n_first[MC_SCHEMA_MAX_FIELDS];
+    const McParserValue* val = parser->values;
+    const McParserProp* prop = parser->props;
+    gsize total = SIZE_ALIGN(sizeof(McSchemaHeader)) +
+        SIZE_ALIGN(schema->size);
+    McSchemaHeader* header;
+    guint8* obj;
+    char* ptr;
+    guint i, k;
+
+    /* Calculate the size */
+    memset(first, 0, sizeof(first[0]) * schema->n_fields);
+    memset(count, 0, sizeof(count[0]) * schema->n_fields);
+    for (i = 0; i < parser->n_props; i++, prop++) {
+        const guint tag = prop->tag;
+
+        if (schema->fields[tag].type != MC_SCHEMA_FIELD_SINGLE) {
+            count[tag] += prop->n_values;
+            for (k = 0; k < prop->n_values; k++) {
+                total += mc_schema_values_size(val + k, 1);
+            }
+        } else if (!first[tag] && prop->n_values) {
+            first[tag] = val;
+            n_first[tag] = prop->n_values;
+            total += mc_schema_values_size(val, prop->n_values);
+        }
+        val += prop->n_values;
+    }
+    for (k = 0; k < schema->n_fields; k++) {
+        if (count[k]) {
+            total += SIZE_ALIGN((count[k] + 1) * sizeof(char*));
+        }
+    }
+
+    /* Allocate the block */
+    header = arena ? mc_arena_alloc0(arena, total) : g_malloc0(total);
+    if (!header) {
+        /* Fixed arena is full */
+        return NULL;
+    }
+    header->ref_count = arena ? MC_ARENA_REF_COUNT : 1;
+    header->size = total;
+    obj = (guint8*)header + SIZE_ALIGN(sizeof(McSchemaHeader));
+
+    /* Value lists go first, then the strings */
+    ptr = (char*)obj + SIZE_ALIGN(schema->size);
+    for (k = 0; k < schema->n_fields; k++) {
+        if (count[k]) {
+            list[k] = (const char**)ptr;
+            G_STRUCT_MEMBER(gconstpointer, obj, schema->fields[k].offset) =
+                list[k];
+            ptr += SIZE_ALIGN((count[k] + 1) * sizeof(char*));
+        } else if (first[k]) {
+            G_STRUCT_MEMBER(const char*, obj, schema->fields[k].offset) =
+                mc_schema_copy_values(&ptr, first[k], n_first[k]);
+        }
+    }
+    val = parser->values;
+    prop = parser->props;
+    for (i = 0; i < parser->n_props; i++, prop++) {
+        const guint tag = prop->tag;
+
+        if (schema->fields[tag].type != MC_SCHEMA_FIELD_SINGLE) {
+            for (k = 0; k < prop->n_values; k++) {
+                *list[tag]++ = mc_schema_copy_values(&ptr, val + k, 1);
+            }
+        }
+        val += prop->n_values;
+    }
+    return obj;
+}
+
+gpointer
+mc_schema_parse(
+    McSchema* schema,
+    const void* data,
+    gsize size,
+    McArena* arena)
+{
+    const gsize id_len = strlen(schema->ident);
+    McStatsCall stats;
+    gpointer obj = NULL;
+    McBlock blk;
+
+    mc_stats_begin(&stats);
+    MC_PROBE2(schema__start, schema->ident, size);
+    blk.ptr = data;
+    blk.end = blk.ptr + (data ? size : 0);
+
+    /* Quick check to see if it makes sense to parse the whole thing */
+    if (mc_block_skip_spaces(&blk) && (gsize)(blk.end - blk.ptr) > id_len &&
+        !memcmp(blk.ptr, schema->ident, id_len)) {
+        static const McRecordWalkCallbacks schema_cb = {
+            mc_schema_walk_ident,
+            mc_schema_walk_property,
+            mc_schema_walk_value,
+            mc_schema_walk_property_end
+        };
+        McSchemaWalk walk;
+
+        walk.schema = schema;
+        walk.parser = mc_parser_default();
+        walk.stats = &stats;
+        walk.parser->n_props = 0;
+        walk.parser->n_values = 0;
+        walk.known = FALSE;
+        mc_schema_index(schema);
+        if (mc_record_walk(blk.ptr, blk.end - blk.ptr, &schema_cb, &walk,
+            &stats)) {
+            obj = mc_schema_build(schema, walk.parser, arena);
+        }
+        mc_parser_trim(walk.parser);
+    } else if (stats.start) {
+        /* Something else or nothing at all? */
+        mc_stats_fail(&stats, (!mc_block_end(&blk) &&
+            memchr(blk.ptr, ':', blk.end - blk.ptr)) ?
+            MC_STATS_FAIL_WRONG_IDENT : MC_STATS_FAIL_NO_IDENT);
+    }
+    mc_stats_end(&stats, schema->entry, size, obj != NULL);
+    MC_PROBE2(schema__end, schema->ident, obj != NULL);
+    return obj;
+}
+
+static inline
+McSchemaHeader*
+mc_schema_header(
+    gconstpointer obj)
+{
+    return (McSchemaHeader*)((guint8*)obj -
+        SIZE_ALIGN(sizeof(McSchemaHeader)));
+}
+
+gpointer
+mc_schema_ref(
+    gpointer obj)
+{
+    if (obj) {
+        McSchemaHeader* header = mc_schema_header(obj);
+
+        if (g_atomic_int_get(&header->ref_count) != MC_ARENA_REF_COUNT) {
+            g_atomic_int_inc(&header->ref_count);
+        }
+    }
+    return obj;
+}
+
+void
+mc_schema_unref(
+    gpointer obj)
+{
+    if (obj) {
+        McSchemaHeader* header = mc_schema_header(obj);
+
+        if (g_atomic_int_get(&header->ref_count) != MC_ARENA_REF_COUNT &&
+            g_atomic_int_dec_and_test(&header->ref_count)) {
+            g_free(header);
+        }
+    }
+}
+
+gsize
+mc_schema_size(
+    gconstpointer obj)
+{
+    return obj ? mc_schema_header(obj)->size : 0;
+}
+
+void
+mc_schema_encode(
+    McEncoder* enc,
+    const McSchema* schema,
+    gconstpointer obj)
+{
+    if (obj) {
+        guint k;
+
+        mc_encoder_ident(enc, schema->ident);
+        for (k = 0; k < schema->n_fields && !enc->bad; k++) {
+            const McSchemaField* field = schema->fields + k;
+            const McStr* list;
+            McStr values[2];
+
+            values[1] = NULL;
+            switch (field->type) {
+            case MC_SCHEMA_FIELD_SINGLE:
+                values[0] = G_STRUCT_MEMBER(McStr, obj, field->offset);
+                if (values[0]) {
+                    mc_encoder_property(enc, field->name, values);
+                }
+                break;
+            case MC_SCHEMA_FIELD_LIST:
+                list = G_STRUCT_MEMBER(const McStr*, obj, field->offset);
+                if (list) {
+                    mc_encoder_property(enc, field->name, list);
+                }
+                break;
+            case MC_SCHEMA_FIELD_MULTI:
+                list = G_STRUCT_MEMBER(const McStr*, obj, field->offset);
+                while (list && *list) {
+                    values[0] = *list++;
+                    mc_encoder_property(enc, field->name, values);
+                }
+                break;
+            }
+        }
+        mc_encoder_end(enc);
+    } else {
+        enc->bad = TRUE;
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
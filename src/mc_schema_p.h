@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_SCHEMA_PRIVATE_H
+#define MC_SCHEMA_PRIVATE_H
+
+#include "mc_encode_p.h"
+#include "mc_stats.h"
+
+/*
+ * Static description of a typed record. Each field is a pointer member
+ * of the typed structure. Single-value fields (const char*) receive the
+ * values of the first matching property which has any, joined with
+ * commas (free text often has unescaped commas in it), multi-value
+ * fields (const McStr*) receive NULL-terminated lists combining all
+ * matching properties in the order they appear in the record. Unknown
+ * properties are ignored. List fields are parsed the same way as
+ * multi-value ones but get encoded as a single property with all the
+ * values (e.g. the name components), rather than a property per value.
+ *
+ * The field names are dispatched by a perfect hash which is built on
+ * the first use of the schema.
+ */
+
+#define MC_SCHEMA_MAX_FIELDS (16)
+
+typedef enum mc_schema_field_type {
+    MC_SCHEMA_FIELD_SINGLE,
+    MC_SCHEMA_FIELD_MULTI,
+    MC_SCHEMA_FIELD_LIST
+} MC_SCHEMA_FIELD_TYPE;
+
+typedef struct mc_schema_field {
+    const char* name;
+    glong offset;
+    MC_SCHEMA_FIELD_TYPE type;
+} McSchemaField;
+
+typedef struct mc_schema_index {
+    guint32 seed;
+    guint32 mask;
+    guint8 slot[2 * MC_SCHEMA_MAX_FIELDS];  /* Field index + 1 */
+} McSchemaIndex;
+
+typedef struct mc_schema {
+    const char* ident;
+    gsize size;
+    const McSchemaField* fields;
+    guint n_fields;
+    MC_STATS_ENTRY entry;
+    gsize index_ready;
+    McSchemaIndex index;
+} McSchema;
+
+/*
+ * Typed structures are reference counted. The header precedes the
+ * structure in the same memory block, size is the size of the block.
+ */
+typedef struct mc_schema_header {
+    gint ref_count;
+    guint32 size;
+} McSchemaHeader;
+
+#define MC_SCHEMA_FIELD(type,member,name,field_type) \
+    { name, G_STRUCT_OFFSET(type,member), MC_SCHEMA_FIELD_##field_type }
+#define MC_SCHEMA(ident,type,fields,entry) \
+    { ident, sizeof(type), fields, G_N_ELEMENTS(fields), \
+      MC_STATS_ENTRY_##entry, 0, { 0, 0, { 0 } } }
+
+/*
+ * Allocates the typed structure from the arena, or from the heap if
+ * it's NULL. The whole thing is a single allocation, released by
+ * mc_schema_unref() unless it's allocated from the arena.
+ */
+gpointer
+mc_schema_parse(
+    McSchema* schema,
+    const void* data,
+    gsize size,
+    McArena* arena)
+    G_GNUC_INTERNAL;
+
+gpointer
+mc_schema_ref(
+    gpointer obj)
+    G_GNUC_INTERNAL;
+
+void
+mc_schema_unref(
+    gpointer obj)
+    G_GNUC_INTERNAL;
+
+/* Size of the memory block */
+gsize
+mc_schema_size(
+    gconstpointer obj)
+    G_GNUC_INTERNAL;
+
+/* Encodes the typed structure, see mc_encode() */
+void
+mc_schema_encode(
+    McEncoder* enc,
+    const McSchema* schema,
+    gconstpointer obj)
+    G_GNUC_INTERNAL;
+
+#endif /* MC_SCHEMA_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
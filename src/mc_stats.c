@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_stats_p.h"
+
+#include <time.h>
+
+/*
+ * Each thread has its own set of counters (a shard), so that updating
+ * them requires no synchronization. The owner is the only writer, but
+ * the counters are read by other threads, so all accesses are atomic
+ * (relaxed, nothing is ordered by them). Resetting doesn't touch the
+ * counters, since the owner could write an old total back right over
+ * the zero. Instead, it remembers their current values as the base
+ * which gets subtracted from them afterwards. The mutex protects the
+ * list of shards, their bases and the totals left behind by the
+ * threads which have exited.
+ */
+
+typedef struct mc_stats_shard {
+    McStats stats;
+    McStats base;
+    struct mc_stats_shard* next;
+} McStatsShard;
+
+static void mc_stats_shard_free(gpointer data);
+
+gint mc_stats_active = FALSE;
+static GMutex mc_stats_mutex;
+static McStatsShard* mc_stats_shards = NULL;
+static McStats mc_stats_retired;
+static GPrivate mc_stats_private = G_PRIVATE_INIT(mc_stats_shard_free);
+
+#define mc_stats_load(p) __atomic_load_n(p, __ATOMIC_RELAXED)
+#define mc_stats_store(p,v) __atomic_store_n(p, v, __ATOMIC_RELAXED)
+
+/* Only called by the owner of the counter */
+static inline
+void
+mc_stats_inc(
+    guint64* counter,
+    guint64 n)
+{
+    mc_stats_store(counter, mc_stats_load(counter) + n);
+}
+
+/* Adds what the shard has counted since the last reset */
+static
+void
+mc_stats_add(
+    McStats* dest,
+    const McStatsShard* shard)
+{
+    /* It's all uint64_t */
+    uint64_t* d = (uint64_t*)dest;
+    const uint64_t* s = (const uint64_t*)&shard->stats;
+    const uint64_t* b = (const uint64_t*)&shard->base;
+    guint i;
+
+    for (i = 0; i < sizeof(McStats)/sizeof(uint64_t); i++) {
+        d[i] += mc_stats_load(s + i) - b[i];
+    }
+}
+
+static
+void
+mc_stats_rebase(
+    McStatsShard* shard)
+{
+    const uint64_t* s = (const uint64_t*)&shard->stats;
+    uint64_t* b = (uint64_t*)&shard->base;
+    guint i;
+
+    for (i = 0; i < sizeof(McStats)/sizeof(uint64_t); i++) {
+        b[i] = mc_stats_load(s + i);
+    }
+}
+
+static
+void
+mc_stats_shard_free(
+    gpointer data)
+{
+    McStatsShard* shard = data;
+    McStatsShard** ptr;
+
+    g_mutex_lock(&mc_stats_mutex);
+    for (ptr = &mc_stats_shards; *ptr; ptr = &(*ptr)->next) {
+        if (*ptr == shard) {
+            *ptr = shard->next;
+            break;
+        }
+    }
+    mc_stats_add(&mc_stats_retired, shard);
+    g_mutex_unlock(&mc_stats_mutex);
+    g_free(shard);
+}
+
+McStats*
+mc_stats_shard(
+    void)
+{
+    McStatsShard* shard = g_private_get(&mc_stats_private);
+
+    if (G_UNLIKELY(!shard)) {
+        shard = g_new0(McStatsShard, 1);
+        g_mutex_lock(&mc_stats_mutex);
+        shard->next = mc_stats_shards;
+        mc_stats_shards = shard;
+        g_mutex_unlock(&mc_stats_mutex);
+        g_private_set(&mc_stats_private, shard);
+    }
+    return &shard->stats;
+}
+
+gint64
+mc_stats_clock(
+    void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (gint64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void
+mc_stats_finish(
+    const McStatsCall* call,
+    MC_STATS_ENTRY entry,
+    gsize bytes,
+    gboolean ok)
+{
+    McStats* stats = mc_stats_shard();
+    const guint64 ns = mc_stats_clock() - call->start;
+    guint bucket = 0;
+    guint i;
+
+    while (bucket < (MC_STATS_LATENCY_BUCKETS - 1) &&
+        (ns >> (bucket + 1))) {
+        bucket++;
+    }
+    mc_stats_inc(&stats->latency[entry][bucket], 1);
+    mc_stats_inc(&stats->bytes, bytes);
+    if (ok) {
+        mc_stats_inc(&stats->records, 1);
+    }
+    if (call->failure != MC_STATS_FAIL_COUNT) {
+        mc_stats_inc(&stats->failures[call->failure], 1);
+    }
+    for (i = 0; i < MC_STATS_PATH_COUNT; i++) {
+        if (call->values[i]) {
+            mc_stats_inc(&stats->values[i], call->values[i]);
+        }
+    }
+}
+
+void
+mc_stats_enable(
+    int enable)
+{
+    g_atomic_int_set(&mc_stats_active, enable != 0);
+}
+
+int
+mc_stats_enabled(
+    void)
+{
+    return g_atomic_int_get(&mc_stats_active);
+}
+
+void
+mc_stats_get(
+    McStats* stats)
+{
+    if (stats) {
+        const McStatsShard* shard;
+
+        g_mutex_lock(&mc_stats_mutex);
+        *stats = mc_stats_retired;
+        for (shard = mc_stats_shards; shard; shard = shard->next) {
+            mc_stats_add(stats, shard);
+        }
+        g_mutex_unlock(&mc_stats_mutex);
+    }
+}
+
+void
+mc_stats_reset(
+    void)
+{
+    McStatsShard* shard;
+
+    g_mutex_lock(&mc_stats_mutex);
+    memset(&mc_stats_retired, 0, sizeof(mc_stats_retired));
+    for (shard = mc_stats_shards; shard; shard = shard->next) {
+        mc_stats_rebase(shard);
+    }
+    g_mutex_unlock(&mc_stats_mutex);
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
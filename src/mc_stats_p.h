@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef MC_STATS_PRIVATE_H
+#define MC_STATS_PRIVATE_H
+
+#include "mc_types_p.h"
+#include "mc_stats.h"
+
+/*
+ * The flag is checked before anything else is done, so that disabled
+ * statistics only cost a predictable branch.
+ */
+extern gint mc_stats_active G_GNUC_INTERNAL;
+
+#define MC_STATS_ACTIVE() G_UNLIKELY(g_atomic_int_get(&mc_stats_active))
+
+/*
+ * Counters of a single call to one of the entry points. The code below
+ * the entry points (the walker, the parser and such) only updates those,
+ * they get added to the shard by mc_stats_end() together with the call
+ * itself. That way failures and values are only counted for the calls
+ * which are, and always add up to the per-entry numbers.
+ */
+typedef struct mc_stats_call {
+    gint64 start;               /* Zero if the call isn't measured */
+    MC_STATS_FAILURE failure;   /* MC_STATS_FAIL_COUNT if none */
+    guint values[MC_STATS_PATH_COUNT];
+} McStatsCall;
+
+/* Counters of the calling thread */
+McStats*
+mc_stats_shard(
+    void)
+    G_GNUC_INTERNAL;
+
+/* Monotonic time in nanoseconds */
+gint64
+mc_stats_clock(
+    void)
+    G_GNUC_INTERNAL;
+
+void
+mc_stats_finish(
+    const McStatsCall* call,
+    MC_STATS_ENTRY entry,
+    gsize bytes,
+    gboolean ok)
+    G_GNUC_INTERNAL;
+
+static inline
+void
+mc_stats_begin(
+    McStatsCall* call)
+{
+    call->start = MC_STATS_ACTIVE() ? mc_stats_clock() : 0;
+    if (G_UNLIKELY(call->start)) {
+        call->failure = MC_STATS_FAIL_COUNT;
+        memset(call->values, 0, sizeof(call->values));
+    }
+}
+
+static inline
+void
+mc_stats_end(
+    const McStatsCall* call,
+    MC_STATS_ENTRY entry,
+    gsize bytes,
+    gboolean ok)
+{
+    if (G_UNLIKELY(call->start)) {
+        mc_stats_finish(call, entry, bytes, ok);
+    }
+}
+
+/* NULL call (not made through an entry point) is ignored */
+static inline
+void
+mc_stats_fail(
+    McStatsCall* call,
+    MC_STATS_FAILURE reason)
+{
+    if (call && G_UNLIKELY(call->start) &&
+        call->failure == MC_STATS_FAIL_COUNT) {
+        call->failure = reason;
+    }
+}
+
+static inline
+void
+mc_stats_value(
+    McStatsCall* call,
+    MC_STATS_PATH path)
+{
+    if (call && G_UNLIKELY(call->start)) {
+        call->values[path]++;
+    }
+}
+
+#endif /* MC_STATS_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
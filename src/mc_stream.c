@@ -0,0 +1,466 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_parser_p.h"
+#include "mc_record_p.h"
+#include "mc_stream.h"
+
+/*
+ * The same grammar as the one implemented by mc_record_walk(), turned
+ * into a state machine. Only the decoded identifier, names and values
+ * are kept, the input is consumed as it arrives. The only exception is
+ * a few trailing bytes which may need more data to decide what they
+ * are (e.g. a partial UTF-8 sequence or a Shift-JIS lead byte).
+ */
+
+typedef enum mc_record_stream_state {
+    MC_STREAM_START,        /* Spaces before the identifier */
+    MC_STREAM_IDENT,        /* Identifier */
+    MC_STREAM_IDENT_END,    /* Spaces between the identifier and ':' */
+    MC_STREAM_PROPERTY,     /* Spaces before the property name */
+    MC_STREAM_NAME,         /* Property name */
+    MC_STREAM_VALUE,        /* Property value */
+    MC_STREAM_TRAILER,      /* Spaces after the last property */
+    MC_STREAM_DONE,         /* The record is complete */
+    MC_STREAM_ERROR         /* The data can't be parsed */
+} MC_STREAM_STATE;
+
+/* Undecided bytes never exceed an incomplete UTF-8 sequence */
+#define MC_STREAM_TAIL_SIZE (4)
+#define MC_STREAM_LOOKAHEAD (8)
+
+typedef struct mc_record_stream_prop {
+    gsize name_off;
+    gsize name_len;
+    guint n_values;
+} McRecordStreamProp;
+
+typedef struct mc_record_stream_value {
+    gsize off;
+    gsize len;
+} McRecordStreamValue;
+
+struct mc_record_stream {
+    MC_STREAM_STATE state;
+    gboolean url_block;
+    gboolean backslash;
+    guint tail_len;
+    guint8 tail[MC_STREAM_TAIL_SIZE];
+    gsize id_len;
+    gsize name_off;
+    gsize value_off;
+    GByteArray* buf;   /* Identifier, names and decoded values */
+    GArray* props;     /* McRecordStreamProp */
+    GArray* values;    /* McRecordStreamValue */
+};
+
+static
+void
+mc_record_stream_reset(
+    McRecordStream* stream)
+{
+    stream->state = MC_STREAM_START;
+    stream->url_block = FALSE;
+    stream->backslash = FALSE;
+    stream->tail_len = 0;
+    stream->id_len = 0;
+    stream->name_off = 0;
+    stream->value_off = 0;
+    g_byte_array_set_size(stream->buf, 0);
+    g_array_set_size(stream->props, 0);
+    g_array_set_size(stream->values, 0);
+}
+
+static
+void
+mc_record_stream_property(
+    McRecordStream* stream)
+{
+    McRecordStreamProp prop;
+    McBlock name;
+
+    prop.name_off = stream->name_off;
+    prop.name_len = stream->buf->len - stream->name_off;
+    prop.n_values = 0;
+    g_array_append_val(stream->props, prop);
+
+    name.ptr = stream->buf->data + prop.name_off;
+    name.end = name.ptr + prop.name_len;
+    stream->url_block = mc_block_equals(&name, "URL");
+    stream->value_off = stream->buf->len;
+}
+
+static
+void
+mc_record_stream_value_end(
+    McRecordStream* stream)
+{
+    const gsize len = stream->buf->len - stream->value_off;
+
+    /* Empty values are skipped */
+    if (len) {
+        McRecordStreamValue value;
+
+        value.off = stream->value_off;
+        value.len = len;
+        g_array_append_val(stream->values, value);
+        g_array_index(stream->props, McRecordStreamProp,
+            stream->props->len - 1).n_values++;
+    }
+    stream->value_off = stream->buf->len;
+}
+
+/*
+ * Same as mc_record_parse_value() but stops if it's not clear yet
+ * what the remaining bytes are, unless it's the last chunk. Returns
+ * TRUE if it has stopped at the character terminating the value.
+ */
+static
+gboolean
+mc_record_stream_value(
+    McRecordStream* stream,
+    McBlock* blk,
+    gboolean last)
+{
+    GByteArray* buf = stream->buf;
+
+    while (!mc_block_end(blk)) {
+        const guint8* start = blk->ptr;
+        guchar c[MC_RECORD_MAX_CHAR_SIZE];
+        gsize n = mc_block_skip_text(blk);
+
+        if (!n) {
+            n = mc_block_skip_utf8(blk);
+        }
+        if (n) {
+            stream->backslash = FALSE;
+            g_byte_array_append(buf, start, n);
+            continue;
+        }
+
+        if (*start >= 0x80 && !last && ((start + 1) == blk->end ||
+            mc_block_utf8_incomplete(blk))) {
+            /* Need more data */
+            return FALSE;
+        }
+
+        n = mc_record_decode_char(blk, c);
+        if (n) {
+            stream->backslash = FALSE;
+            g_byte_array_append(buf, c, n);
+        } else {
+            const guint8 p = *start;
+
+            if (p == '\\' && !stream->backslash) {
+                stream->backslash = TRUE;
+                blk->ptr++;
+            } else if (stream->backslash ?
+                (p == '\\' || p == ',' || p == ';' || p == ':') :
+                (p == ':' && stream->url_block)) {
+                stream->backslash = FALSE;
+                g_byte_array_append(buf, &p, 1);
+                blk->ptr++;
+            } else {
+                return TRUE;
+            }
+        }
+    }
+    return FALSE;
+}
+
+/* Consumes the block unless it ends with undecided bytes */
+static
+void
+mc_record_stream_run(
+    McRecordStream* stream,
+    McBlock* blk,
+    gboolean last)
+{
+    GByteArray* buf = stream->buf;
+
+    while (!mc_block_end(blk)) {
+        const guint8* start = blk->ptr;
+
+        switch (stream->state) {
+        case MC_STREAM_START:
+            if (mc_block_skip_spaces(blk)) {
+                stream->state = MC_STREAM_IDENT;
+            }
+            break;
+        case MC_STREAM_IDENT:
+            if (mc_block_skip_id(blk)) {
+                g_byte_array_append(buf, start, blk->ptr - start);
+            }
+            if (!mc_block_end(blk)) {
+                /* Identifier can't be empty */
+                stream->state = buf->len ?
+                    MC_STREAM_IDENT_END :
+                    MC_STREAM_ERROR;
+            }
+            break;
+        case MC_STREAM_IDENT_END:
+            if (mc_block_skip_spaces(blk)) {
+                if (*blk->ptr == ':') {
+                    blk->ptr++;
+                    stream->id_len = buf->len;
+                    stream->state = MC_STREAM_PROPERTY;
+                } else {
+                    stream->state = MC_STREAM_ERROR;
+                }
+            }
+            break;
+        case MC_STREAM_PROPERTY:
+            if (mc_block_skip_spaces(blk)) {
+                if (*blk->ptr == ';') {
+                    /* Empty property terminates the record */
+                    stream->state = MC_STREAM_DONE;
+                } else {
+                    stream->name_off = buf->len;
+                    stream->state = MC_STREAM_NAME;
+                }
+            }
+            break;
+        case MC_STREAM_NAME:
+            if (mc_block_skip_id(blk)) {
+                g_byte_array_append(buf, start, blk->ptr - start);
+            }
+            if (!mc_block_end(blk)) {
+                if (*blk->ptr == ':' && buf->len > stream->name_off) {
+                    blk->ptr++;
+                    mc_record_stream_property(stream);
+                    stream->state = MC_STREAM_VALUE;
+                } else {
+                    stream->state = MC_STREAM_ERROR;
+                }
+            }
+            break;
+        case MC_STREAM_VALUE:
+            if (mc_record_stream_value(stream, blk, last)) {
+                const guint8 sep = *blk->ptr;
+
+                mc_record_stream_value_end(stream);
+                if (sep == ',') {
+                    blk->ptr++;
+                } else if (sep == ';') {
+                    blk->ptr++;
+                    stream->state = MC_STREAM_PROPERTY;
+                } else {
+                    /* Unescaped backslash can't be followed by this */
+                    stream->state = stream->backslash ?
+                        MC_STREAM_ERROR :
+                        MC_STREAM_TRAILER;
+                }
+            } else if (!mc_block_end(blk)) {
+                return;
+            }
+            break;
+        case MC_STREAM_TRAILER:
+            if (mc_block_skip_spaces(blk)) {
+                stream->state = (*blk->ptr == ';') ?
+                    MC_STREAM_DONE :
+                    MC_STREAM_ERROR;
+            }
+            break;
+        case MC_STREAM_DONE:
+        case MC_STREAM_ERROR:
+            /* The rest is ignored */
+            blk->ptr = blk->end;
+            break;
+        }
+    }
+}
+
+static
+void
+mc_record_stream_keep(
+    McRecordStream* stream,
+    const McBlock* blk)
+{
+    stream->tail_len = blk->end - blk->ptr;
+    memcpy(stream->tail, blk->ptr, stream->tail_len);
+}
+
+static
+McRecord*
+mc_record_stream_build(
+    McRecordStream* stream)
+{
+    McParser* parser = mc_parser_default();
+    const guint8* data = stream->buf->data;
+    const McRecordStreamValue* val = (gpointer)stream->values->data;
+    McRecord* rec;
+    guint i, k;
+
+    parser->n_props = 0;
+    parser->n_values = 0;
+    parser->id.ptr = data;
+    parser->id.end = data + stream->id_len;
+    for (i = 0; i < stream->props->len; i++) {
+        const McRecordStreamProp* prop = &g_array_index(stream->props,
+            McRecordStreamProp, i);
+        McBlock name;
+
+        name.ptr = data + prop->name_off;
+        name.end = name.ptr + prop->name_len;
+        mc_parser_add_property(parser, &name);
+        for (k = 0; k < prop->n_values; k++, val++) {
+            McBlock raw;
+
+            /* Values have already been decoded */
+            raw.ptr = data + val->off;
+            raw.end = raw.ptr + val->len;
+            mc_parser_add_value(parser, &raw, val->len, TRUE);
+        }
+    }
+    rec = mc_record_build(parser, NULL);
+    mc_parser_trim(parser);
+    return rec;
+}
+
+McRecordStream*
+mc_record_stream_new(
+    void)
+{
+    McRecordStream* stream = g_new0(McRecordStream, 1);
+
+    stream->buf = g_byte_array_new();
+    stream->props = g_array_new(FALSE, FALSE, sizeof(McRecordStreamProp));
+    stream->values = g_array_new(FALSE, FALSE, sizeof(McRecordStreamValue));
+    return stream;
+}
+
+int
+mc_record_stream_feed(
+    McRecordStream* stream,
+    const void* data,
+    size_t len)
+{
+    if (stream && (data || !len)) {
+        McBlock blk;
+
+        blk.ptr = data;
+        blk.end = blk.ptr + len;
+        if (stream->tail_len && len) {
+            /*
+             * Append a few bytes to what's left of the previous chunk
+             * and see how far we can get with that.
+             */
+            const guint tail_len = stream->tail_len;
+            const gsize n = MIN(len, MC_STREAM_LOOKAHEAD);
+            guint8 buf[MC_STREAM_TAIL_SIZE + MC_STREAM_LOOKAHEAD];
+            McBlock win;
+
+            memcpy(buf, stream->tail, tail_len);
+            memcpy(buf + tail_len, data, n);
+            win.ptr = buf;
+            win.end = buf + tail_len + n;
+            stream->tail_len = 0;
+            mc_record_stream_run(stream, &win, FALSE);
+            if (win.ptr < (buf + tail_len)) {
+                /* Still undecided, the whole chunk is in the window */
+                mc_record_stream_keep(stream, &win);
+                return TRUE;
+            }
+            blk.ptr += (win.ptr - buf) - tail_len;
+        }
+        mc_record_stream_run(stream, &blk, FALSE);
+        if (!mc_block_end(&blk)) {
+            mc_record_stream_keep(stream, &blk);
+        }
+        return stream->state != MC_STREAM_ERROR;
+    }
+    return FALSE;
+}
+
+McRecord*
+mc_record_stream_finish(
+    McRecordStream* stream)
+{
+    McRecord* rec = NULL;
+
+    if (stream) {
+        if (stream->tail_len) {
+            McBlock blk;
+
+            blk.ptr = stream->tail;
+            blk.end = blk.ptr + stream->tail_len;
+            stream->tail_len = 0;
+            mc_record_stream_run(stream, &blk, TRUE);
+        }
+        switch (stream->state) {
+        case MC_STREAM_VALUE:
+            if (stream->backslash) {
+                /* Dangling backslash */
+                break;
+            }
+            mc_record_stream_value_end(stream);
+            /* fallthrough */
+        case MC_STREAM_PROPERTY:
+        case MC_STREAM_TRAILER:
+        case MC_STREAM_DONE:
+            rec = mc_record_stream_build(stream);
+            break;
+        case MC_STREAM_START:
+        case MC_STREAM_IDENT:
+        case MC_STREAM_IDENT_END:
+        case MC_STREAM_NAME:
+        case MC_STREAM_ERROR:
+            break;
+        }
+        mc_record_stream_reset(stream);
+    }
+    return rec;
+}
+
+void
+mc_record_stream_free(
+    McRecordStream* stream)
+{
+    if (stream) {
+        g_byte_array_free(stream->buf, TRUE);
+        g_array_free(stream->props, TRUE);
+        g_array_free(stream->values, TRUE);
+        g_free(stream);
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2020-2022 by Slava Monich <slava@monich.com>
+ * Copyright (C) 2020-2026 by Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -76,10 +76,67 @@ mc_block_skip_until(
     guint8 sep)
     G_GNUC_INTERNAL;
 
+/* Identifier or property name characters */
+gsize
+mc_block_skip_id(
+    McBlock* blk)
+    G_GNUC_INTERNAL;
+
+/* Printable ASCII which can be copied to the value as is */
+gsize
+mc_block_skip_text(
+    McBlock* blk)
+    G_GNUC_INTERNAL;
+
+/* Bytes below %x80 */
+gsize
+mc_block_skip_ascii(
+    McBlock* blk)
+    G_GNUC_INTERNAL;
+
+/*
+ * Converts a run of %x80-FF bytes from Latin-1 into UTF-8 and returns
+ * the output length (twice the length of the run). If out is NULL, the
+ * run is only measured.
+ */
+gsize
+mc_block_widen_latin1(
+    McBlock* blk,
+    guint8* out)
+    G_GNUC_INTERNAL;
+
 gboolean
-mc_block_check(
-    const McBlock* blk,
-    gboolean (*check)(guchar))
+mc_block_check_id(
+    const McBlock* blk)
+    G_GNUC_INTERNAL;
+
+/* Complete well-formed UTF-8 multi-byte sequences */
+gsize
+mc_block_skip_utf8(
+    McBlock* blk)
+    G_GNUC_INTERNAL;
+
+/* TRUE if the block ends in the middle of a well-formed UTF-8 sequence */
+gboolean
+mc_block_utf8_incomplete(
+    const McBlock* blk)
+    G_GNUC_INTERNAL;
+
+/*
+ * Scanning kernels are picked at runtime, according to what the CPU
+ * supports. Selecting a specific one is only useful for testing.
+ */
+typedef enum mc_block_impl {
+    MC_BLOCK_IMPL_SCALAR,
+    MC_BLOCK_IMPL_SSE2,
+    MC_BLOCK_IMPL_AVX2,
+    MC_BLOCK_IMPL_COUNT
+} MC_BLOCK_IMPL;
+
+/* Returns FALSE if the implementation is not supported */
+gboolean
+mc_block_select(
+    MC_BLOCK_IMPL impl)
     G_GNUC_INTERNAL;
 
 #endif /* MC_TYPES_PRIVATE_H */
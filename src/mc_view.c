@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_parser_p.h"
+#include "mc_record_p.h"
+#include "mc_view_p.h"
+
+typedef struct mc_record_view_priv {
+    McRecordView pub;
+    GBytes* bytes;
+} McRecordViewPriv;
+
+McRecordView*
+mc_record_view_alloc(
+    guint n_props,
+    guint n_values,
+    gsize extra,
+    GBytes* bytes,
+    McStrSlice** values,
+    guint8** extra_ptr)
+{
+    /* Allocate a single memory block for the whole thing */
+    McRecordViewPriv* priv = g_malloc0(SIZE_ALIGN(sizeof(McRecordViewPriv)) +
+        SIZE_ALIGN(n_props * sizeof(McPropertyView)) +
+        SIZE_ALIGN(n_values * sizeof(McStrSlice)) + extra);
+    McRecordView* view = &priv->pub;
+    guint8* ptr = ((guint8*)priv) + SIZE_ALIGN(sizeof(McRecordViewPriv));
+
+    view->prop = (McPropertyView*)ptr;
+    view->n_prop = n_props;
+    ptr += SIZE_ALIGN(n_props * sizeof(McPropertyView));
+    *values = (McStrSlice*)ptr;
+    ptr += SIZE_ALIGN(n_values * sizeof(McStrSlice));
+    if (extra_ptr) {
+        *extra_ptr = ptr;
+    }
+    if (bytes) {
+        priv->bytes = g_bytes_ref(bytes);
+    }
+    return view;
+}
+
+static
+McRecordView*
+mc_record_view_new(
+    const void* data,
+    gsize size,
+    GBytes* bytes)
+{
+    McParser* parser = mc_parser_default();
+    McRecordView* view = NULL;
+
+    if (mc_parser_scan(parser, data, size, NULL, NULL)) {
+        const McParserProp* src = parser->props;
+        const McParserValue* val = parser->values;
+        McPropertyView* prop;
+        McStrSlice* value;
+        gsize decoded = 0;
+        guint8* ptr;
+        guint i, k;
+
+        /* Only the values which need decoding take extra space */
+        for (i = 0; i < parser->n_values; i++) {
+            if (!val[i].verbatim) {
+                decoded += val[i].len;
+            }
+        }
+
+        view = mc_record_view_alloc(parser->n_props, parser->n_values,
+            decoded, bytes, &value, &ptr);
+        prop = (McPropertyView*)view->prop;
+        view->ident.ptr = (const char*)parser->id.ptr;
+        view->ident.len = parser->id.end - parser->id.ptr;
+        for (i = 0; i < parser->n_props; i++, src++, prop++) {
+            prop->name.ptr = (const char*)src->name.ptr;
+            prop->name.len = src->name.end - src->name.ptr;
+            if (src->n_values) {
+                prop->values = value;
+                prop->n_values = src->n_values;
+                for (k = 0; k < src->n_values; k++, val++, value++) {
+                    if (val->verbatim) {
+                        value->ptr = (const char*)val->raw.ptr;
+                    } else {
+                        value->ptr = (const char*)ptr;
+                        ptr += mc_record_decode_value(&val->raw,
+                            MC_CHARSET_AUTO, ptr);
+                    }
+                    value->len = val->len;
+                }
+            }
+        }
+    }
+    mc_parser_trim(parser);
+    return view;
+}
+
+McRecordView*
+mc_record_view_parse(
+    const void* data,
+    size_t size)
+{
+    return mc_record_view_new(data, size, NULL);
+}
+
+McRecordView*
+mc_record_view_parse_bytes(
+    GBytes* bytes)
+{
+    if (bytes) {
+        gsize size;
+        const void* data = g_bytes_get_data(bytes, &size);
+
+        return mc_record_view_new(data, size, bytes);
+    }
+    return NULL;
+}
+
+void
+mc_record_view_free(
+    McRecordView* view)
+{
+    if (view) {
+        McRecordViewPriv* priv = (McRecordViewPriv*)((guint8*)view -
+            G_STRUCT_OFFSET(McRecordViewPriv, pub));
+
+        if (priv->bytes) {
+            g_bytes_unref(priv->bytes);
+        }
+        g_free(priv);
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,675 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_mecard.h"
+#include "mc_record.h"
+#include "mc_scan.h"
+
+#include <glib.h>
+
+#include <stdio.h>
+
+#define RET_OK (0)
+#define RET_CMDLINE (1)
+#define RET_ERR (2)
+
+/*
+ * The input is split into fixed size chunks. Each entry belongs to the
+ * chunk where it starts. Chunks are processed by the worker threads and
+ * written out in the original order, at most WINDOW_PER_THREAD chunks
+ * per thread may be waiting for their turn.
+ */
+#define CHUNK_SIZE (0x100000)
+#define WINDOW_PER_THREAD (2)
+
+typedef enum app_type {
+    APP_TYPE_RECORD,
+    APP_TYPE_MECARD
+} APP_TYPE;
+
+typedef enum app_format {
+    APP_FORMAT_JSONL,
+    APP_FORMAT_CSV,
+    APP_FORMAT_NONE
+} APP_FORMAT;
+
+typedef enum app_result {
+    APP_RESULT_PARSED,
+    APP_RESULT_EMPTY,
+    APP_RESULT_MALFORMED,
+    APP_RESULT_WRONG_TYPE,
+    APP_RESULT_COUNT
+} APP_RESULT;
+
+static const char* app_result_names[] = {
+    "parsed",       /* APP_RESULT_PARSED */
+    "empty",        /* APP_RESULT_EMPTY */
+    "malformed",    /* APP_RESULT_MALFORMED */
+    "wrong type"    /* APP_RESULT_WRONG_TYPE */
+};
+
+G_STATIC_ASSERT(G_N_ELEMENTS(app_result_names) == APP_RESULT_COUNT);
+
+typedef struct app_mecard_field {
+    const char* name;
+    glong offset;
+} AppMeCardField;
+
+#define APP_MECARD_FIELD(name,member) { name, G_STRUCT_OFFSET(MeCard,member) }
+static const AppMeCardField app_mecard_fields[] = {
+    APP_MECARD_FIELD("N", n),
+    APP_MECARD_FIELD("TEL", tel),
+    APP_MECARD_FIELD("EMAIL", email),
+    APP_MECARD_FIELD("BDAY", bday),
+    APP_MECARD_FIELD("ADR", adr),
+    APP_MECARD_FIELD("NOTE", note),
+    APP_MECARD_FIELD("URL", url),
+    APP_MECARD_FIELD("NICKNAME", nickname),
+    APP_MECARD_FIELD("ORG", org)
+};
+
+typedef struct app_slot {
+    GString* out;
+    gboolean ready;
+} AppSlot;
+
+typedef struct app {
+    const char* data;
+    gsize size;
+    char delim;
+    APP_TYPE type;
+    APP_FORMAT format;
+    guint n_chunks;
+    guint window;
+    AppSlot* slots;
+    GMutex mutex;
+    GCond cond;
+    guint next;         /* Next chunk to process */
+    guint written;      /* Number of chunks written out */
+} App;
+
+typedef struct app_worker {
+    App* app;
+    GThread* thread;
+    guint64 count[APP_RESULT_COUNT];
+} AppWorker;
+
+static
+void
+app_append_json_string(
+    GString* out,
+    const char* str)
+{
+    /* Non-UTF-8 values (ISO8Bit) are treated as Latin-1 */
+    const gboolean utf8 = g_utf8_validate(str, -1, NULL);
+    const guchar* ptr;
+
+    g_string_append_c(out, '"');
+    for (ptr = (const guchar*)str; *ptr; ptr++) {
+        const guchar c = *ptr;
+
+        if (c == '"' || c == '\\') {
+            g_string_append_c(out, '\\');
+            g_string_append_c(out, c);
+        } else if (c < 0x20 || (c >= 0x80 && !utf8)) {
+            g_string_append_printf(out, "\\u%04x", c);
+        } else {
+            g_string_append_c(out, c);
+        }
+    }
+    g_string_append_c(out, '"');
+}
+
+static
+void
+app_append_json_values(
+    GString* out,
+    const McStr* values)
+{
+    g_string_append_c(out, '[');
+    if (values) {
+        const McStr* val;
+
+        for (val = values; *val; val++) {
+            if (val != values) {
+                g_string_append_c(out, ',');
+            }
+            app_append_json_string(out, *val);
+        }
+    }
+    g_string_append_c(out, ']');
+}
+
+static
+void
+app_append_csv_string(
+    GString* out,
+    const char* str)
+{
+    const char* ptr;
+
+    g_string_append_c(out, '"');
+    for (ptr = str; *ptr; ptr++) {
+        if (*ptr == '"') {
+            g_string_append_c(out, '"');
+        }
+        g_string_append_c(out, *ptr);
+    }
+    g_string_append_c(out, '"');
+}
+
+static
+void
+app_format_record(
+    App* app,
+    GString* out,
+    gsize offset,
+    const McRecord* rec)
+{
+    guint i;
+
+    if (app->format == APP_FORMAT_JSONL) {
+        g_string_append_printf(out, "{\"offset\":%" G_GSIZE_FORMAT
+            ",\"ident\":", offset);
+        app_append_json_string(out, rec->ident);
+        g_string_append(out, ",\"properties\":[");
+        for (i = 0; i < rec->n_prop; i++) {
+            const McProperty* prop = rec->prop + i;
+
+            if (i) {
+                g_string_append_c(out, ',');
+            }
+            g_string_append(out, "{\"name\":");
+            app_append_json_string(out, prop->name);
+            g_string_append(out, ",\"values\":");
+            app_append_json_values(out, prop->values);
+            g_string_append_c(out, '}');
+        }
+        g_string_append(out, "]}\n");
+    } else {
+        /* One row per value */
+        for (i = 0; i < rec->n_prop; i++) {
+            const McProperty* prop = rec->prop + i;
+            const McStr* val = prop->values;
+
+            do {
+                g_string_append_printf(out, "%" G_GSIZE_FORMAT ",", offset);
+                app_append_csv_string(out, rec->ident);
+                g_string_append_c(out, ',');
+                app_append_csv_string(out, prop->name);
+                g_string_append_c(out, ',');
+                app_append_csv_string(out, (val && *val) ? *val : "");
+                g_string_append_c(out, '\n');
+            } while (val && *val && *++val);
+        }
+    }
+}
+
+static
+void
+app_format_mecard(
+    App* app,
+    GString* out,
+    gsize offset,
+    const MeCard* mecard)
+{
+    guint i;
+
+    if (app->format == APP_FORMAT_JSONL) {
+        g_string_append_printf(out, "{\"offset\":%" G_GSIZE_FORMAT, offset);
+        for (i = 0; i < G_N_ELEMENTS(app_mecard_fields); i++) {
+            const AppMeCardField* field = app_mecard_fields + i;
+            const McStr* values = G_STRUCT_MEMBER(const McStr*, mecard,
+                field->offset);
+
+            if (values) {
+                g_string_append_printf(out, ",\"%s\":", field->name);
+                app_append_json_values(out, values);
+            }
+        }
+        g_string_append(out, "}\n");
+    } else {
+        /* Fixed columns, multiple values are separated with ';' */
+        g_string_append_printf(out, "%" G_GSIZE_FORMAT, offset);
+        for (i = 0; i < G_N_ELEMENTS(app_mecard_fields); i++) {
+            const AppMeCardField* field = app_mecard_fields + i;
+            const McStr* values = G_STRUCT_MEMBER(const McStr*, mecard,
+                field->offset);
+
+            g_string_append_c(out, ',');
+            if (values) {
+                GString* buf = g_string_new(NULL);
+                const McStr* val;
+
+                for (val = values; *val; val++) {
+                    if (val != values) {
+                        g_string_append_c(buf, ';');
+                    }
+                    g_string_append(buf, *val);
+                }
+                app_append_csv_string(out, buf->str);
+                g_string_free(buf, TRUE);
+            }
+        }
+        g_string_append_c(out, '\n');
+    }
+}
+
+static
+void
+app_format_header(
+    App* app,
+    GString* out)
+{
+    if (app->format == APP_FORMAT_CSV) {
+        if (app->type == APP_TYPE_MECARD) {
+            guint i;
+
+            g_string_append(out, "offset");
+            for (i = 0; i < G_N_ELEMENTS(app_mecard_fields); i++) {
+                g_string_append_c(out, ',');
+                g_string_append(out, app_mecard_fields[i].name);
+            }
+            g_string_append_c(out, '\n');
+        } else {
+            g_string_append(out, "offset,ident,property,value\n");
+        }
+    }
+}
+
+static
+void
+app_scan_entry(
+    AppWorker* worker,
+    GString* out,
+    gsize offset,
+    const char* ptr,
+    gsize len)
+{
+    App* app = worker->app;
+    const gboolean print = (app->format != APP_FORMAT_NONE);
+    APP_RESULT result = APP_RESULT_PARSED;
+
+    if (!len) {
+        result = APP_RESULT_EMPTY;
+    } else if (app->type == APP_TYPE_MECARD) {
+        MeCard* mecard = mecard_parse_data(ptr, len);
+
+        if (mecard) {
+            if (print) {
+                app_format_mecard(app, out, offset, mecard);
+            }
+            mecard_free(mecard);
+        } else {
+            /* Find out why, this is cheaper than building the record */
+            result = mc_record_scan(ptr, len, NULL, NULL) ?
+                APP_RESULT_WRONG_TYPE : APP_RESULT_MALFORMED;
+        }
+    } else {
+        McRecord* rec = mc_record_parse_data(ptr, len);
+
+        if (rec) {
+            if (print) {
+                app_format_record(app, out, offset, rec);
+            }
+            mc_record_free(rec);
+        } else {
+            result = APP_RESULT_MALFORMED;
+        }
+    }
+
+    worker->count[result]++;
+    if (result != APP_RESULT_PARSED && result != APP_RESULT_EMPTY &&
+        app->format == APP_FORMAT_JSONL) {
+        g_string_append_printf(out, "{\"offset\":%" G_GSIZE_FORMAT
+            ",\"error\":\"%s\"}\n", offset, app_result_names[result]);
+    }
+}
+
+static
+void
+app_scan_chunk(
+    AppWorker* worker,
+    guint chunk,
+    GString* out)
+{
+    const App* app = worker->app;
+    const char* data = app->data;
+    const char* end = data + app->size;
+    const char* limit = data + MIN((gsize)(chunk + 1) * CHUNK_SIZE,
+        app->size);
+    const char* ptr = data + (gsize)chunk * CHUNK_SIZE;
+
+    if (chunk) {
+        /* The entry crossing the boundary belongs to the previous chunk */
+        ptr = memchr(ptr - 1, app->delim, end - ptr + 1);
+        ptr = ptr ? (ptr + 1) : end;
+    }
+
+    while (ptr < limit) {
+        const char* eol = memchr(ptr, app->delim, end - ptr);
+        const char* next = eol ? (eol + 1) : end;
+        gsize len = (eol ? eol : end) - ptr;
+
+        if (app->delim == '\n' && len && ptr[len - 1] == '\r') {
+            len--;
+        }
+        app_scan_entry(worker, out, ptr - data, ptr, len);
+        ptr = next;
+    }
+}
+
+static
+gpointer
+app_worker_thread(
+    gpointer data)
+{
+    AppWorker* worker = data;
+    App* app = worker->app;
+
+    for (;;) {
+        AppSlot* slot;
+        guint chunk;
+
+        g_mutex_lock(&app->mutex);
+        while (app->next < app->n_chunks &&
+            app->next >= app->written + app->window) {
+            g_cond_wait(&app->cond, &app->mutex);
+        }
+        if (app->next == app->n_chunks) {
+            g_mutex_unlock(&app->mutex);
+            break;
+        }
+        chunk = app->next++;
+        g_mutex_unlock(&app->mutex);
+
+        slot = app->slots + (chunk % app->window);
+        app_scan_chunk(worker, chunk, slot->out);
+
+        g_mutex_lock(&app->mutex);
+        slot->ready = TRUE;
+        g_cond_broadcast(&app->cond);
+        g_mutex_unlock(&app->mutex);
+    }
+    return NULL;
+}
+
+static
+gboolean
+app_write(
+    FILE* out,
+    const GString* buf)
+{
+    return !buf->len || fwrite(buf->str, buf->len, 1, out) == 1;
+}
+
+static
+int
+app_run(
+    App* app,
+    guint n_threads,
+    FILE* out,
+    gboolean quiet)
+{
+    AppWorker* workers;
+    GString* header = g_string_new(NULL);
+    guint64 count[APP_RESULT_COUNT];
+    guint64 entries = 0;
+    const gint64 start = g_get_monotonic_time();
+    gboolean ok;
+    gdouble secs;
+    guint i, k;
+
+    app->n_chunks = (app->size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    n_threads = MAX(MIN(n_threads, app->n_chunks), 1);
+    app->window = n_threads * WINDOW_PER_THREAD;
+    app->slots = g_new0(AppSlot, app->window);
+    for (i = 0; i < app->window; i++) {
+        app->slots[i].out = g_string_sized_new(CHUNK_SIZE);
+    }
+    g_mutex_init(&app->mutex);
+    g_cond_init(&app->cond);
+
+    app_format_header(app, header);
+    ok = app_write(out, header);
+    g_string_free(header, TRUE);
+
+    workers = g_new0(AppWorker, n_threads);
+    for (i = 0; i < n_threads; i++) {
+        workers[i].app = app;
+        workers[i].thread = g_thread_new("mc-scan", app_worker_thread,
+            workers + i);
+    }
+
+    /* Write the results in the original order */
+    for (i = 0; i < app->n_chunks; i++) {
+        AppSlot* slot = app->slots + (i % app->window);
+
+        g_mutex_lock(&app->mutex);
+        while (!slot->ready) {
+            g_cond_wait(&app->cond, &app->mutex);
+        }
+        g_mutex_unlock(&app->mutex);
+
+        if (ok && !app_write(out, slot->out)) {
+            fprintf(stderr, "Write error\n");
+            ok = FALSE;
+        }
+        g_string_truncate(slot->out, 0);
+
+        g_mutex_lock(&app->mutex);
+        slot->ready = FALSE;
+        app->written++;
+        g_cond_broadcast(&app->cond);
+        g_mutex_unlock(&app->mutex);
+    }
+
+    memset(count, 0, sizeof(count));
+    for (i = 0; i < n_threads; i++) {
+        g_thread_join(workers[i].thread);
+        for (k = 0; k < APP_RESULT_COUNT; k++) {
+            count[k] += workers[i].count[k];
+        }
+    }
+    if (fflush(out)) {
+        ok = FALSE;
+    }
+    secs = (g_get_monotonic_time() - start) / (gdouble) G_USEC_PER_SEC;
+
+    if (!quiet) {
+        for (k = 0; k < APP_RESULT_COUNT; k++) {
+            entries += count[k];
+        }
+        fprintf(stderr, "Entries: %" G_GUINT64_FORMAT "\n", entries);
+        for (k = 0; k < APP_RESULT_COUNT; k++) {
+            if (k != APP_RESULT_WRONG_TYPE || app->type != APP_TYPE_RECORD) {
+                fprintf(stderr, "  %s: %" G_GUINT64_FORMAT "\n",
+                    app_result_names[k], count[k]);
+            }
+        }
+        fprintf(stderr, "Threads: %u\n", n_threads);
+        fprintf(stderr, "Time: %.3f s\n", secs);
+        if (secs > 0) {
+            fprintf(stderr, "Speed: %.0f records/s, %.2f MB/s\n",
+                (entries - count[APP_RESULT_EMPTY]) / secs,
+                app->size / secs / (1024 * 1024));
+        }
+    }
+
+    for (i = 0; i < app->window; i++) {
+        g_string_free(app->slots[i].out, TRUE);
+    }
+    g_free(app->slots);
+    g_free(workers);
+    g_mutex_clear(&app->mutex);
+    g_cond_clear(&app->cond);
+    return ok ? RET_OK : RET_ERR;
+}
+
+static
+gboolean
+app_set_type(
+    App* app,
+    const char* type)
+{
+    if (!type || !strcmp(type, "record")) {
+        app->type = APP_TYPE_RECORD;
+    } else if (!strcmp(type, "mecard")) {
+        app->type = APP_TYPE_MECARD;
+    } else {
+        fprintf(stderr, "Unsupported type '%s'\n", type);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static
+gboolean
+app_set_format(
+    App* app,
+    const char* format)
+{
+    if (!format || !strcmp(format, "jsonl")) {
+        app->format = APP_FORMAT_JSONL;
+    } else if (!strcmp(format, "csv")) {
+        app->format = APP_FORMAT_CSV;
+    } else if (!strcmp(format, "none")) {
+        app->format = APP_FORMAT_NONE;
+    } else {
+        fprintf(stderr, "Unsupported format '%s'\n", format);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static
+int
+app_scan_file(
+    App* app,
+    const char* input,
+    const char* output,
+    guint n_threads,
+    gboolean quiet)
+{
+    int ret = RET_ERR;
+    GError* error = NULL;
+    GMappedFile* map = g_mapped_file_new(input, FALSE, &error);
+
+    if (map) {
+        FILE* out = output ? fopen(output, "wb") : stdout;
+
+        if (out) {
+            app->data = g_mapped_file_get_contents(map);
+            app->size = g_mapped_file_get_length(map);
+            ret = app_run(app, n_threads, out, quiet);
+            if (output && fclose(out)) {
+                ret = RET_ERR;
+            }
+        } else {
+            fprintf(stderr, "Can't open %s\n", output);
+        }
+        g_mapped_file_unref(map);
+    } else {
+        fprintf(stderr, "%s\n", error->message);
+        g_error_free(error);
+    }
+    return ret;
+}
+
+int main(int argc, char* argv[])
+{
+    int ret = RET_CMDLINE;
+    gboolean null_delim = FALSE;
+    gboolean quiet = FALSE;
+    gint n_threads = g_get_num_processors();
+    char* type = NULL;
+    char* format = NULL;
+    char* output = NULL;
+    GError* error = NULL;
+    GOptionContext* options;
+    GOptionEntry entries[] = {
+        { "threads", 'j', 0, G_OPTION_ARG_INT, &n_threads,
+          "Number of worker threads [CPU count]", "N" },
+        { "null", '0', 0, G_OPTION_ARG_NONE, &null_delim,
+          "Entries are separated by NUL rather than newline", NULL },
+        { "type", 't', 0, G_OPTION_ARG_STRING, &type,
+          "Parse entries as record or mecard [record]", "TYPE" },
+        { "format", 'f', 0, G_OPTION_ARG_STRING, &format,
+          "Output format: jsonl, csv or none [jsonl]", "FORMAT" },
+        { "output", 'o', 0, G_OPTION_ARG_FILENAME, &output,
+          "Write the output to FILE [stdout]", "FILE" },
+        { "quiet", 'q', 0, G_OPTION_ARG_NONE, &quiet,
+          "Don't print the statistics", NULL },
+        { NULL }
+    };
+
+    options = g_option_context_new("FILE");
+    g_option_context_add_main_entries(options, entries, NULL);
+    g_option_context_set_summary(options, "Parses mobile codes in bulk. "
+        "The input is a file of\nnewline or NUL separated entries.");
+    if (g_option_context_parse(options, &argc, &argv, &error) &&
+        argc == 2 && n_threads > 0) {
+        App app;
+
+        memset(&app, 0, sizeof(app));
+        app.delim = null_delim ? '\0' : '\n';
+        if (app_set_type(&app, type) && app_set_format(&app, format)) {
+            ret = app_scan_file(&app, argv[1], output, n_threads, quiet);
+        }
+    } else if (error) {
+        fprintf(stderr, "%s\n", error->message);
+        g_error_free(error);
+    } else {
+        char* help = g_option_context_get_help(options, TRUE, NULL);
+
+        fprintf(stderr, "%s", help);
+        g_free(help);
+    }
+
+    g_option_context_free(options);
+    g_free(type);
+    g_free(format);
+    g_free(output);
+    return ret;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_arena.h"
+#include "mc_mecard.h"
+#include "mc_record.h"
+
+#include <glib.h>
+
+static const char test_mecard[] = "MECARD:N:Doe,John;TEL:13035551212;"
+    "EMAIL:john.doe@example.com;TEL:13035551213;;";
+
+/* Null */
+
+static
+void
+test_null(
+    void)
+{
+    McArena* arena = mc_arena_new(0, MC_ARENA_FLAGS_NONE);
+
+    /* NULL resistance */
+    g_assert(!mc_record_parse_data_arena(NULL, test_mecard,
+        sizeof(test_mecard) - 1));
+    g_assert(!mecard_parse_data_arena(NULL, test_mecard,
+        sizeof(test_mecard) - 1));
+    g_assert(!mc_record_parse_data_arena(arena, NULL, 0));
+    g_assert(!mecard_parse_data_arena(arena, NULL, 0));
+    g_assert(!mc_arena_needed(NULL));
+    g_assert(!mc_arena_needed(arena));
+    mc_arena_reset(NULL);
+    mc_arena_free(NULL);
+    mc_arena_free(arena);
+}
+
+/* Heap */
+
+static
+void
+test_heap(
+    gconstpointer data)
+{
+    const MC_ARENA_FLAGS flags = GPOINTER_TO_INT(data);
+    McArena* arena = mc_arena_new(256, flags);
+    guint i, k;
+
+    for (k = 0; k < 2; k++) {
+        /* Records overflow many chunks */
+        for (i = 0; i < 100; i++) {
+            McRecord* rec = mc_record_parse_data_arena(arena, test_mecard,
+                sizeof(test_mecard) - 1);
+            MeCard* mecard = mecard_parse_data_arena(arena, test_mecard,
+                sizeof(test_mecard) - 1);
+
+            g_assert(rec);
+            g_assert_cmpstr(rec->ident, ==, "MECARD");
+            g_assert_cmpuint(rec->n_prop, ==, 4);
+            g_assert_cmpstr(rec->prop[3].values[0], ==, "13035551213");
+            g_assert(mecard);
+            g_assert_cmpstr(mecard->n[1], ==, "John");
+            g_assert_cmpstr(mecard->tel[0], ==, "13035551212");
+            g_assert_cmpstr(mecard->tel[1], ==, "13035551213");
+            g_assert(!mecard->tel[2]);
+
+            /* The arena owns the card, this does nothing */
+            g_assert(mecard_ref(mecard) == mecard);
+            mecard_free(mecard);
+            mecard_unref(mecard);
+            g_assert_cmpstr(mecard->n[1], ==, "John");
+        }
+        g_assert(!mc_arena_needed(arena));
+        mc_arena_reset(arena);
+    }
+    mc_arena_free(arena);
+}
+
+/* Fixed */
+
+static
+void
+test_fixed(
+    void)
+{
+    guint8 buf[1024];
+    McArena* arena = mc_arena_new_fixed(buf, sizeof(buf));
+    McRecord* rec;
+    gsize needed;
+    guint i;
+
+    /* Parse failure doesn't need any space */
+    g_assert(!mc_record_parse_data_arena(arena, "x", 1));
+    g_assert(!mc_arena_needed(arena));
+
+    /* Neither does a record which is not MECARD */
+    g_assert(!mecard_parse_data_arena(arena, "MECARDD:N:x;", 12));
+    g_assert(!mc_arena_needed(arena));
+
+    rec = mc_record_parse_data_arena(arena, test_mecard,
+        sizeof(test_mecard) - 1);
+    g_assert(rec);
+    g_assert((guint8*)rec >= buf && (guint8*)rec < buf + sizeof(buf));
+    g_assert_cmpuint(rec->n_prop, ==, 4);
+
+    /* Fill it up */
+    for (i = 0; mecard_parse_data_arena(arena, test_mecard,
+        sizeof(test_mecard) - 1); i++);
+    g_assert(i > 0);
+    needed = mc_arena_needed(arena);
+    g_assert(needed > 0);
+    g_assert(!mc_record_parse_data_arena(arena, test_mecard,
+        sizeof(test_mecard) - 1));
+    /* The typed MeCard takes less space than the generic record */
+    g_assert(mc_arena_needed(arena) > needed);
+
+    /* Previously parsed record is still there */
+    g_assert_cmpstr(rec->prop[0].values[1], ==, "John");
+
+    /* The arena owns it, reference counting leaves it alone */
+    g_assert(mc_record_ref(rec) == rec);
+    mc_record_unref(rec);
+    mc_record_unref(rec);
+    mc_record_free(rec);
+    g_assert_cmpstr(rec->prop[0].values[1], ==, "John");
+    mc_arena_free(arena);
+}
+
+/* Needed */
+
+static
+void
+test_needed(
+    void)
+{
+    McArena* arena = mc_arena_new_fixed(NULL, 0);
+    guint8* buf;
+    gsize needed;
+    MeCard* mecard;
+
+    /* Find out how much we need */
+    g_assert(!mecard_parse_data_arena(arena, test_mecard,
+        sizeof(test_mecard) - 1));
+    needed = mc_arena_needed(arena);
+    g_assert(needed > 0);
+    mc_arena_free(arena);
+
+    /* And that must be enough (slack is for the alignment) */
+    buf = g_malloc(needed + 7);
+    arena = mc_arena_new_fixed(buf, needed + 7);
+    mecard = mecard_parse_data_arena(arena, test_mecard,
+        sizeof(test_mecard) - 1);
+    g_assert(mecard);
+    g_assert_cmpstr(mecard->email[0], ==, "john.doe@example.com");
+    g_assert(!mc_arena_needed(arena));
+
+    /* Nothing else fits */
+    g_assert(!mc_record_parse_data_arena(arena, "x:", 2));
+    g_assert(mc_arena_needed(arena));
+
+    /* Until it's reset */
+    mc_arena_reset(arena);
+    g_assert(!mc_arena_needed(arena));
+    g_assert(mc_record_parse_data_arena(arena, "x:", 2));
+    mc_arena_free(arena);
+    g_free(buf);
+}
+
+/* Common */
+
+#define TEST_(x) "/arena/" x
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_data_func(TEST_("heap"),
+        GINT_TO_POINTER(MC_ARENA_FLAGS_NONE), test_heap);
+    g_test_add_data_func(TEST_("huge_pages"),
+        GINT_TO_POINTER(MC_ARENA_HUGE_PAGES), test_heap);
+    g_test_add_func(TEST_("fixed"), test_fixed);
+    g_test_add_func(TEST_("needed"), test_needed);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_batch.h"
+#include "mc_mecard.h"
+#include "mc_record.h"
+
+#include <glib.h>
+
+#define TEST_COUNT (1000)
+
+static
+McInput*
+test_inputs(
+    guint n)
+{
+    McInput* inputs = g_new(McInput, n);
+    guint i;
+
+    for (i = 0; i < n; i++) {
+        char* str;
+
+        if (i % 100 == 99) {
+            /* A large one, every now and then */
+            char* big = g_strnfill(10000 + i, 'x');
+
+            str = g_strdup_printf("MECARD:N:%u;NOTE:%s;;", i, big);
+            g_free(big);
+        } else if (i % 10 == 3) {
+            /* Invalid */
+            str = g_strdup_printf("%u", i);
+        } else {
+            str = g_strdup_printf("MECARD:N:%u;TEL:%u;;", i, i * 2);
+        }
+        inputs[i].data = str;
+        inputs[i].size = strlen(str);
+    }
+    return inputs;
+}
+
+static
+void
+test_inputs_free(
+    McInput* inputs,
+    guint n)
+{
+    guint i;
+
+    for (i = 0; i < n; i++) {
+        g_free((char*) inputs[i].data);
+    }
+    g_free(inputs);
+}
+
+static
+guint
+test_inputs_valid(
+    guint n)
+{
+    guint i, count = 0;
+
+    for (i = 0; i < n; i++) {
+        if (i % 10 != 3) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static
+void
+test_records_check(
+    const McInput* inputs,
+    McRecord** out,
+    guint n)
+{
+    guint i;
+
+    for (i = 0; i < n; i++) {
+        McRecord* rec = out[i];
+
+        if (i % 10 == 3) {
+            g_assert(!rec);
+        } else {
+            McRecord* ref = mc_record_parse_data(inputs[i].data,
+                inputs[i].size);
+            char* num = g_strdup_printf("%u", i);
+
+            g_assert(rec);
+            g_assert_cmpstr(rec->ident, ==, "MECARD");
+            g_assert_cmpuint(rec->n_prop, ==, 2);
+            g_assert_cmpstr(rec->prop[0].values[0], ==, num);
+            g_assert_cmpstr(rec->prop[1].values[0], ==,
+                ref->prop[1].values[0]);
+            mc_record_free(ref);
+            mc_record_free(rec);
+            g_free(num);
+        }
+    }
+}
+
+/* Null */
+
+static
+void
+test_null(
+    void)
+{
+    McInput in;
+    McRecord* rec = NULL;
+    MeCard* card = NULL;
+
+    in.data = "a:b:c;;";
+    in.size = 7;
+    g_assert_cmpuint(mc_record_parse_batch(NULL, 1, &rec, NULL), ==, 0);
+    g_assert_cmpuint(mc_record_parse_batch(&in, 1, NULL, NULL), ==, 0);
+    g_assert_cmpuint(mc_record_parse_batch(&in, 0, &rec, NULL), ==, 0);
+    g_assert_cmpuint(mecard_parse_batch(NULL, 1, &card, NULL), ==, 0);
+    g_assert(!rec);
+    g_assert(!card);
+
+    /* Missing data */
+    in.data = NULL;
+    g_assert_cmpuint(mc_record_parse_batch(&in, 1, &rec, NULL), ==, 0);
+    g_assert(!rec);
+}
+
+/* Basic */
+
+static
+void
+test_basic(
+    void)
+{
+    McInput* inputs = test_inputs(TEST_COUNT);
+    McRecord** out = g_new(McRecord*, TEST_COUNT);
+
+    g_assert_cmpuint(mc_record_parse_batch(inputs, TEST_COUNT, out, NULL),
+        ==, test_inputs_valid(TEST_COUNT));
+    test_records_check(inputs, out, TEST_COUNT);
+
+    g_free(out);
+    test_inputs_free(inputs, TEST_COUNT);
+}
+
+/* Options */
+
+static
+void
+test_options(
+    void)
+{
+    static const guint threads[] = { 1, 2, 1000 };
+    static const gsize chunks[] = { 0, 1, 7, TEST_COUNT * 2 };
+    McInput* inputs = test_inputs(TEST_COUNT);
+    McRecord** out = g_new(McRecord*, TEST_COUNT);
+    McParseOptions parse;
+    McBatchOptions opts;
+    guint i, k;
+
+    memset(&opts, 0, sizeof(opts));
+    for (i = 0; i < G_N_ELEMENTS(threads); i++) {
+        for (k = 0; k < G_N_ELEMENTS(chunks); k++) {
+            opts.max_threads = threads[i];
+            opts.chunk_size = chunks[k];
+            g_assert_cmpuint(mc_record_parse_batch(inputs, TEST_COUNT,
+                out, &opts), ==, test_inputs_valid(TEST_COUNT));
+            test_records_check(inputs, out, TEST_COUNT);
+        }
+    }
+
+    /* Parse options apply to each record */
+    memset(&parse, 0, sizeof(parse));
+    parse.max_value_len = 1000;
+    opts.parse = &parse;
+    opts.max_threads = 0;
+    opts.chunk_size = 0;
+    g_assert_cmpuint(mc_record_parse_batch(inputs, TEST_COUNT, out, &opts),
+        ==, test_inputs_valid(TEST_COUNT) - TEST_COUNT / 100);
+    for (i = 0; i < TEST_COUNT; i++) {
+        if (i % 100 == 99) {
+            g_assert(!out[i]);
+        }
+        mc_record_free(out[i]);
+    }
+
+    g_free(out);
+    test_inputs_free(inputs, TEST_COUNT);
+}
+
+/* MeCard */
+
+static
+void
+test_mecard(
+    void)
+{
+    McInput* inputs = test_inputs(TEST_COUNT);
+    MeCard** out = g_new(MeCard*, TEST_COUNT);
+    McParseOptions parse;
+    McBatchOptions opts;
+    guint i;
+
+    g_assert_cmpuint(mecard_parse_batch(inputs, TEST_COUNT, out, NULL),
+        ==, test_inputs_valid(TEST_COUNT));
+    for (i = 0; i < TEST_COUNT; i++) {
+        MeCard* card = out[i];
+
+        if (i % 10 == 3) {
+            g_assert(!card);
+        } else {
+            char* num = g_strdup_printf("%u", i);
+
+            g_assert(card);
+            g_assert_cmpstr(card->n[0], ==, num);
+            if (i % 100 == 99) {
+                g_assert_cmpuint(strlen(card->note[0]), ==, 10000 + i);
+            } else {
+                g_assert_cmpuint(atoi(card->tel[0]), ==, i * 2);
+            }
+            mecard_free(card);
+            g_free(num);
+        }
+    }
+
+    /* Parse options aren't supported for typed records */
+    memset(&parse, 0, sizeof(parse));
+    memset(&opts, 0, sizeof(opts));
+    opts.parse = &parse;
+    out[0] = (MeCard*) inputs;
+    g_assert_cmpuint(mecard_parse_batch(inputs, TEST_COUNT, out, &opts),
+        ==, 0);
+    g_assert(out[0] == (MeCard*) inputs);
+
+    g_free(out);
+    test_inputs_free(inputs, TEST_COUNT);
+}
+
+/* Concurrent */
+
+static
+gpointer
+test_concurrent_proc(
+    gpointer inputs)
+{
+    McRecord** out = g_new(McRecord*, TEST_COUNT);
+
+    g_assert_cmpuint(mc_record_parse_batch(inputs, TEST_COUNT, out, NULL),
+        ==, test_inputs_valid(TEST_COUNT));
+    test_records_check(inputs, out, TEST_COUNT);
+    g_free(out);
+    return NULL;
+}
+
+static
+void
+test_concurrent(
+    void)
+{
+    McInput* inputs = test_inputs(TEST_COUNT);
+    GThread* thread[4];
+    guint i;
+
+    /* Several batches sharing the pool at the same time */
+    for (i = 0; i < G_N_ELEMENTS(thread); i++) {
+        thread[i] = g_thread_new("test", test_concurrent_proc, inputs);
+    }
+    for (i = 0; i < G_N_ELEMENTS(thread); i++) {
+        g_thread_join(thread[i]);
+    }
+    test_inputs_free(inputs, TEST_COUNT);
+}
+
+/* Common */
+
+#define TEST_(x) "/batch/" x
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("basic"), test_basic);
+    g_test_add_func(TEST_("options"), test_options);
+    g_test_add_func(TEST_("mecard"), test_mecard);
+    g_test_add_func(TEST_("concurrent"), test_concurrent);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_blob.h"
+#include "mc_record.h"
+
+#include <glib.h>
+
+static const char test_data[] = "id:a:x\\,y,z;URL:http://x;b:;"
+    "c:\x83\x6e\xd1\x82;;";
+
+static
+void
+test_view_check(
+    const McRecordView* view,
+    const McRecord* rec,
+    const guint8* blob,
+    gsize size)
+{
+    guint i, k;
+
+    g_assert(view);
+    g_assert_cmpuint(view->ident.len, ==, strlen(rec->ident));
+    g_assert(!memcmp(view->ident.ptr, rec->ident, view->ident.len));
+    g_assert_cmpuint(view->n_prop, ==, rec->n_prop);
+    for (i = 0; i < rec->n_prop; i++) {
+        const McPropertyView* prop = view->prop + i;
+        const McProperty* src = rec->prop + i;
+
+        /* Used in place, and NUL-terminated */
+        g_assert_cmpstr(prop->name.ptr, ==, src->name);
+        g_assert((const guint8*)prop->name.ptr > blob);
+        g_assert((const guint8*)prop->name.ptr < blob + size);
+        for (k = 0; src->values && src->values[k]; k++) {
+            g_assert_cmpuint(prop->values[k].len, ==,
+                strlen(src->values[k]));
+            g_assert_cmpstr(prop->values[k].ptr, ==, src->values[k]);
+        }
+        g_assert_cmpuint(prop->n_values, ==, k);
+    }
+}
+
+/* Null */
+
+static
+void
+test_null(
+    void)
+{
+    g_assert(!mc_record_to_blob(NULL, NULL, 0));
+    g_assert(!mc_record_view_blob(NULL, 0));
+    g_assert(!mc_record_view_blob(NULL, 100));
+    g_assert(!mc_record_view_blob("MCB1", 4));
+    g_assert(!mc_record_view_blob_bytes(NULL));
+}
+
+/* Basic */
+
+static
+void
+test_basic(
+    void)
+{
+    McRecord* rec = mc_record_parse(test_data);
+    McRecordView* view;
+    const gsize size = mc_record_to_blob(rec, NULL, 0);
+    guint8* buf = g_malloc(size + 1);
+    guint8* copy;
+
+    g_assert(size);
+
+    /* Nothing is written unless it fits */
+    memset(buf, 0, size + 1);
+    g_assert_cmpuint(mc_record_to_blob(rec, buf, size - 1), ==, size);
+    g_assert(!buf[0]);
+
+    /* No alignment requirements */
+    g_assert_cmpuint(mc_record_to_blob(rec, buf + 1, size), ==, size);
+    view = mc_record_view_blob(buf + 1, size);
+    test_view_check(view, rec, buf + 1, size);
+    mc_record_view_free(view);
+
+    /* Extra space after the blob is fine */
+    view = mc_record_view_blob(buf, size + 1);
+    g_assert(!view); /* But not before it */
+    memmove(buf, buf + 1, size);
+    view = mc_record_view_blob(buf, size + 1);
+    test_view_check(view, rec, buf, size);
+    mc_record_view_free(view);
+
+    /* Relocate */
+    copy = g_memdup2(buf, size);
+    memset(buf, 0, size);
+    g_free(buf);
+    view = mc_record_view_blob(copy, size);
+    test_view_check(view, rec, copy, size);
+    mc_record_view_free(view);
+    g_free(copy);
+    mc_record_free(rec);
+}
+
+/* Empty */
+
+static
+void
+test_empty(
+    void)
+{
+    McRecord* rec = mc_record_parse("id:;");
+    guint8 buf[64];
+    const gsize size = mc_record_to_blob(rec, buf, sizeof(buf));
+    McRecordView* view = mc_record_view_blob(buf, size);
+
+    g_assert_cmpuint(size, ==, 27);
+    test_view_check(view, rec, buf, size);
+    mc_record_view_free(view);
+    mc_record_free(rec);
+}
+
+/* Bytes */
+
+static
+void
+test_bytes(
+    void)
+{
+    McRecord* rec = mc_record_parse(test_data);
+    const gsize size = mc_record_to_blob(rec, NULL, 0);
+    guint8* buf = g_malloc(size);
+    GBytes* bytes;
+    McRecordView* view;
+
+    mc_record_to_blob(rec, buf, size);
+    bytes = g_bytes_new_take(buf, size);
+    view = mc_record_view_blob_bytes(bytes);
+    g_bytes_unref(bytes);
+
+    /* The view holds the reference */
+    test_view_check(view, rec, buf, size);
+    mc_record_view_free(view);
+    mc_record_free(rec);
+}
+
+/* Corrupt */
+
+static
+void
+test_corrupt(
+    void)
+{
+    McRecord* rec = mc_record_parse(test_data);
+    const gsize size = mc_record_to_blob(rec, NULL, 0);
+    guint8* buf = g_malloc(size);
+    guint8* copy = g_malloc(size);
+    gsize i;
+    guint bit;
+
+    mc_record_to_blob(rec, buf, size);
+
+    /* Truncated */
+    for (i = 0; i < size; i++) {
+        memcpy(copy, buf, i);
+        g_assert(!mc_record_view_blob(copy, i));
+    }
+
+    /*
+     * Flip every bit. The result may or may not be rejected but must
+     * stay within the bounds (which is checked by the sanitizers).
+     */
+    for (i = 0; i < size; i++) {
+        for (bit = 0; bit < 8; bit++) {
+            McRecordView* view;
+
+            memcpy(copy, buf, size);
+            copy[i] ^= (1 << bit);
+            view = mc_record_view_blob(copy, size);
+            if (view) {
+                guint k, n;
+
+                g_assert_cmpuint(view->ident.len, <, size);
+                for (k = 0; k < view->n_prop; k++) {
+                    const McPropertyView* prop = view->prop + k;
+
+                    g_assert_cmpuint(strlen(prop->name.ptr), <=,
+                        prop->name.len);
+                    for (n = 0; n < prop->n_values; n++) {
+                        g_assert_cmpuint(strlen(prop->values[n].ptr), <=,
+                            prop->values[n].len);
+                    }
+                }
+                mc_record_view_free(view);
+            }
+        }
+    }
+
+    /* Wrong magic */
+    memcpy(copy, buf, size);
+    copy[0] = 'X';
+    g_assert(!mc_record_view_blob(copy, size));
+
+    g_free(buf);
+    g_free(copy);
+    mc_record_free(rec);
+}
+
+/* Common */
+
+#define TEST_(x) "/blob/" x
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("basic"), test_basic);
+    g_test_add_func(TEST_("empty"), test_empty);
+    g_test_add_func(TEST_("bytes"), test_bytes);
+    g_test_add_func(TEST_("corrupt"), test_corrupt);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
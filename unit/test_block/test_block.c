@@ -0,0 +1,369 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_types_p.h"
+#include "mc_record.h"
+
+#define TEST_BUF_SIZE (200)
+
+typedef struct test_block_result {
+    gsize text;
+    gsize id;
+    gsize spaces;
+    gsize stripped;
+    gsize ascii;
+    gsize widened;
+    gboolean check_id;
+    guint8 latin1[2 * TEST_BUF_SIZE];
+} TestBlockResult;
+
+/* Deterministic pseudo-random data */
+static
+guint32
+test_rand(
+    guint32* state)
+{
+    *state = *state * 1103515245 + 12345;
+    return *state >> 8;
+}
+
+static
+void
+test_fill(
+    guint8* buf,
+    gsize len,
+    const char* alphabet,
+    guint32* state)
+{
+    const gsize n = strlen(alphabet);
+    gsize i;
+
+    /* Occasionally throw in a random byte */
+    for (i = 0; i < len; i++) {
+        const guint32 r = test_rand(state);
+
+        buf[i] = (r % 61) ? alphabet[r % n] : (guint8)(r >> 8);
+    }
+}
+
+static
+void
+test_scan(
+    const guint8* buf,
+    gsize len,
+    TestBlockResult* res)
+{
+    McBlock blk;
+
+    memset(res, 0, sizeof(*res));
+    blk.ptr = buf;
+    blk.end = buf + len;
+    res->text = mc_block_skip_text(&blk);
+    blk.ptr = buf;
+    res->id = mc_block_skip_id(&blk);
+    blk.ptr = buf;
+    mc_block_skip_spaces(&blk);
+    res->spaces = blk.ptr - buf;
+    blk.ptr = buf;
+    mc_block_strip_spaces(&blk);
+    res->stripped = blk.end - buf;
+    blk.ptr = buf;
+    blk.end = buf + len;
+    res->ascii = mc_block_skip_ascii(&blk);
+    res->widened = mc_block_widen_latin1(&blk, res->latin1);
+    blk.ptr = buf;
+    res->check_id = len ? mc_block_check_id(&blk) : TRUE;
+}
+
+/* Kernels */
+
+static
+void
+test_kernels(
+    gconstpointer alphabet)
+{
+    guint8 buf[TEST_BUF_SIZE];
+    guint32 state = 1;
+    MC_BLOCK_IMPL impl;
+    guint k;
+
+    for (k = 0; k < 20; k++) {
+        gsize start, len;
+
+        test_fill(buf, sizeof(buf), alphabet, &state);
+        for (start = 0; start < 40; start++) {
+            for (len = 0; len <= sizeof(buf) - start; len++) {
+                TestBlockResult expected, actual;
+
+                g_assert(mc_block_select(MC_BLOCK_IMPL_SCALAR));
+                test_scan(buf + start, len, &expected);
+                for (impl = MC_BLOCK_IMPL_SCALAR + 1;
+                     impl < MC_BLOCK_IMPL_COUNT; impl++) {
+                    if (mc_block_select(impl)) {
+                        test_scan(buf + start, len, &actual);
+                        g_assert(!memcmp(&expected, &actual,
+                            sizeof(actual)));
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* Record */
+
+static
+void
+test_record_compare(
+    const McRecord* r1,
+    const McRecord* r2)
+{
+    guint i, k;
+
+    g_assert(r1);
+    g_assert(r2);
+    g_assert_cmpstr(r1->ident, ==, r2->ident);
+    g_assert_cmpuint(r1->n_prop, ==, r2->n_prop);
+    for (i = 0; i < r1->n_prop; i++) {
+        const McProperty* p1 = r1->prop + i;
+        const McProperty* p2 = r2->prop + i;
+
+        g_assert_cmpstr(p1->name, ==, p2->name);
+        g_assert(!p1->values == !p2->values);
+        if (p1->values) {
+            for (k = 0; p1->values[k]; k++) {
+                g_assert_cmpstr(p1->values[k], ==, p2->values[k]);
+            }
+            g_assert(!p2->values[k]);
+        }
+    }
+}
+
+static
+void
+test_record(
+    void)
+{
+    static const char* data[] = {
+        "  \t\r\n  SOME-LONG-IDENTIFIER-0123456789-abcdefghijklmn  \t :"
+        "NOTE:The quick brown fox jumps over the lazy dog again and again"
+        " and again\\, and again\\; and again\\: \\\\ and \xD1\x82\xD0\xB5"
+        "\xD1\x81\xD1\x82 and \x83\x6e\x83\x8d and \xFD\x81 until the end,"
+        "second value which is also long enough to need several vectors;"
+        "URL:http://example.com/a/very/long/path/to/somewhere/far/away;"
+        "EMPTY:;  \t  ;;",
+        "id:name:value with an invalid control\x01 character;;"
+    };
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS(data); i++) {
+        const gsize len = strlen(data[i]);
+        McRecord* expected;
+        MC_BLOCK_IMPL impl;
+
+        g_assert(mc_block_select(MC_BLOCK_IMPL_SCALAR));
+        expected = mc_record_parse_data(data[i], len);
+        g_assert(!expected == (i > 0)); /* Only the first one is valid */
+        for (impl = MC_BLOCK_IMPL_SCALAR + 1; impl < MC_BLOCK_IMPL_COUNT;
+             impl++) {
+            if (mc_block_select(impl)) {
+                McRecord* actual = mc_record_parse_data(data[i], len);
+
+                if (expected) {
+                    test_record_compare(expected, actual);
+                } else {
+                    g_assert(!actual);
+                }
+                mc_record_free(actual);
+            }
+        }
+        mc_record_free(expected);
+    }
+}
+
+/* UTF-8 */
+
+static
+gsize
+test_utf8_expected(
+    const guint8* buf,
+    gsize len)
+{
+    gsize n, valid = 0;
+
+    /* The longest valid non-ASCII prefix */
+    for (n = 1; n <= len && buf[n - 1] >= 0x80; n++) {
+        if (g_utf8_validate((const char*)buf, n, NULL)) {
+            valid = n;
+        }
+    }
+    return valid;
+}
+
+static
+void
+test_utf8(
+    void)
+{
+    static const struct test_utf8_data {
+        const char* in;
+        gsize len;
+    } data[] = {
+        { "\xd1\x82\xd0\xb5x", 4 },
+        { "\xf0\x9f\x98\x80\xe3\x83\x8f", 7 },
+        { "\xef\xbf\xbf\xf4\x8f\xbf\xbf", 7 },
+        { "\xc0\xaf", 0 },                  /* Overlong */
+        { "\xe0\x80\xaf", 0 },              /* Overlong */
+        { "\xf0\x8f\xbf\xbf", 0 },          /* Overlong */
+        { "\xed\xa0\x80", 0 },              /* Surrogate */
+        { "\xd1\x82\xed\xbf\xbf", 2 },      /* Surrogate */
+        { "\xf4\x90\x80\x80", 0 },          /* Beyond U+10FFFF */
+        { "\xf8\x88\x80\x80\x80", 0 },      /* 5 bytes */
+        { "\xfc\x84\x80\x80\x80\x80", 0 },  /* 6 bytes */
+        { "\xd1\x82\xe3\x83", 2 },          /* Incomplete */
+        { "\xd1\x82\xe3\x83x", 2 },         /* Incomplete */
+        { "\x80\xbf", 0 }                   /* Continuation */
+    };
+    /* Random non-ASCII data, with some lead bytes */
+    static const char alphabet[] = "\x80\x8f\x90\x9f\xa0\xbf\xc0\xc1\xc2"
+        "\xdf\xe0\xe1\xed\xee\xef\xf0\xf1\xf4\xf5\xf8\xfc\xff\x82\x83\x84"
+        "\xd0\xd1\xe3\xe3\xe3\xf0\x9f\x98\x80\x80\xa0\xb0\x20";
+    guint8 buf[TEST_BUF_SIZE];
+    guint32 state = 1;
+    guint i, k;
+
+    for (i = 0; i < G_N_ELEMENTS(data); i++) {
+        McBlock blk;
+
+        blk.ptr = (const guint8*)data[i].in;
+        blk.end = blk.ptr + strlen(data[i].in);
+        g_assert_cmpuint(mc_block_skip_utf8(&blk), ==, data[i].len);
+        g_assert(blk.ptr == (const guint8*)data[i].in + data[i].len);
+    }
+    for (k = 0; k < 100; k++) {
+        gsize start;
+
+        test_fill(buf, sizeof(buf), alphabet, &state);
+        for (start = 0; start < sizeof(buf); start++) {
+            const gsize len = sizeof(buf) - start;
+            McBlock blk;
+
+            blk.ptr = buf + start;
+            blk.end = blk.ptr + len;
+            g_assert_cmpuint(mc_block_skip_utf8(&blk), ==,
+                test_utf8_expected(buf + start, len));
+        }
+    }
+}
+
+/* Widen */
+
+static
+void
+test_widen(
+    void)
+{
+    guint8 in[128], out[2 * sizeof(in)];
+    gchar* utf8;
+    gsize len;
+    McBlock blk;
+    guint i;
+
+    for (i = 0; i < sizeof(in); i++) {
+        in[i] = 0x80 + i;
+    }
+    utf8 = g_convert((const char*)in, sizeof(in), "UTF-8", "ISO-8859-1",
+        NULL, &len, NULL);
+    g_assert(utf8);
+    g_assert_cmpuint(len, ==, sizeof(out));
+
+    /* Every implementation, every length */
+    for (i = MC_BLOCK_IMPL_SCALAR; i < MC_BLOCK_IMPL_COUNT; i++) {
+        if (mc_block_select(i)) {
+            gsize n;
+
+            for (n = 0; n <= sizeof(in); n++) {
+                memset(out, 0, sizeof(out));
+                blk.ptr = in;
+                blk.end = in + n;
+                g_assert_cmpuint(mc_block_widen_latin1(&blk, out), ==, 2 * n);
+                g_assert(blk.ptr == in + n);
+                g_assert(!memcmp(out, utf8, 2 * n));
+            }
+        }
+    }
+
+    /* Measure only, stop at ASCII */
+    blk.ptr = in;
+    blk.end = in + sizeof(in);
+    in[20] = 'x';
+    g_assert_cmpuint(mc_block_widen_latin1(&blk, NULL), ==, 40);
+    g_assert(blk.ptr == in + 20);
+    g_free(utf8);
+}
+
+/* Common */
+
+#define TEST_(x) "/block/" x
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_data_func(TEST_("text"), "abcdefghijklmnopqrstuvwxyz"
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 !\"#$%&'()*+-./<=>?@[]^_`{|}~",
+        test_kernels);
+    g_test_add_data_func(TEST_("separators"), "abc,;:\\\x7f\x80\xff\r\n",
+        test_kernels);
+    g_test_add_data_func(TEST_("spaces"), "      \t\t\r\n\f\v",
+        test_kernels);
+    g_test_add_data_func(TEST_("id"), "abcdefghijklmnopqrstuvwxyz"
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789--------@[`{/:",
+        test_kernels);
+    g_test_add_data_func(TEST_("latin1"), "\x80\xa9\xbf\xc0\xe9\xff"
+        "abc", test_kernels);
+    g_test_add_func(TEST_("record"), test_record);
+    g_test_add_func(TEST_("widen"), test_widen);
+    g_test_add_func(TEST_("utf8"), test_utf8);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
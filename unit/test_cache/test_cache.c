@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_cache.h"
+#include "mc_mecard.h"
+#include "mc_record.h"
+
+#include <glib.h>
+
+#define TEST_THREADS (4)
+#define TEST_ROUNDS (2000)
+
+static const char test_mecard[] = "MECARD:N:Owen,Sean;TEL:8002221111;;";
+
+/* Null */
+
+static
+void
+test_null(
+    void)
+{
+    McParseCache* cache = mc_parse_cache_new(0);
+
+    mc_record_ref(NULL);
+    mc_record_unref(NULL);
+    mecard_ref(NULL);
+    mecard_unref(NULL);
+    mc_parse_cache_free(NULL);
+    mc_parse_cache_clear(NULL);
+    g_assert(!mc_parse_cache_record(NULL, "a:b;;", 5));
+    g_assert(!mc_parse_cache_mecard(NULL, test_mecard, 5));
+    g_assert(!mc_parse_cache_record(cache, NULL, 0));
+    g_assert_cmpuint(mc_parse_cache_size(NULL), ==, 0);
+    g_assert_cmpuint(mc_parse_cache_size(cache), ==, 0);
+    mc_parse_cache_free(cache);
+}
+
+/* Ref */
+
+static
+void
+test_ref(
+    void)
+{
+    McRecord* rec = mc_record_parse("a:b:c;;");
+    MeCard* card = mecard_parse(test_mecard);
+
+    g_assert(rec);
+    g_assert(mc_record_ref(rec) == rec);
+    mc_record_unref(rec);
+    g_assert_cmpstr(rec->ident, ==, "a");
+    mc_record_free(rec);
+
+    g_assert(card);
+    g_assert(mecard_ref(card) == card);
+    mecard_free(card);
+    g_assert_cmpstr(card->tel[0], ==, "8002221111");
+    mecard_unref(card);
+}
+
+/* Hit */
+
+static
+void
+test_hit(
+    void)
+{
+    McParseCache* cache = mc_parse_cache_new(0);
+    char* copy = g_strdup(test_mecard);
+    const gsize len = strlen(test_mecard);
+    McRecord* rec1 = mc_parse_cache_record(cache, test_mecard, len);
+    McRecord* rec2 = mc_parse_cache_record(cache, copy, len);
+    MeCard* card1 = mc_parse_cache_mecard(cache, test_mecard, len);
+    MeCard* card2 = mc_parse_cache_mecard(cache, copy, len);
+    McRecord* rec3 = mc_parse_cache_record(cache, test_mecard, len - 1);
+    gsize size;
+
+    /* Same payload (even at a different address) gives the same result */
+    g_assert(rec1);
+    g_assert(rec1 == rec2);
+    g_assert_cmpstr(rec1->ident, ==, "MECARD");
+    g_assert(card1);
+    g_assert(card1 == card2);
+    g_assert_cmpstr(card1->n[0], ==, "Owen");
+    g_assert(rec3);
+    g_assert(rec3 != rec1);
+    size = mc_parse_cache_size(cache);
+    g_assert_cmpuint(size, >, 3 * len);
+
+    /* Results survive clearing the cache */
+    mc_parse_cache_clear(cache);
+    g_assert_cmpuint(mc_parse_cache_size(cache), ==, 0);
+    g_assert_cmpstr(rec1->prop[1].values[0], ==, "8002221111");
+    rec2 = mc_parse_cache_record(cache, test_mecard, len);
+    g_assert(rec2);
+    g_assert(rec2 != rec1);
+    g_assert_cmpuint(mc_parse_cache_size(cache), <, size);
+
+    /* And the cache itself */
+    mc_parse_cache_free(cache);
+    g_assert_cmpstr(card2->tel[0], ==, "8002221111");
+    mc_record_unref(rec1);
+    mc_record_unref(rec1);
+    mc_record_unref(rec2);
+    mc_record_unref(rec3);
+    mecard_unref(card1);
+    mecard_unref(card2);
+    g_free(copy);
+}
+
+/* Fail */
+
+static
+void
+test_fail(
+    void)
+{
+    McParseCache* cache = mc_parse_cache_new(0);
+
+    g_assert(!mc_parse_cache_record(cache, "x", 1));
+    g_assert_cmpuint(mc_parse_cache_size(cache), >, 0);
+    g_assert(!mc_parse_cache_record(cache, "x", 1));
+    g_assert(!mc_parse_cache_mecard(cache, "a:b:c;;", 7));
+    mc_parse_cache_free(cache);
+}
+
+/* NoFailures */
+
+static
+void
+test_no_failures(
+    void)
+{
+    McParseCache* cache = mc_parse_cache_new_full(0,
+        MC_PARSE_CACHE_NO_FAILURES);
+    McRecord* rec;
+
+    g_assert(!mc_parse_cache_record(cache, "x", 1));
+    g_assert(!mc_parse_cache_mecard(cache, "a:b:c;;", 7));
+    g_assert_cmpuint(mc_parse_cache_size(cache), ==, 0);
+    rec = mc_parse_cache_record(cache, test_mecard, strlen(test_mecard));
+    g_assert(rec);
+    g_assert_cmpuint(mc_parse_cache_size(cache), >, 0);
+    mc_record_unref(rec);
+    mc_parse_cache_free(cache);
+}
+
+/* Evict */
+
+static
+void
+test_evict(
+    void)
+{
+    const gsize max = 16 * 1024;
+    McParseCache* cache = mc_parse_cache_new(max);
+    char* big = g_strnfill(max, 'x');
+    guint i;
+
+    for (i = 0; i < 1000; i++) {
+        char* str = g_strdup_printf("x:id:%u;;", i);
+        McRecord* rec = mc_parse_cache_record(cache, str, strlen(str));
+
+        g_assert(rec);
+        g_assert_cmpstr(rec->prop[0].name, ==, "id");
+        mc_record_unref(rec);
+        g_free(str);
+        g_assert_cmpuint(mc_parse_cache_size(cache), <=, max);
+    }
+    g_assert_cmpuint(mc_parse_cache_size(cache), >, max / 2);
+
+    /* Too big to be cached */
+    memcpy(big, "a:b:", 4);
+    memcpy(big + max - 2, ";;", 2);
+    for (i = 0; i < 2; i++) {
+        McRecord* rec = mc_parse_cache_record(cache, big, max);
+
+        g_assert(rec);
+        mc_record_unref(rec);
+    }
+    g_assert_cmpuint(mc_parse_cache_size(cache), <=, max);
+
+    g_free(big);
+    mc_parse_cache_free(cache);
+}
+
+/* Threads */
+
+static
+gpointer
+test_threads_proc(
+    gpointer cache)
+{
+    guint i;
+
+    for (i = 0; i < TEST_ROUNDS; i++) {
+        char* str = g_strdup_printf("MECARD:N:%u;;", i % 100);
+        MeCard* card = mc_parse_cache_mecard(cache, str, strlen(str));
+        char* n = g_strdup_printf("%u", i % 100);
+
+        g_assert(card);
+        g_assert_cmpstr(card->n[0], ==, n);
+        mecard_unref(card);
+        g_free(str);
+        g_free(n);
+    }
+    return NULL;
+}
+
+static
+void
+test_threads(
+    void)
+{
+    McParseCache* cache = mc_parse_cache_new(4096);
+    GThread* thread[TEST_THREADS];
+    guint i;
+
+    for (i = 0; i < TEST_THREADS; i++) {
+        thread[i] = g_thread_new("test", test_threads_proc, cache);
+    }
+    for (i = 0; i < TEST_THREADS; i++) {
+        g_thread_join(thread[i]);
+    }
+    g_assert_cmpuint(mc_parse_cache_size(cache), <=, 4096);
+    mc_parse_cache_free(cache);
+}
+
+/* Common */
+
+#define TEST_(x) "/cache/" x
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("ref"), test_ref);
+    g_test_add_func(TEST_("hit"), test_hit);
+    g_test_add_func(TEST_("fail"), test_fail);
+    g_test_add_func(TEST_("no_failures"), test_no_failures);
+    g_test_add_func(TEST_("evict"), test_evict);
+    g_test_add_func(TEST_("threads"), test_threads);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,354 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_compact.h"
+#include "mc_record.h"
+#include "mc_record_p.h"
+#include "mc_stats.h"
+
+#include <glib.h>
+
+static const char test_mecard[] = "MECARD:N:Doe,John;TEL:13035551212;"
+    "TEL:13035551313;EMAIL:john.doe@example.com;"
+    "ADR:123 Main St.,Springfield,,USA;URL:http\\://www.example.com;;";
+
+static
+void
+test_assert_str(
+    const char* ptr,
+    gsize len,
+    const char* str)
+{
+    g_assert(ptr);
+    g_assert_cmpuint(len, ==, strlen(str));
+    g_assert(!memcmp(ptr, str, len));
+}
+
+static
+void
+test_check(
+    const McCompactRecord* compact,
+    const McRecord* rec)
+{
+    const char* ptr;
+    gsize len;
+    guint i, k;
+
+    g_assert(compact);
+    ptr = mc_compact_record_ident(compact, &len);
+    test_assert_str(ptr, len, rec->ident);
+    g_assert_cmpuint(mc_compact_record_n_prop(compact), ==, rec->n_prop);
+    for (i = 0; i < rec->n_prop; i++) {
+        const McProperty* prop = rec->prop + i;
+
+        ptr = mc_compact_record_name(compact, i, &len);
+        test_assert_str(ptr, len, prop->name);
+        g_assert_cmpstr(ptr, ==, prop->name);
+        for (k = 0; prop->values && prop->values[k]; k++) {
+            ptr = mc_compact_record_value(compact, i, k, &len);
+            test_assert_str(ptr, len, prop->values[k]);
+
+            /* NUL-terminated too */
+            g_assert_cmpstr(mc_compact_record_value(compact, i, k, NULL),
+                ==, prop->values[k]);
+        }
+        g_assert_cmpuint(mc_compact_record_n_values(compact, i), ==, k);
+        g_assert(!mc_compact_record_value(compact, i, k, &len));
+        g_assert_cmpuint(len, ==, 0);
+    }
+    g_assert(!mc_compact_record_name(compact, i, &len));
+    g_assert_cmpuint(len, ==, 0);
+    g_assert_cmpuint(mc_compact_record_n_values(compact, i), ==, 0);
+}
+
+static
+guint64
+test_stats_calls(
+    const McStats* stats,
+    MC_STATS_ENTRY entry)
+{
+    guint64 n = 0;
+    guint i;
+
+    for (i = 0; i < MC_STATS_LATENCY_BUCKETS; i++) {
+        n += stats->latency[entry][i];
+    }
+    return n;
+}
+
+/* Null */
+
+static
+void
+test_null(
+    void)
+{
+    gsize len = 1;
+
+    g_assert(!mc_compact_record_parse(NULL, 0));
+    g_assert(!mc_compact_record_parse("x", 1));
+    g_assert(!mc_compact_record_new(NULL));
+    g_assert(!mc_compact_record_ident(NULL, &len));
+    g_assert_cmpuint(len, ==, 0);
+    g_assert(!mc_compact_record_ident(NULL, NULL));
+    g_assert(!mc_compact_record_name(NULL, 0, NULL));
+    g_assert(!mc_compact_record_value(NULL, 0, 0, NULL));
+    g_assert_cmpuint(mc_compact_record_n_prop(NULL), ==, 0);
+    g_assert_cmpuint(mc_compact_record_n_values(NULL, 0), ==, 0);
+    g_assert_cmpuint(mc_compact_record_size(NULL), ==, 0);
+    g_assert_cmpint(mc_compact_record_lookup(NULL, "N"), ==, -1);
+    g_assert_cmpint(mc_compact_record_lookup_next(NULL, 0), ==, -1);
+    mc_compact_record_free(NULL);
+}
+
+/* Record */
+
+static
+void
+test_record(
+    gconstpointer data)
+{
+    /* Must be consistent with McRecord, either parsed or converted */
+    const char* str = data;
+    McRecord* rec = mc_record_parse(str);
+    McCompactRecord* c1 = mc_compact_record_parse(str, strlen(str));
+    McCompactRecord* c2 = mc_compact_record_new(rec);
+
+    g_assert(rec);
+    test_check(c1, rec);
+    test_check(c2, rec);
+    g_assert_cmpuint(mc_compact_record_size(c1), ==,
+        mc_compact_record_size(c2));
+    g_assert(!memcmp(c1, c2, mc_compact_record_size(c1)));
+    mc_record_free(rec);
+    mc_compact_record_free(c1);
+    mc_compact_record_free(c2);
+}
+
+/* Intern */
+
+static
+void
+test_intern(
+    void)
+{
+    static const char str[] = "MECARD:N:a;X-FOO:b;TEL:1;;";
+    McCompactRecord* c1 = mc_compact_record_parse(test_mecard,
+        sizeof(test_mecard) - 1);
+    McCompactRecord* c2 = mc_compact_record_parse(str, sizeof(str) - 1);
+    const guint8* start = (const guint8*)c2;
+    const guint8* end = start + mc_compact_record_size(c2);
+    const char* ptr;
+    gsize len;
+
+    /* Well-known names are shared by all records */
+    g_assert(c1);
+    g_assert(c2);
+    g_assert(mc_compact_record_ident(c1, NULL) ==
+        mc_compact_record_ident(c2, NULL));
+    g_assert(mc_compact_record_name(c1, 0, NULL) ==
+        mc_compact_record_name(c2, 0, NULL));
+    ptr = mc_compact_record_name(c2, 2, &len);
+    test_assert_str(ptr, len, "TEL");
+    g_assert((const guint8*)ptr < start || (const guint8*)ptr >= end);
+
+    /* Others are stored in the record */
+    ptr = mc_compact_record_name(c2, 1, &len);
+    test_assert_str(ptr, len, "X-FOO");
+    g_assert((const guint8*)ptr > start && (const guint8*)ptr < end);
+
+    /* Lookup works both ways */
+    g_assert_cmpint(mc_compact_record_lookup(c1, "TEL"), ==, 1);
+    g_assert_cmpint(mc_compact_record_lookup(c1, "URL"), ==, 5);
+    g_assert_cmpint(mc_compact_record_lookup(c1, "NOTE"), ==, -1);
+    g_assert_cmpint(mc_compact_record_lookup(c1, "X-FOO"), ==, -1);
+    g_assert_cmpint(mc_compact_record_lookup(c2, "X-FOO"), ==, 1);
+    g_assert_cmpint(mc_compact_record_lookup(c2, "X-FO"), ==, -1);
+    g_assert_cmpint(mc_compact_record_lookup(c2, "TEL"), ==, 2);
+    g_assert_cmpint(mc_compact_record_lookup(c2, NULL), ==, -1);
+
+    /* Properties with the same name, in the order of appearance */
+    g_assert_cmpint(mc_compact_record_lookup_next(c1, 1), ==, 2);
+    g_assert_cmpint(mc_compact_record_lookup_next(c1, 2), ==, -1);
+    g_assert_cmpint(mc_compact_record_lookup_next(c1, 0), ==, -1);
+    g_assert_cmpint(mc_compact_record_lookup_next(c1, 6), ==, -1);
+    mc_compact_record_free(c1);
+    mc_compact_record_free(c2);
+}
+
+/* Lookup */
+
+static
+void
+test_lookup(
+    void)
+{
+    GString* buf = g_string_new("id:");
+    McCompactRecord* compact;
+    int k;
+    guint i;
+
+    /* Long enough to have several properties in every bucket */
+    for (i = 0; i < 30; i++) {
+        g_string_append_printf(buf, "TEL:%u;X-%u:x;X-Y:%u;", i, i, i);
+    }
+    g_string_append(buf, ";");
+    compact = mc_compact_record_parse(buf->str, buf->len);
+    g_assert(compact);
+    g_assert_cmpuint(mc_compact_record_n_prop(compact), ==, 90);
+    for (i = 0; i < 30; i++) {
+        char* name = g_strdup_printf("X-%u", i);
+
+        g_assert_cmpint(mc_compact_record_lookup(compact, name), ==,
+            3 * i + 1);
+        g_free(name);
+    }
+    for (i = 0, k = mc_compact_record_lookup(compact, "X-Y"); k >= 0;
+         i++, k = mc_compact_record_lookup_next(compact, k)) {
+        g_assert_cmpint(k, ==, 3 * i + 2);
+    }
+    g_assert_cmpuint(i, ==, 30);
+    for (i = 0, k = mc_compact_record_lookup(compact, "TEL"); k >= 0;
+         i++, k = mc_compact_record_lookup_next(compact, k)) {
+        g_assert_cmpint(k, ==, 3 * i);
+    }
+    g_assert_cmpuint(i, ==, 30);
+    g_assert_cmpint(mc_compact_record_lookup(compact, "X-30"), ==, -1);
+    mc_compact_record_free(compact);
+    g_string_free(buf, TRUE);
+}
+
+/* Stats */
+
+static
+void
+test_stats(
+    void)
+{
+    McStats stats;
+
+    /* Compact records are accounted separately */
+    mc_stats_enable(TRUE);
+    mc_stats_reset();
+    mc_compact_record_free(mc_compact_record_parse(test_mecard,
+        sizeof(test_mecard) - 1));
+    mc_stats_get(&stats);
+    mc_stats_enable(FALSE);
+    g_assert_cmpuint(stats.records, ==, 1);
+    g_assert_cmpuint(test_stats_calls(&stats, MC_STATS_ENTRY_COMPACT),
+        ==, 1);
+    g_assert_cmpuint(test_stats_calls(&stats, MC_STATS_ENTRY_RECORD),
+        ==, 0);
+}
+
+/* Size */
+
+static
+void
+test_size(
+    void)
+{
+    McRecord* rec = mc_record_parse(test_mecard);
+    McCompactRecord* compact = mc_compact_record_parse(test_mecard,
+        sizeof(test_mecard) - 1);
+    const gsize size = mc_compact_record_size(compact);
+
+    /* No more than half of the regular layout */
+    g_assert(rec);
+    g_assert(compact);
+    g_test_message("%u vs %u bytes", (guint) size,
+        (guint) mc_record_size(rec));
+    g_assert_cmpuint(2 * size, <=, mc_record_size(rec));
+    mc_record_free(rec);
+    mc_compact_record_free(compact);
+}
+
+/* Options */
+
+static
+void
+test_options(
+    void)
+{
+    static const char str[] = "id:a:\xe9t\xe9;;";
+    McParseOptions opts;
+    McCompactRecord* compact;
+    const char* ptr;
+    gsize len;
+
+    memset(&opts, 0, sizeof(opts));
+    opts.charset = MC_CHARSET_LATIN1;
+    compact = mc_compact_record_parse_full(str, sizeof(str) - 1, &opts);
+    g_assert(compact);
+    ptr = mc_compact_record_value(compact, 0, 0, &len);
+    test_assert_str(ptr, len, "\xc3\xa9t\xc3\xa9");
+    mc_compact_record_free(compact);
+
+    opts.charset = MC_CHARSET_AUTO;
+    opts.max_props = 1;
+    g_assert(!mc_compact_record_parse_full(test_mecard,
+        sizeof(test_mecard) - 1, &opts));
+}
+
+/* Common */
+
+#define TEST_(x) "/compact/" x
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_data_func(TEST_("record/1"), " foo : ;;", test_record);
+    g_test_add_data_func(TEST_("record/2"), test_mecard, test_record);
+    g_test_add_data_func(TEST_("record/3"), "id:a:\xD1\x82\xD0\xB5,"
+        "\xD1\xD1,\x83\x6e;b:\\\\\\.;;", test_record);
+    g_test_add_data_func(TEST_("record/4"), "WIFI:T:WPA;S:net;P:pass;;",
+        test_record);
+    g_test_add_func(TEST_("intern"), test_intern);
+    g_test_add_func(TEST_("lookup"), test_lookup);
+    g_test_add_func(TEST_("stats"), test_stats);
+    g_test_add_func(TEST_("size"), test_size);
+    g_test_add_func(TEST_("options"), test_options);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
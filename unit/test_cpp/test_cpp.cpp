@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc.hpp"
+
+#include <glib.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+using namespace std::string_view_literals;
+
+static const char test_card[] =
+    "MECARD:N:Owen,Sean;TEL:8002221111;TEL:8002223333;;";
+
+/* Basic */
+
+static
+void
+test_basic(
+    void)
+{
+    const std::string data("a:b:c,d;x:;;");
+    mc::Record rec = mc::parse(data);
+    std::vector<std::string_view> values;
+
+    g_assert(rec);
+    g_assert(rec.ident() == "a"sv);
+    g_assert_cmpuint(rec.size(), ==, 2);
+    g_assert(rec[0].name() == "b"sv);
+    for (std::string_view v : rec[0].values()) {
+        values.push_back(v);
+    }
+    g_assert_cmpuint(values.size(), ==, 2);
+    g_assert(values[0] == "c"sv);
+    g_assert(values[1] == "d"sv);
+    g_assert_cmpuint(rec[0].values().size(), ==, 2);
+    g_assert(rec[0].values().front() == "c"sv);
+    g_assert(rec[0].values()[1].data() == rec.c_ptr()->prop[0].values[1]);
+    g_assert(rec[1].name() == "x"sv);
+    g_assert_cmpuint(rec[1].values().size(), ==, 0);
+    g_assert(rec[1].values().empty());
+
+    int n = 0;
+    for (mc::Property prop : rec) {
+        g_assert(prop.c_ptr() == rec.c_ptr()->prop + n);
+        n++;
+    }
+    g_assert_cmpint(n, ==, 2);
+    g_assert_cmpint(rec.props().end() - rec.props().begin(), ==, 2);
+
+    /* Move only */
+    const McRecord* ptr = rec.c_ptr();
+    mc::Record other(std::move(rec));
+
+    g_assert(!rec);
+    g_assert(other.c_ptr() == ptr);
+    rec = std::move(other);
+    g_assert(!other);
+    g_assert(rec.c_ptr() == ptr);
+    rec.reset();
+    g_assert(!rec);
+
+    /* Failure */
+    g_assert(!mc::parse("x"));
+    g_assert(!mc::parse(mc::Bytes()));
+}
+
+/* Bytes */
+
+static
+void
+test_bytes(
+    void)
+{
+    const std::array<std::byte, 7> bytes = {
+        std::byte('a'), std::byte(':'), std::byte('b'), std::byte(':'),
+        std::byte('c'), std::byte(';'), std::byte(';')
+    };
+    const std::vector<unsigned char> vec(bytes.size(), 'x');
+    const mc::Bytes b1(bytes);
+    const mc::Bytes b2(vec);
+    const mc::Bytes b3("a:b:c;;");
+    const mc::Bytes b4("a:b:c;;"sv);
+
+    g_assert(b1.data() == bytes.data());
+    g_assert_cmpuint(b1.size(), ==, 7);
+    g_assert(b2.data() == vec.data());
+    g_assert_cmpuint(b2.size(), ==, 7);
+    g_assert_cmpuint(b3.size(), ==, 7);
+    g_assert_cmpuint(b4.size(), ==, 7);
+    g_assert(mc::parse(bytes).ident() == "a"sv);
+}
+
+/* Options */
+
+static
+void
+test_options(
+    void)
+{
+    McParseOptions opts = {};
+
+    opts.max_props = 1;
+    g_assert(mc::parse("a:b:c;;", opts));
+    g_assert(!mc::parse("a:b:c;d:e;;", opts));
+}
+
+/* View */
+
+static
+void
+test_view(
+    void)
+{
+    static const char data[] = "a:b:c\\;d,e;;";
+    mc::View view = mc::parse_view(data);
+
+    g_assert(view);
+    g_assert(view.ident() == "a"sv);
+    g_assert_cmpuint(view.size(), ==, 1);
+    for (mc::PropertyView prop : view) {
+        g_assert(prop.name() == "b"sv);
+        g_assert(prop.name().data() == data + 2);
+        g_assert_cmpuint(prop.values().size(), ==, 2);
+        g_assert(prop.values()[0] == "c;d"sv);
+        g_assert(prop.values()[1] == "e"sv);
+        g_assert(prop.values()[1].data() == data + 9);
+    }
+
+    mc::View other;
+
+    other = std::move(view);
+    g_assert(!view);
+    g_assert(other);
+    g_assert(!mc::parse_view("x"));
+}
+
+/* MeCard */
+
+static
+void
+test_mecard(
+    void)
+{
+    mc::MeCard card = mc::parse_mecard(test_card);
+    auto tel = card.get<mc::field::tel>();
+
+    static_assert(mc::field::tel::member == &::MeCard::tel);
+    g_assert(card);
+    g_assert(tel.c_ptr() == card.c_ptr()->tel);
+    g_assert_cmpuint(tel.size(), ==, 2);
+    g_assert(tel[0] == "8002221111"sv);
+    g_assert(tel[1] == "8002223333"sv);
+    g_assert(card.get<mc::field::n>().front() == "Owen"sv);
+    g_assert(card.get<mc::field::email>().empty());
+    g_assert(card.get<mc::field::email>().begin() ==
+        card.get<mc::field::email>().end());
+
+    mc::MeCard other(std::move(card));
+
+    g_assert(!card);
+    g_assert(other);
+    g_assert(!mc::parse_mecard("a:b:c;;"));
+}
+
+/* Arena */
+
+static
+void
+test_arena(
+    void)
+{
+    mc::Arena arena;
+    mc::RecordRef rec = mc::parse("a:b:c;;", arena);
+    mc::MeCardRef card = mc::parse_mecard(test_card, arena);
+
+    g_assert(rec);
+    g_assert(rec.ident() == "a"sv);
+    g_assert(card);
+    g_assert(card.get<mc::field::tel>().front() == "8002221111"sv);
+    arena.reset();
+
+    /* Fixed arena from a memory resource */
+    std::pmr::monotonic_buffer_resource pool;
+    mc::Arena small(16, &pool);
+
+    g_assert(!mc::parse("a:b:c;;", small));
+    g_assert_cmpuint(small.needed(), >, 16);
+}
+
+/* Memory resource */
+
+static
+void
+test_pmr(
+    void)
+{
+    std::array<std::byte, 16384> buf;
+    std::pmr::monotonic_buffer_resource pool(buf.data(), buf.size(),
+        std::pmr::null_memory_resource());
+    const std::string big = "a:b:" + std::string(1000, 'x') + "," +
+        std::string(1000, 'y') + ";;";
+    const std::byte* start = buf.data();
+    const std::byte* end = start + buf.size();
+    mc::Record rec = mc::parse("a:b:c;;", &pool);
+    mc::Record rec2 = mc::parse(big, std::pmr::polymorphic_allocator<
+        std::byte>(&pool));
+    mc::MeCard card = mc::parse_mecard(test_card, &pool);
+
+    g_assert(rec);
+    g_assert(rec[0].values().front() == "c"sv);
+    g_assert((const std::byte*)rec.c_ptr() >= start);
+    g_assert((const std::byte*)rec.c_ptr() < end);
+    g_assert(rec2);
+    g_assert_cmpuint(rec2[0].values()[1].size(), ==, 1000);
+    g_assert((const std::byte*)rec2.c_ptr() >= start);
+    g_assert((const std::byte*)rec2.c_ptr() < end);
+    g_assert(card);
+    g_assert((const std::byte*)card.c_ptr() >= start);
+    g_assert((const std::byte*)card.c_ptr() < end);
+    g_assert(!mc::parse("x", &pool));
+
+    /* Guessed size is too small for a record with many properties */
+    std::string many = "a:";
+
+    for (int i = 0; i < 50; i++) {
+        many += "b:;";
+    }
+    many += ";";
+    mc::Record rec3 = mc::parse(many, std::pmr::new_delete_resource());
+
+    g_assert(rec3);
+    g_assert_cmpuint(rec3.size(), ==, 50);
+}
+
+/* Common */
+
+#define TEST_(x) "/cpp/" x
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("basic"), test_basic);
+    g_test_add_func(TEST_("bytes"), test_bytes);
+    g_test_add_func(TEST_("options"), test_options);
+    g_test_add_func(TEST_("view"), test_view);
+    g_test_add_func(TEST_("mecard"), test_mecard);
+    g_test_add_func(TEST_("arena"), test_arena);
+    g_test_add_func(TEST_("pmr"), test_pmr);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C++
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
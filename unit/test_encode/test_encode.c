@@ -0,0 +1,444 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_matmsg.h"
+#include "mc_mebkm.h"
+#include "mc_mecard.h"
+#include "mc_meloc.h"
+#include "mc_record.h"
+#include "mc_wifi.h"
+
+#include <glib.h>
+
+static
+void
+test_record_compare(
+    const McRecord* r1,
+    const McRecord* r2)
+{
+    guint i, k;
+
+    g_assert(r1);
+    g_assert(r2);
+    g_assert_cmpstr(r1->ident, ==, r2->ident);
+    g_assert_cmpuint(r1->n_prop, ==, r2->n_prop);
+    for (i = 0; i < r1->n_prop; i++) {
+        const McProperty* p1 = r1->prop + i;
+        const McProperty* p2 = r2->prop + i;
+
+        g_assert_cmpstr(p1->name, ==, p2->name);
+        g_assert(!p1->values == !p2->values);
+        if (p1->values) {
+            for (k = 0; p1->values[k]; k++) {
+                g_assert_cmpstr(p1->values[k], ==, p2->values[k]);
+            }
+            g_assert(!p2->values[k]);
+        }
+    }
+}
+
+/* Null */
+
+static
+void
+test_null(
+    void)
+{
+    size_t offsets[2];
+
+    g_assert(!mc_record_encode(NULL, NULL, 0));
+    g_assert(!mc_record_encode_string(NULL));
+    g_assert(!mc_record_encode_batch(NULL, 1, offsets));
+    g_assert(!mecard_encode(NULL, NULL, 0));
+    g_assert(!mecard_encode_string(NULL));
+    g_assert(!mebkm_encode(NULL, NULL, 0));
+    g_assert(!mebkm_encode_string(NULL));
+    g_assert(!matmsg_encode(NULL, NULL, 0));
+    g_assert(!matmsg_encode_string(NULL));
+    g_assert(!meloc_encode(NULL, NULL, 0));
+    g_assert(!meloc_encode_string(NULL));
+    g_assert(!wifi_encode(NULL, NULL, 0));
+    g_assert(!wifi_encode_string(NULL));
+}
+
+/* Basic */
+
+static
+void
+test_basic(
+    void)
+{
+    static const char in[] = " id : a:x\\,y,,z\\:\\;; URL:http://x;b:;"
+        "c:\x83\x6e\r\n;;";
+    static const char out[] = "id:a:x\\,y,z\\:\\;;URL:http://x;b:;"
+        "c:\xe3\x83\x8f\r\n;;";
+    const gsize len = sizeof(out) - 1;
+    McRecord* rec = mc_record_parse_data(in, sizeof(in) - 1);
+    McRecord* rec2;
+    char buf[64];
+    char* str;
+
+    g_assert(rec);
+    g_assert_cmpuint(mc_record_encode(rec, NULL, 0), ==, len);
+
+    /* Nothing is written unless there's room for the NUL */
+    memset(buf, 'x', sizeof(buf));
+    g_assert_cmpuint(mc_record_encode(rec, buf, len), ==, len);
+    g_assert_cmpint(buf[0], ==, 'x');
+    g_assert_cmpuint(mc_record_encode(rec, buf, len + 1), ==, len);
+    g_assert_cmpstr(buf, ==, out);
+
+    str = mc_record_encode_string(rec);
+    g_assert_cmpstr(str, ==, out);
+
+    /* Round trip */
+    rec2 = mc_record_parse(str);
+    test_record_compare(rec, rec2);
+    mc_record_free(rec2);
+    mc_record_free(rec);
+    g_free(str);
+}
+
+/* Invalid */
+
+static
+void
+test_invalid(
+    void)
+{
+    static const char* bad_id[] = { "", "a_b", "a b" };
+    static const char* bad_value[] = {
+        "tab\t", "nul\x01", "del\x7f", "\xd1", "\xe3\x83x", "\x83\x6e"
+    };
+    McStr values[2];
+    McProperty prop;
+    McRecord rec;
+    guint i;
+
+    memset(&rec, 0, sizeof(rec));
+    memset(&prop, 0, sizeof(prop));
+    values[0] = "v";
+    values[1] = NULL;
+    prop.name = "n";
+    prop.values = values;
+    rec.prop = &prop;
+    rec.n_prop = 1;
+
+    /* Missing identifier */
+    g_assert(!mc_record_encode(&rec, NULL, 0));
+
+    rec.ident = "id";
+    g_assert_cmpuint(mc_record_encode(&rec, NULL, 0), ==, 8);
+    for (i = 0; i < G_N_ELEMENTS(bad_id); i++) {
+        rec.ident = bad_id[i];
+        g_assert(!mc_record_encode(&rec, NULL, 0));
+        rec.ident = "id";
+        prop.name = bad_id[i];
+        g_assert(!mc_record_encode(&rec, NULL, 0));
+        prop.name = "n";
+    }
+    for (i = 0; i < G_N_ELEMENTS(bad_value); i++) {
+        values[0] = bad_value[i];
+        g_assert(!mc_record_encode(&rec, NULL, 0));
+        g_assert(!mc_record_encode_string(&rec));
+    }
+}
+
+/* RoundTrip */
+
+static const char* test_round_trip_data[] = {
+    "id:;",
+    "id:name-0:value_0;name-1:value_1;;",
+    " test: URL:http://example.com:8080/x;UR:http\\://example.com;;",
+    "id:n:\xD1\x82\xD0\xB5\xD1\x81\xD1\x82;;",
+    "id:n:\xF0\x9F\x98\x80\xE3\x83\x8F;",
+    "id:n:\x83\x6e\x83\x8d\x83\x5c,\x93\xfa\x96\x7b\xe0\x40;",
+    "id:n:back\\\\slash\\;\\,\\:\\.;",
+    "id:n:\\\x83\x5c\\\xD1\x82,\\\\\\,\\;;",
+    "id:n:,,,;m:a,,b;;"
+};
+
+static
+void
+test_round_trip(
+    gconstpointer test_data)
+{
+    const char* in = test_data;
+    McRecord* rec = mc_record_parse(in);
+    McRecord* rec2;
+    char* str;
+
+    g_assert(rec);
+    str = mc_record_encode_string(rec);
+    g_assert(str);
+    g_assert_cmpuint(strlen(str), ==, mc_record_encode(rec, NULL, 0));
+    rec2 = mc_record_parse(str);
+    test_record_compare(rec, rec2);
+    mc_record_free(rec);
+    mc_record_free(rec2);
+    g_free(str);
+}
+
+/* Batch */
+
+static
+void
+test_batch(
+    void)
+{
+    static const char* in[] = {
+        "a:x:1;;", "b:y:2\\,3;;", "c:;"
+    };
+    const McRecord* recs[G_N_ELEMENTS(in)];
+    size_t offsets[G_N_ELEMENTS(in) + 1];
+    McRecord* rec;
+    char* buf;
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS(in); i++) {
+        recs[i] = mc_record_parse(in[i]);
+        g_assert(recs[i]);
+    }
+    g_assert(!mc_record_encode_batch(recs, 0, offsets));
+
+    buf = mc_record_encode_batch(recs, G_N_ELEMENTS(recs), offsets);
+    g_assert(buf);
+    g_assert_cmpuint(offsets[0], ==, 0);
+    for (i = 0; i < G_N_ELEMENTS(in); i++) {
+        g_assert_cmpstr(buf + offsets[i], ==, in[i]);
+        g_assert_cmpuint(offsets[i + 1], ==, offsets[i] + strlen(in[i]) + 1);
+    }
+    g_free(buf);
+
+    /* Offsets are optional */
+    buf = mc_record_encode_batch(recs, G_N_ELEMENTS(recs), NULL);
+    g_assert(buf);
+    g_assert_cmpstr(buf, ==, in[0]);
+    g_free(buf);
+
+    /* One bad record fails the whole batch, offsets stay untouched */
+    rec = (McRecord*)recs[1];
+    recs[1] = NULL;
+    memset(offsets, 0xff, sizeof(offsets));
+    g_assert(!mc_record_encode_batch(recs, G_N_ELEMENTS(recs), offsets));
+    for (i = 0; i < G_N_ELEMENTS(offsets); i++) {
+        g_assert_cmpuint(offsets[i], ==, (size_t)-1);
+    }
+    recs[1] = rec;
+    for (i = 0; i < G_N_ELEMENTS(recs); i++) {
+        mc_record_free((McRecord*)recs[i]);
+    }
+}
+
+/* MeCard */
+
+static
+void
+test_mecard(
+    void)
+{
+    static const char in[] = "MECARD:TEL:1;N:Doe,John;ADR:a;TEL:2;ADR:b,c;"
+        "URL:http://x;NOTE:a\\;b;X-FOO:y;;";
+    static const char out[] = "MECARD:N:Doe,John;TEL:1;TEL:2;ADR:a,b,c;"
+        "NOTE:a\\;b;URL:http://x;;";
+    MeCard* mecard = mecard_parse(in);
+    MeCard* mecard2;
+    char buf[sizeof(out)];
+    char* str;
+
+    g_assert(mecard);
+    g_assert_cmpuint(mecard_encode(mecard, buf, sizeof(buf)), ==,
+        sizeof(out) - 1);
+    g_assert_cmpstr(buf, ==, out);
+    str = mecard_encode_string(mecard);
+    g_assert_cmpstr(str, ==, out);
+    mecard2 = mecard_parse(str);
+    g_assert(mecard2);
+    g_assert_cmpstr(mecard2->n[1], ==, "John");
+    g_assert_cmpstr(mecard2->adr[2], ==, "c");
+    g_assert_cmpstr(mecard2->tel[1], ==, "2");
+    g_assert(!mecard2->email);
+    mecard_free(mecard);
+    mecard_free(mecard2);
+    g_free(str);
+}
+
+/* MeBkm */
+
+static
+void
+test_mebkm(
+    void)
+{
+    static const char out[] = "MEBKM:TITLE:a\\,b;URL:http://x;;";
+    MeBkm mebkm;
+    char* str;
+
+    memset(&mebkm, 0, sizeof(mebkm));
+    str = mebkm_encode_string(&mebkm);
+    g_assert_cmpstr(str, ==, "MEBKM:;");
+    g_free(str);
+
+    mebkm.title = "a,b";
+    mebkm.url = "http://x";
+    g_assert_cmpuint(mebkm_encode(&mebkm, NULL, 0), ==, sizeof(out) - 1);
+    str = mebkm_encode_string(&mebkm);
+    g_assert_cmpstr(str, ==, out);
+    g_free(str);
+}
+
+/* MatMsg */
+
+static
+void
+test_matmsg(
+    void)
+{
+    static const char out[] = "MATMSG:TO:a@b,c@d;SUB:Hi;"
+        "BODY:x\\;y\\,z;;";
+    static const McStr to[] = { "a@b", "c@d", NULL };
+    MatMsg matmsg;
+    MatMsg* parsed;
+    char* str;
+
+    memset(&matmsg, 0, sizeof(matmsg));
+    matmsg.to = to;
+    matmsg.sub = "Hi";
+    matmsg.body = "x;y,z";
+    g_assert_cmpuint(matmsg_encode(&matmsg, NULL, 0), ==, sizeof(out) - 1);
+    str = matmsg_encode_string(&matmsg);
+    g_assert_cmpstr(str, ==, out);
+
+    /* Commas in the body survive the round trip */
+    parsed = matmsg_parse(str);
+    g_assert(parsed);
+    g_assert_cmpstr(parsed->to[0], ==, "a@b");
+    g_assert_cmpstr(parsed->to[1], ==, "c@d");
+    g_assert(!parsed->to[2]);
+    g_assert_cmpstr(parsed->body, ==, "x;y,z");
+    matmsg_free(parsed);
+    g_free(str);
+}
+
+/* MeLoc */
+
+static
+void
+test_meloc(
+    void)
+{
+    static const char out[] = "MELOC:LAT:1.5;LNG:-2;NAME:a\\:b;;";
+    MeLoc meloc;
+    MeLoc* parsed;
+    char* str;
+
+    memset(&meloc, 0, sizeof(meloc));
+    meloc.lat = "1.5";
+    meloc.lng = "-2";
+    meloc.name = "a:b";
+    g_assert_cmpuint(meloc_encode(&meloc, NULL, 0), ==, sizeof(out) - 1);
+    str = meloc_encode_string(&meloc);
+    g_assert_cmpstr(str, ==, out);
+    parsed = meloc_parse(str);
+    g_assert(parsed);
+    g_assert(!parsed->alt);
+    g_assert_cmpstr(parsed->name, ==, "a:b");
+    meloc_free(parsed);
+    g_free(str);
+}
+
+/* WiFi */
+
+static
+void
+test_wifi(
+    void)
+{
+    static const char out[] = "WIFI:T:WPA;S:My\\;Net;P:p\\:ss;H:true;;";
+    WiFi wifi;
+    WiFi* parsed;
+    char* str;
+
+    memset(&wifi, 0, sizeof(wifi));
+    wifi.type = "WPA";
+    wifi.ssid = "My;Net";
+    wifi.password = "p:ss";
+    wifi.hidden = "true";
+    g_assert_cmpuint(wifi_encode(&wifi, NULL, 0), ==, sizeof(out) - 1);
+    str = wifi_encode_string(&wifi);
+    g_assert_cmpstr(str, ==, out);
+    parsed = wifi_parse(str);
+    g_assert(parsed);
+    g_assert_cmpstr(parsed->ssid, ==, "My;Net");
+    g_assert_cmpstr(parsed->password, ==, "p:ss");
+    wifi_free(parsed);
+    g_free(str);
+}
+
+/* Common */
+
+#define TEST_(x) "/encode/" x
+
+int main(int argc, char* argv[])
+{
+    guint i;
+
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("basic"), test_basic);
+    g_test_add_func(TEST_("invalid"), test_invalid);
+    g_test_add_func(TEST_("batch"), test_batch);
+    g_test_add_func(TEST_("mecard"), test_mecard);
+    g_test_add_func(TEST_("mebkm"), test_mebkm);
+    g_test_add_func(TEST_("matmsg"), test_matmsg);
+    g_test_add_func(TEST_("meloc"), test_meloc);
+    g_test_add_func(TEST_("wifi"), test_wifi);
+    for (i = 0; i < G_N_ELEMENTS(test_round_trip_data); i++) {
+        char* name = g_strdup_printf(TEST_("round_trip/%u"), i + 1);
+
+        g_test_add_data_func(name, test_round_trip_data[i], test_round_trip);
+        g_free(name);
+    }
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
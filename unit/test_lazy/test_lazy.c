@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_lazy.h"
+#include "mc_record.h"
+
+#include <glib.h>
+
+static
+void
+test_assert_slice(
+    const McStrSlice* slice,
+    const char* str)
+{
+    g_assert(slice->ptr);
+    g_assert_cmpuint(slice->len, ==, strlen(str));
+    g_assert(!memcmp(slice->ptr, str, slice->len));
+}
+
+static
+void
+test_assert_value(
+    const McLazyProperty* prop,
+    guint i,
+    const char* str)
+{
+    size_t len = 0;
+    const char* value = mc_property_value(prop, i, &len);
+
+    g_assert(value);
+    g_assert_cmpuint(len, ==, strlen(str));
+    g_assert(!memcmp(value, str, len));
+}
+
+/* Null */
+
+static
+void
+test_null(
+    void)
+{
+    const char empty[] = "";
+    size_t len = 1;
+
+    /* NULL resistance */
+    g_assert(!mc_lazy_record_parse(NULL, 0));
+    g_assert(!mc_lazy_record_parse(empty, 0));
+    g_assert(!mc_lazy_record_parse_bytes(NULL));
+    g_assert(!mc_property_value(NULL, 0, NULL));
+    g_assert(!mc_property_value(NULL, 0, &len));
+    g_assert_cmpuint(len, ==, 0);
+    mc_lazy_record_free(NULL);
+}
+
+/* Failure */
+
+static
+void
+test_failure(
+    gconstpointer str)
+{
+    g_assert(!mc_lazy_record_parse(str, strlen(str)));
+}
+
+/* Basic */
+
+static
+void
+test_basic(
+    void)
+{
+    const char str[] = " id :name-0:value_0;name-1:value_1,,x;name-2:;;";
+    McLazyRecord* rec = mc_lazy_record_parse(str, sizeof(str) - 1);
+    const McLazyProperty* prop;
+    size_t len = 1;
+
+    g_assert(rec);
+    test_assert_slice(&rec->ident, "id");
+    g_assert(rec->ident.ptr == str + 1);
+    g_assert_cmpuint(rec->n_prop, ==, 3);
+
+    /* Nothing needs unescaping, values point to the input */
+    prop = rec->prop;
+    test_assert_slice(&prop->name, "name-0");
+    g_assert_cmpuint(prop->n_values, ==, 1);
+    g_assert(!prop->values[0].needs_unescape);
+    test_assert_slice(&prop->values[0].raw, "value_0");
+    g_assert(mc_property_value(prop, 0, NULL) == str + 12);
+    test_assert_value(prop, 0, "value_0");
+    g_assert(!mc_property_value(prop, 1, &len));
+    g_assert_cmpuint(len, ==, 0);
+
+    prop++;
+    test_assert_slice(&prop->name, "name-1");
+    g_assert_cmpuint(prop->n_values, ==, 2);
+    test_assert_value(prop, 0, "value_1");
+    test_assert_value(prop, 1, "x");
+    g_assert(mc_property_value(prop, 1, NULL) == str + 36);
+
+    prop++;
+    test_assert_slice(&prop->name, "name-2");
+    g_assert_cmpuint(prop->n_values, ==, 0);
+    g_assert(!mc_property_value(prop, 0, NULL));
+    mc_lazy_record_free(rec);
+}
+
+/* Decode */
+
+static
+void
+test_decode(
+    void)
+{
+    const char str[] = "id:a:x\\:y,\\,;b:\x83\x6e\x83\x8d;URL:http://foo";
+    McLazyRecord* rec = mc_lazy_record_parse(str, sizeof(str) - 1);
+    const McLazyProperty* prop;
+    const char* value;
+
+    g_assert(rec);
+    g_assert_cmpuint(rec->n_prop, ==, 3);
+
+    /* Raw slices are there before anything gets decoded */
+    prop = rec->prop;
+    g_assert_cmpuint(prop->n_values, ==, 2);
+    g_assert(prop->values[0].needs_unescape);
+    g_assert(prop->values[1].needs_unescape);
+    test_assert_slice(&prop->values[0].raw, "x\\:y");
+    test_assert_slice(&prop->values[1].raw, "\\,");
+    g_assert_cmpuint(prop->values[0].len, ==, 3);
+    g_assert_cmpuint(prop->values[1].len, ==, 1);
+
+    /* Decoded once, then the same buffer is returned */
+    value = mc_property_value(prop, 0, NULL);
+    test_assert_value(prop, 0, "x:y");
+    g_assert(mc_property_value(prop, 0, NULL) == value);
+    g_assert(value < str || value >= str + sizeof(str));
+    test_assert_value(prop, 1, ",");
+
+    /* Shift-JIS needs decoding too */
+    prop++;
+    g_assert(prop->values[0].needs_unescape);
+    test_assert_slice(&prop->values[0].raw, "\x83\x6e\x83\x8d");
+    test_assert_value(prop, 0, "\xe3\x83\x8f\xe3\x83\xad");
+
+    /* But unescaped URL doesn't */
+    prop++;
+    g_assert(!prop->values[0].needs_unescape);
+    g_assert(mc_property_value(prop, 0, NULL) == str + 24);
+    test_assert_value(prop, 0, "http://foo");
+    mc_lazy_record_free(rec);
+}
+
+/* Threads */
+
+#define TEST_THREADS 4
+#define TEST_VALUES 64
+
+static
+gpointer
+test_threads_proc(
+    gpointer data)
+{
+    const McLazyRecord* rec = data;
+    guint i;
+
+    for (i = 0; i < TEST_VALUES; i++) {
+        test_assert_value(rec->prop, i, ",:;");
+    }
+    return NULL;
+}
+
+static
+void
+test_threads(
+    void)
+{
+    GString* buf = g_string_new("id:a:");
+    McLazyRecord* rec;
+    GThread* thread[TEST_THREADS];
+    guint i;
+
+    for (i = 0; i < TEST_VALUES; i++) {
+        g_string_append(buf, i ? ",\\,\\:\\;" : "\\,\\:\\;");
+    }
+    g_string_append(buf, ";;");
+    rec = mc_lazy_record_parse(buf->str, buf->len);
+    g_assert(rec);
+    g_assert_cmpuint(rec->prop->n_values, ==, TEST_VALUES);
+
+    /* Concurrent first reads all see the fully decoded values */
+    for (i = 0; i < TEST_THREADS; i++) {
+        thread[i] = g_thread_new(NULL, test_threads_proc, rec);
+    }
+    for (i = 0; i < TEST_THREADS; i++) {
+        g_thread_join(thread[i]);
+    }
+    mc_lazy_record_free(rec);
+    g_string_free(buf, TRUE);
+}
+
+/* Bytes */
+
+static
+void
+test_bytes(
+    void)
+{
+    static const char str[] = "id:name:va\\;lue;;";
+    char* copy = g_strdup(str);
+    GBytes* bytes = g_bytes_new_take(copy, sizeof(str) - 1);
+    McLazyRecord* rec = mc_lazy_record_parse_bytes(bytes);
+
+    /* The record keeps the data alive */
+    g_bytes_unref(bytes);
+    g_assert(rec);
+    test_assert_slice(&rec->ident, "id");
+    g_assert(rec->ident.ptr == copy);
+    g_assert_cmpuint(rec->n_prop, ==, 1);
+    test_assert_slice(&rec->prop->name, "name");
+    test_assert_value(rec->prop, 0, "va;lue");
+    mc_lazy_record_free(rec);
+}
+
+/* Record */
+
+static
+void
+test_record(
+    gconstpointer data)
+{
+    /* Lazy record must be consistent with McRecord */
+    const char* str = data;
+    McRecord* rec = mc_record_parse(str);
+    McLazyRecord* lazy = mc_lazy_record_parse(str, strlen(str));
+    guint i, k;
+
+    g_assert(rec);
+    g_assert(lazy);
+    test_assert_slice(&lazy->ident, rec->ident);
+    g_assert_cmpuint(lazy->n_prop, ==, rec->n_prop);
+    for (i = 0; i < rec->n_prop; i++) {
+        const McProperty* p1 = rec->prop + i;
+        const McLazyProperty* p2 = lazy->prop + i;
+
+        test_assert_slice(&p2->name, p1->name);
+        if (p1->values) {
+            for (k = 0; p1->values[k]; k++) {
+                g_assert_cmpuint(k, < ,p2->n_values);
+                test_assert_value(p2, k, p1->values[k]);
+            }
+            g_assert_cmpuint(k, == ,p2->n_values);
+        } else {
+            g_assert(!p2->n_values);
+        }
+    }
+    mc_record_free(rec);
+    mc_lazy_record_free(lazy);
+}
+
+/* Common */
+
+#define TEST_(x) "/lazy/" x
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_data_func(TEST_("invalid_id"), "_:", test_failure);
+    g_test_add_data_func(TEST_("invalid_prop/1"), "foo: a", test_failure);
+    g_test_add_data_func(TEST_("invalid_prop/2"), "foo: a:\\", test_failure);
+    g_test_add_func(TEST_("basic"), test_basic);
+    g_test_add_func(TEST_("decode"), test_decode);
+    g_test_add_func(TEST_("threads"), test_threads);
+    g_test_add_func(TEST_("bytes"), test_bytes);
+    g_test_add_data_func(TEST_("record/1"), " foo : ;;", test_record);
+    g_test_add_data_func(TEST_("record/2"), "MECARD:N:Doe,John;"
+        "TEL:13035551212;EMAIL:;URL:http\\://www.example.com;;",
+        test_record);
+    g_test_add_data_func(TEST_("record/3"), "id:a:\xD1\x82\xD0\xB5,"
+        "\xD1\xD1,\x83\x6e;b:\\\\\\.;;", test_record);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_parser_p.h"
+#include "mc_parser.h"
+#include "mc_record.h"
+#include "mc_stream.h"
+
+#include <glib.h>
+
+static
+char*
+test_record_data(
+    guint n_prop)
+{
+    GString* buf = g_string_new("id:");
+    guint i;
+
+    for (i = 0; i < n_prop; i++) {
+        g_string_append_printf(buf, "p%u:v%u,\\;%u;", i, i, i);
+    }
+    return g_string_free(buf, FALSE);
+}
+
+static
+void
+test_check_record(
+    const McRecord* rec,
+    guint n_prop)
+{
+    guint i;
+
+    g_assert(rec);
+    g_assert_cmpstr(rec->ident, ==, "id");
+    g_assert_cmpuint(rec->n_prop, ==, n_prop);
+    for (i = 0; i < n_prop; i++) {
+        const McProperty* prop = rec->prop + i;
+        char* name = g_strdup_printf("p%u", i);
+        char* v0 = g_strdup_printf("v%u", i);
+        char* v1 = g_strdup_printf(";%u", i);
+
+        g_assert_cmpstr(prop->name, ==, name);
+        g_assert_cmpstr(prop->values[0], ==, v0);
+        g_assert_cmpstr(prop->values[1], ==, v1);
+        g_assert(!prop->values[2]);
+        g_free(name);
+        g_free(v0);
+        g_free(v1);
+    }
+}
+
+/* Null */
+
+static
+void
+test_null(
+    void)
+{
+    McParser* parser = mc_parser_new();
+
+    /* NULL resistance */
+    g_assert(!mc_parser_parse(NULL, "x:", 2));
+    g_assert(!mc_parser_parse(parser, NULL, 0));
+    g_assert(!mc_parser_parse(parser, "x", 1));
+    mc_parser_free(parser);
+    mc_parser_free(NULL);
+}
+
+/* Reuse */
+
+static
+void
+test_reuse(
+    void)
+{
+    /* Small, large (doesn't fit into the inline tables) and small again */
+    static const guint n_prop[] = { 1, 3, 100, 2, 1000, 0, 5 };
+    McParser* parser = mc_parser_new();
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS(n_prop); i++) {
+        char* str = test_record_data(n_prop[i]);
+        McRecord* rec = mc_parser_parse(parser, str, strlen(str));
+
+        test_check_record(rec, n_prop[i]);
+        mc_record_free(rec);
+        g_free(str);
+    }
+    mc_parser_free(parser);
+}
+
+/* Trim */
+
+static
+void
+test_trim(
+    void)
+{
+    McParser* parser = mc_parser_new();
+    char* str = test_record_data(1000);
+    McRecord* rec = mc_parser_parse(parser, str, strlen(str));
+
+    /* Huge tables don't outlive the parse */
+    test_check_record(rec, 1000);
+    g_assert_cmpuint(parser->props_alloc, ==, MC_PARSER_MAX_PROPS);
+    g_assert_cmpuint(parser->values_alloc, ==, MC_PARSER_MAX_VALUES);
+    mc_record_free(rec);
+    g_free(str);
+
+    /* Moderately large ones are kept for reuse */
+    str = test_record_data(50);
+    rec = mc_parser_parse(parser, str, strlen(str));
+    test_check_record(rec, 50);
+    g_assert_cmpuint(parser->props_alloc, ==, MC_PARSER_MAX_PROPS);
+    g_assert_cmpuint(parser->values_alloc, ==, MC_PARSER_MAX_VALUES);
+    mc_record_free(rec);
+    g_free(str);
+    mc_parser_free(parser);
+}
+
+/* TrimStream */
+
+static
+void
+test_trim_stream(
+    void)
+{
+    McParser* parser = mc_parser_default();
+    McRecordStream* stream = mc_record_stream_new();
+    char* str = test_record_data(1000);
+    const gsize len = strlen(str);
+    McRecord* rec;
+    gsize i;
+
+    /* The stream builds the record with the per-thread parser */
+    for (i = 0; i < len; i += 100) {
+        g_assert(mc_record_stream_feed(stream, str + i, MIN(100, len - i)));
+    }
+    rec = mc_record_stream_finish(stream);
+    test_check_record(rec, 1000);
+    g_assert_cmpuint(parser->props_alloc, <=, MC_PARSER_MAX_PROPS);
+    g_assert_cmpuint(parser->values_alloc, <=, MC_PARSER_MAX_VALUES);
+    mc_record_free(rec);
+    mc_record_stream_free(stream);
+    g_free(str);
+}
+
+/* Threads */
+
+#define TEST_THREADS (4)
+
+static
+gpointer
+test_threads_proc(
+    gpointer data)
+{
+    const guint n_prop = GPOINTER_TO_UINT(data);
+    char* str = test_record_data(n_prop);
+    guint i;
+
+    /* Each thread uses its own default parser */
+    for (i = 0; i < 100; i++) {
+        McRecord* rec = mc_record_parse_data(str, strlen(str));
+
+        test_check_record(rec, n_prop);
+        mc_record_free(rec);
+    }
+    g_free(str);
+    return NULL;
+}
+
+static
+void
+test_threads(
+    void)
+{
+    GThread* thread[TEST_THREADS];
+    guint i;
+
+    for (i = 0; i < TEST_THREADS; i++) {
+        thread[i] = g_thread_new("test", test_threads_proc,
+            GUINT_TO_POINTER(i * 20 + 1));
+    }
+    for (i = 0; i < TEST_THREADS; i++) {
+        g_thread_join(thread[i]);
+    }
+}
+
+/* Common */
+
+#define TEST_(x) "/parser/" x
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("reuse"), test_reuse);
+    g_test_add_func(TEST_("trim"), test_trim);
+    g_test_add_func(TEST_("trim_stream"), test_trim_stream);
+    g_test_add_func(TEST_("threads"), test_threads);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2020 by Slava Monich <slava@monich.com>
+ * Copyright (C) 2020-2026 by Slava Monich <slava@monich.com>
  *
  * You may use this file under the terms of the BSD license as follows:
  *
@@ -147,6 +147,52 @@ test_multiple_values(
     mc_record_free(rec);
 }
 
+/* Many */
+
+static
+void
+test_many(
+    void)
+{
+    GString* buf = g_string_new("id:");
+    McRecord* rec;
+    guint i, k;
+
+    /* Property i has i values (and the first one has none) */
+    for (i = 0; i < 50; i++) {
+        g_string_append_printf(buf, "p%u:", i);
+        for (k = 0; k < i; k++) {
+            g_string_append_printf(buf, "%sv%u\\\\%u", k ? "," : "", i, k);
+        }
+        g_string_append_c(buf, ';');
+    }
+
+    rec = mc_record_parse_data(buf->str, buf->len);
+    g_assert(rec);
+    g_assert_cmpstr(rec->ident, ==, "id");
+    g_assert_cmpuint(rec->n_prop, ==, 50);
+    for (i = 0; i < rec->n_prop; i++) {
+        const McProperty* prop = rec->prop + i;
+        char* name = g_strdup_printf("p%u", i);
+
+        g_assert_cmpstr(prop->name, ==, name);
+        if (i) {
+            for (k = 0; k < i; k++) {
+                char* value = g_strdup_printf("v%u\\%u", i, k);
+
+                g_assert_cmpstr(prop->values[k], ==, value);
+                g_free(value);
+            }
+            g_assert(!prop->values[i]);
+        } else {
+            g_assert(!prop->values);
+        }
+        g_free(name);
+    }
+    mc_record_free(rec);
+    g_string_free(buf, TRUE);
+}
+
 /* UnescapedUrl */
 
 static
@@ -222,7 +268,16 @@ typedef struct test_transform_data {
 
 static const TestTransformData test_shift_jis_data[] = {
     { "\x83\x6e", "\xe3\x83\x8f" },
-    { "\x83\x8d", "\xe3\x83\xad" }
+    { "\x83\x8d", "\xe3\x83\xad" },
+    { "\x83\x6e\x83\x8d", "\xe3\x83\x8f\xe3\x83\xad" },
+    { "\x83\x5c", "\xe3\x82\xbd" }, /* Trail byte is a backslash */
+    { "\x93\xfa\x96\x7b\xe0\x40\xea\xa4",
+      "\xe6\x97\xa5\xe6\x9c\xac\xe6\xbc\xbe\xe7\x86\x99" },
+    { "\x83\x6e" "x" "\x83\x8d", "\xe3\x83\x8f" "x" "\xe3\x83\xad" },
+    { "\x83\x6e\xe3\x83\x8f", "\xe3\x83\x8f\xe3\x83\x8f" }, /* UTF-8 */
+    { "\x83\x6e\x83", "\xe3\x83\x8f\x83" }, /* Incomplete pair */
+    { "\x85\x40", "\x85@" }, /* Unmapped pair, ISO8Bit */
+    { "\xe0\x80\xaf", "\xe7\x83\x99\xaf" } /* Overlong, not UTF-8 */
 };
 
 static const TestTransformData test_escape_data[] = {
@@ -252,6 +307,268 @@ test_transform(
     g_free(str);
 }
 
+/* Lookup */
+
+static
+void
+test_lookup(
+    void)
+{
+    GString* buf = g_string_new("id:N:name;");
+    const McProperty* props[4];
+    McRecord* rec;
+    guint i;
+
+    /* Lots of properties with the same names */
+    for (i = 0; i < 30; i++) {
+        g_string_append_printf(buf, "TEL:%u;EMAIL:%u;X-%u:%u;", i, i, i, i);
+    }
+    rec = mc_record_parse_data(buf->str, buf->len);
+    g_assert(rec);
+    g_assert_cmpuint(rec->n_prop, ==, 91);
+
+    /* NULL resistance */
+    g_assert(!mc_record_lookup(NULL, "N"));
+    g_assert(!mc_record_lookup(rec, NULL));
+    g_assert(!mc_record_lookup_all(NULL, "N", props, G_N_ELEMENTS(props)));
+
+    g_assert(mc_record_lookup(rec, "N") == rec->prop);
+    g_assert(!mc_record_lookup(rec, "X"));
+    g_assert(!mc_record_lookup(rec, "TE"));
+    g_assert(!mc_record_lookup(rec, "TELL"));
+    g_assert(!mc_record_lookup(rec, ""));
+    g_assert(!mc_record_lookup_all(rec, "ADR", NULL, 0));
+    g_assert_cmpuint(mc_record_lookup_all(rec, "N", props, 1), ==, 1);
+    g_assert(props[0] == rec->prop);
+
+    /* In the order of appearance */
+    g_assert_cmpuint(mc_record_lookup_all(rec, "TEL", NULL, 0), ==, 30);
+    g_assert_cmpuint(mc_record_lookup_all(rec, "EMAIL", props,
+        G_N_ELEMENTS(props)), ==, 30);
+    for (i = 0; i < G_N_ELEMENTS(props); i++) {
+        char* value = g_strdup_printf("%u", i);
+
+        g_assert(props[i] == rec->prop + 2 + 3 * i);
+        g_assert_cmpstr(props[i]->values[0], ==, value);
+        g_free(value);
+    }
+    for (i = 0; i < 30; i++) {
+        char* name = g_strdup_printf("X-%u", i);
+
+        g_assert(mc_record_lookup(rec, name) == rec->prop + 3 + 3 * i);
+        g_assert_cmpuint(mc_record_lookup_all(rec, name, NULL, 0), ==, 1);
+        g_free(name);
+    }
+
+    mc_record_free(rec);
+    g_string_free(buf, TRUE);
+}
+
+/* Value lengths */
+
+static
+void
+test_value_lengths(
+    void)
+{
+    static const char str[] = "id:a:x\\\\,yy,\x83\x6e;b:;c:\\:\\;;;";
+    McRecord* rec = mc_record_parse(str);
+    const size_t* len;
+    unsigned int n = 1;
+    guint i, k;
+
+    g_assert(rec);
+    g_assert_cmpuint(rec->n_prop, ==, 3);
+
+    /* NULL resistance */
+    g_assert(!mc_record_value_lengths(NULL, rec->prop, &n));
+    g_assert_cmpuint(n, ==, 0);
+    g_assert(!mc_record_value_lengths(rec, NULL, NULL));
+    g_assert(!mc_record_value_lengths(rec, rec->prop + rec->n_prop, &n));
+
+    /* Lengths match the decoded values */
+    for (i = 0; i < rec->n_prop; i++) {
+        const McProperty* prop = rec->prop + i;
+
+        n = 100;
+        len = mc_record_value_lengths(rec, prop, &n);
+        for (k = 0; prop->values && prop->values[k]; k++) {
+            g_assert_cmpuint(k, <, n);
+            g_assert_cmpuint(len[k], ==, strlen(prop->values[k]));
+        }
+        g_assert_cmpuint(k, ==, n);
+        g_assert(n ? (len != NULL) : (len == NULL));
+    }
+    len = mc_record_value_lengths(rec, rec->prop, &n);
+    g_assert_cmpuint(n, ==, 3);
+    g_assert_cmpuint(len[0], ==, 2);
+    g_assert_cmpuint(len[1], ==, 2);
+    g_assert_cmpuint(len[2], ==, 3);
+    mc_record_free(rec);
+}
+
+/* Charset */
+
+typedef struct test_charset_data {
+    MC_CHARSET charset;
+    const char* in;
+    const char* out;    /* NULL if the record is invalid */
+} TestCharsetData;
+
+static const TestCharsetData test_charset_data[] = {
+    { MC_CHARSET_AUTO, "\x83\x6e", "\xe3\x83\x8f" },
+    { MC_CHARSET_UTF8, "\x83\x6e", NULL },
+    { MC_CHARSET_SHIFT_JIS, "\x83\x6e", "\xe3\x83\x8f" },
+    { MC_CHARSET_LATIN1, "\x83\x6e", "\xc2\x83\x6e" },
+    { MC_CHARSET_AUTO, "\xe3\x83\x8f", "\xe3\x83\x8f" },
+    { MC_CHARSET_UTF8, "\xe3\x83\x8f", "\xe3\x83\x8f" },
+    { MC_CHARSET_SHIFT_JIS, "\xe3\x83\x8f", NULL },
+    { MC_CHARSET_LATIN1, "\xe3\x83\x8f", "\xc3\xa3\xc2\x83\xc2\x8f" },
+    { MC_CHARSET_SHIFT_JIS, "\x93\xfa\x96\x7b\xe0\x40",
+      "\xe6\x97\xa5\xe6\x9c\xac\xe6\xbc\xbe" },
+    { MC_CHARSET_SHIFT_JIS, "\x85\x40", NULL },
+    { MC_CHARSET_UTF8, "x\\,y", "x,y" },
+    { MC_CHARSET_LATIN1, "\xe9t\\\xe9", "\xc3\xa9t\xc3\xa9" },
+    { MC_CHARSET_DETECT, "plain", "plain" },
+    { MC_CHARSET_DETECT, "\x83\x6e", "\xe3\x83\x8f" },
+    { MC_CHARSET_DETECT, "\xe3\x83\x8f", "\xe3\x83\x8f" },
+    { MC_CHARSET_DETECT, "\xe3\x83\x8f\xff", /* Not UTF-8 as a whole */
+      "\xc3\xa3\xc2\x83\xc2\x8f\xc3\xbf" },
+    { MC_CHARSET_DETECT, "\x83\x6e\xe9", "\xc2\x83\x6e\xc3\xa9" }
+};
+
+static
+void
+test_charset(
+    gconstpointer test_data)
+{
+    const TestCharsetData* test = test_data;
+    char* str = g_strconcat("id: test:", test->in, ";;", NULL);
+    McParseOptions opts;
+    McRecord* rec;
+
+    memset(&opts, 0, sizeof(opts));
+    opts.charset = test->charset;
+    rec = mc_record_parse_data_full(str, strlen(str), &opts);
+    if (test->out) {
+        g_assert(rec);
+        g_assert_cmpuint(rec->n_prop, ==, 1);
+        g_assert_cmpstr(rec->prop[0].values[0], ==, test->out);
+        g_assert(!rec->prop[0].values[1]);
+        mc_record_free(rec);
+    } else {
+        g_assert(!rec);
+    }
+    g_free(str);
+}
+
+/* Detect */
+
+static
+void
+test_detect(
+    void)
+{
+    static const struct test_detect_data {
+        const char* in;
+        MC_CHARSET charset;
+    } data[] = {
+        { "", MC_CHARSET_UTF8 },
+        { "id:n:v;;", MC_CHARSET_UTF8 },
+        { "id:a:\xd1\x82;b:\xf0\x9f\x98\x80;;", MC_CHARSET_UTF8 },
+        { "id:a:\x93\xfa;b:\x83\x6e;;", MC_CHARSET_SHIFT_JIS },
+        { "id:a:\x83\x5c\x93\xfa;;", MC_CHARSET_SHIFT_JIS },
+        { "id:a:\xd1\x82;b:\xe9;;", MC_CHARSET_LATIN1 },
+        { "id:a:\x83\x6e;b:\x83", MC_CHARSET_LATIN1 },
+        { "id:a:\xe3;;", MC_CHARSET_LATIN1 }
+    };
+    guint i;
+
+    g_assert_cmpint(mc_record_detect_charset(NULL, 1), ==, MC_CHARSET_UTF8);
+    for (i = 0; i < G_N_ELEMENTS(data); i++) {
+        const char* in = data[i].in;
+
+        g_assert_cmpint(mc_record_detect_charset(in, strlen(in)), ==,
+            data[i].charset);
+    }
+}
+
+/* Limits */
+
+static
+void
+test_limits(
+    void)
+{
+    static const char str[] = "id:a:1,2,3;b:xyz;c:;;";
+    static const char escaped[] = "id:a:\\,\\,\\,;";
+    const gsize len = sizeof(str) - 1;
+    McParseOptions opts;
+    McRecord* rec;
+
+    /* NULL options are the defaults */
+    rec = mc_record_parse_data_full(str, len, NULL);
+    g_assert(rec);
+    g_assert_cmpuint(rec->n_prop, ==, 3);
+    mc_record_free(rec);
+
+    /* Exactly at the limit is fine, one less isn't */
+    memset(&opts, 0, sizeof(opts));
+    opts.max_props = 3;
+    rec = mc_record_parse_data_full(str, len, &opts);
+    g_assert(rec);
+    mc_record_free(rec);
+    opts.max_props = 2;
+    g_assert(!mc_record_parse_data_full(str, len, &opts));
+
+    memset(&opts, 0, sizeof(opts));
+    opts.max_values = 3;
+    rec = mc_record_parse_data_full(str, len, &opts);
+    g_assert(rec);
+    mc_record_free(rec);
+    opts.max_values = 2;
+    g_assert(!mc_record_parse_data_full(str, len, &opts));
+
+    memset(&opts, 0, sizeof(opts));
+    opts.max_value_len = 3;
+    rec = mc_record_parse_data_full(str, len, &opts);
+    g_assert(rec);
+    mc_record_free(rec);
+    opts.max_value_len = 2;
+    g_assert(!mc_record_parse_data_full(str, len, &opts));
+
+    /* id + a + 1 + 2 + 3 + b + xyz + c */
+    memset(&opts, 0, sizeof(opts));
+    opts.max_output = 11;
+    rec = mc_record_parse_data_full(str, len, &opts);
+    g_assert(rec);
+    mc_record_free(rec);
+    opts.max_output = 10;
+    g_assert(!mc_record_parse_data_full(str, len, &opts));
+
+    /* The identifier counts too, even if there's nothing else */
+    memset(&opts, 0, sizeof(opts));
+    opts.max_output = 6;
+    rec = mc_record_parse_data_full("MECARD:;", 8, &opts);
+    g_assert(rec);
+    g_assert_cmpuint(rec->n_prop, ==, 0);
+    mc_record_free(rec);
+    opts.max_output = 1;
+    g_assert(!mc_record_parse_data_full("MECARD:;", 8, &opts));
+
+    /* Decoded length counts, not the raw one */
+    memset(&opts, 0, sizeof(opts));
+    opts.max_value_len = 3;
+    rec = mc_record_parse_data_full(escaped, sizeof(escaped) - 1,
+        &opts);
+    g_assert(rec);
+    g_assert_cmpstr(rec->prop[0].values[0], ==, ",,,");
+    mc_record_free(rec);
+    opts.max_value_len = 2;
+    g_assert(!mc_record_parse_data_full(escaped, sizeof(escaped) - 1,
+        &opts));
+}
+
 /* Common */
 
 #define TEST_(x) "/record/" x
@@ -278,6 +595,11 @@ int main(int argc, char* argv[])
     g_test_add_func(TEST_("basic"), test_basic);
     g_test_add_func(TEST_("empty_value"), test_empty_value);
     g_test_add_func(TEST_("multiple_values"), test_multiple_values);
+    g_test_add_func(TEST_("many"), test_many);
+    g_test_add_func(TEST_("lookup"), test_lookup);
+    g_test_add_func(TEST_("value_lengths"), test_value_lengths);
+    g_test_add_func(TEST_("detect"), test_detect);
+    g_test_add_func(TEST_("limits"), test_limits);
     g_test_add_func(TEST_("unescaped_url"), test_unescaped_url);
     g_test_add_func(TEST_("valid_utf8"), test_valid_utf8);
     g_test_add_data_func(TEST_("invalid_utf8/1"),"\xD1", test_invalid_utf8);
@@ -296,6 +618,12 @@ int main(int argc, char* argv[])
         g_test_add_data_func(name, test_escape_data + i, test_transform);
         g_free(name);
     }
+    for (i = 0; i < G_N_ELEMENTS(test_charset_data); i++) {
+        char* name = g_strdup_printf(TEST_("charset/%u"), i + 1);
+
+        g_test_add_data_func(name, test_charset_data + i, test_charset);
+        g_free(name);
+    }
     return g_test_run();
 }
 
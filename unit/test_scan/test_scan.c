@@ -0,0 +1,359 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_scan.h"
+#include "mc_stats.h"
+
+#include <glib.h>
+
+typedef struct test_scan_log {
+    GString* buf;
+    guint events;
+    guint stop_at;
+} TestScanLog;
+
+static
+int
+test_scan_event(
+    TestScanLog* log)
+{
+    return ++log->events != log->stop_at;
+}
+
+static
+int
+test_scan_ident(
+    const char* ident,
+    size_t len,
+    void* user_data)
+{
+    TestScanLog* log = user_data;
+
+    g_string_append_printf(log->buf, "I(%.*s)", (int)len, ident);
+    return test_scan_event(log);
+}
+
+static
+int
+test_scan_property_begin(
+    const char* name,
+    size_t len,
+    void* user_data)
+{
+    TestScanLog* log = user_data;
+
+    g_string_append_printf(log->buf, "P(%.*s)", (int)len, name);
+    return test_scan_event(log);
+}
+
+static
+int
+test_scan_value(
+    const char* ptr,
+    size_t len,
+    int needs_unescape,
+    void* user_data)
+{
+    TestScanLog* log = user_data;
+
+    g_string_append_printf(log->buf, "V%s(%.*s)", needs_unescape ? "*" : "",
+        (int)len, ptr);
+    return test_scan_event(log);
+}
+
+static
+int
+test_scan_property_end(
+    void* user_data)
+{
+    TestScanLog* log = user_data;
+
+    g_string_append(log->buf, "E");
+    return test_scan_event(log);
+}
+
+static const McScanCallbacks test_scan_cb = {
+    test_scan_ident,
+    test_scan_property_begin,
+    test_scan_value,
+    test_scan_property_end
+};
+
+/* Null */
+
+static
+void
+test_null(
+    void)
+{
+    static const char str[] = "id:name:value;;";
+
+    /* NULL resistance */
+    g_assert(!mc_record_scan(NULL, 0, &test_scan_cb, NULL));
+    g_assert(!mc_scan_unescape(NULL, 0, NULL, 0));
+
+    /* Without callbacks the data is just validated */
+    g_assert(mc_record_scan(str, sizeof(str) - 1, NULL, NULL));
+    g_assert(!mc_record_scan(str, 4, NULL, NULL));
+}
+
+/* Basic */
+
+static
+void
+test_basic(
+    void)
+{
+    static const char str[] = " id : a:x,\\,y,,z; URL:http://x;"
+        "b:\x83\x6e;c:;;";
+    TestScanLog log;
+
+    memset(&log, 0, sizeof(log));
+    log.buf = g_string_new(NULL);
+    g_assert(mc_record_scan(str, sizeof(str) - 1, &test_scan_cb, &log));
+    g_assert_cmpstr(log.buf->str, ==, "I(id)P(a)V(x)V*(\\,y)V(z)E"
+        "P(URL)V(http://x)EP(b)V*(\x83\x6e)EP(c)E");
+    g_string_free(log.buf, TRUE);
+}
+
+/* Stop */
+
+static
+void
+test_stop(
+    void)
+{
+    static const char str[] = "id:a:x,y;b:z;;";
+    const guint total = 8; /* I P V V E P V E */
+    guint i;
+
+    for (i = 1; i <= total + 1; i++) {
+        TestScanLog log;
+
+        memset(&log, 0, sizeof(log));
+        log.buf = g_string_new(NULL);
+        log.stop_at = i;
+        if (i <= total) {
+            /* Stopped, no more events after that */
+            g_assert(!mc_record_scan(str, sizeof(str) - 1, &test_scan_cb,
+                &log));
+            g_assert_cmpuint(log.events, ==, i);
+        } else {
+            g_assert(mc_record_scan(str, sizeof(str) - 1, &test_scan_cb,
+                &log));
+            g_assert_cmpuint(log.events, ==, total);
+        }
+        g_string_free(log.buf, TRUE);
+    }
+}
+
+/* Invalid */
+
+static
+void
+test_invalid(
+    void)
+{
+    static const char str[] = "id:a:x;b:y:z;;";
+    TestScanLog log;
+
+    /* Events are reported until the problem is detected */
+    memset(&log, 0, sizeof(log));
+    log.buf = g_string_new(NULL);
+    g_assert(!mc_record_scan(str, sizeof(str) - 1, &test_scan_cb, &log));
+    g_assert_cmpstr(log.buf->str, ==, "I(id)P(a)V(x)EP(b)V(y)E");
+    g_string_free(log.buf, TRUE);
+}
+
+/* Unescape */
+
+static
+void
+test_unescape(
+    void)
+{
+    static const struct test_unescape_data {
+        const char* in;
+        const char* out;
+    } data[] = {
+        { "plain", "plain" },
+        { "a\\,b\\;c\\:d\\\\e", "a,b;c:d\\e" },
+        { "\x83\x6e\x83\x8d", "\xe3\x83\x8f\xe3\x83\xad" },
+        { "http://x", "http://x" }
+    };
+    char buf[32];
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS(data); i++) {
+        const char* in = data[i].in;
+        const gsize len = strlen(data[i].out);
+
+        /* Measure first, then decode */
+        g_assert_cmpuint(mc_scan_unescape(in, strlen(in), NULL, 0), ==, len);
+        g_assert_cmpuint(mc_scan_unescape(in, strlen(in), buf, len - 1), ==,
+            len);
+        memset(buf, 0, sizeof(buf));
+        g_assert_cmpuint(mc_scan_unescape(in, strlen(in), buf, sizeof(buf)),
+            ==, len);
+        g_assert_cmpstr(buf, ==, data[i].out);
+    }
+}
+
+/* Extract */
+
+static
+void
+test_extract(
+    void)
+{
+    static const char mecard[] = "MECARD:N:Doe\\,John;TEL:;TEL:+123,+456;"
+        "EMAIL:\x83\x6e@example.com;NOTE:x;garbage";
+    static const char mebkm[] = "MEBKM:TITLE:Example;URL:http://x.com;;";
+    /* Katakana SO (U+30BD) in Shift-JIS, its trail byte is a backslash */
+    static const char sjis[] = "MECARD:N:\x83\x5c;TEL:123;;";
+    const gsize len = sizeof(mecard) - 1;
+    char buf[32];
+
+    /* NULL resistance */
+    g_assert(!mc_extract_value(NULL, 0, "TEL", buf, sizeof(buf)));
+    g_assert(!mc_extract_value(mecard, len, NULL, buf, sizeof(buf)));
+
+    /* The first non-empty value */
+    g_assert_cmpuint(mc_extract_value(mecard, len, "TEL", buf, sizeof(buf)),
+        ==, 4);
+    g_assert_cmpstr(buf, ==, "+123");
+    g_assert_cmpuint(mc_extract_value(mecard, len, "N", buf, sizeof(buf)),
+        ==, 8);
+    g_assert_cmpstr(buf, ==, "Doe,John");
+    g_assert_cmpuint(mc_extract_value(mecard, len, "EMAIL", buf,
+        sizeof(buf)), ==, 15);
+    g_assert_cmpstr(buf, ==, "\xe3\x83\x8f@example.com");
+    g_assert_cmpuint(mc_extract_value(mebkm, sizeof(mebkm) - 1, "URL", buf,
+        sizeof(buf)), ==, 12);
+    g_assert_cmpstr(buf, ==, "http://x.com");
+
+    /* Skipping a value doesn't take a Shift-JIS trail byte for escape */
+    g_assert_cmpuint(mc_extract_value(sjis, sizeof(sjis) - 1, "TEL", buf,
+        sizeof(buf)), ==, 3);
+    g_assert_cmpstr(buf, ==, "123");
+    g_assert_cmpuint(mc_extract_value(sjis, sizeof(sjis) - 1, "N", buf,
+        sizeof(buf)), ==, 3);
+    g_assert_cmpstr(buf, ==, "\xe3\x82\xbd");
+
+    /* The malformed part of the record is never reached */
+    g_assert(!mc_record_scan(mecard, len, NULL, NULL));
+    g_assert_cmpuint(mc_extract_value(mecard, len, "NOTE", buf, sizeof(buf)),
+        ==, 1);
+    g_assert_cmpstr(buf, ==, "x");
+
+    /* No such property, or the record is malformed before it */
+    g_assert(!mc_extract_value(mecard, len, "ADR", buf, sizeof(buf)));
+    g_assert(!mc_extract_value(mecard, len, "TE", buf, sizeof(buf)));
+    g_assert(!mc_extract_value(mecard, len, "garbage", buf, sizeof(buf)));
+    g_assert(!mc_extract_value(mecard, len, "MECARD", buf, sizeof(buf)));
+
+    /* Doesn't fit */
+    strcpy(buf, "x");
+    g_assert_cmpuint(mc_extract_value(mecard, len, "TEL", buf, 4), ==, 4);
+    g_assert_cmpstr(buf, ==, "x");
+    g_assert_cmpuint(mc_extract_value(mecard, len, "TEL", NULL, 0), ==, 4);
+}
+
+/* Extract skip */
+
+static
+void
+test_extract_skip(
+    void)
+{
+    static const char str1[] = "id:A:x\\;y:z\x01,w\\\\;y:Y;B:b;;";
+    static const char str2[] = "id:A:a\\\\\\;b;B:c;;";
+    McStats stats;
+    char buf[8];
+    guint i, n;
+
+    /* Values of other properties are jumped over, not validated */
+    g_assert(!mc_record_scan(str1, sizeof(str1) - 1, NULL, NULL));
+    g_assert_cmpuint(mc_extract_value(str1, sizeof(str1) - 1, "B", buf,
+        sizeof(buf)), ==, 1);
+    g_assert_cmpstr(buf, ==, "b");
+    g_assert_cmpuint(mc_extract_value(str1, sizeof(str1) - 1, "y", buf,
+        sizeof(buf)), ==, 1);
+    g_assert_cmpstr(buf, ==, "Y");
+
+    /* Odd number of backslashes escapes the separator */
+    g_assert_cmpuint(mc_extract_value(str2, sizeof(str2) - 1, "B", buf,
+        sizeof(buf)), ==, 1);
+    g_assert_cmpstr(buf, ==, "c");
+    g_assert(!mc_extract_value(str2, sizeof(str2) - 1, "b", buf,
+        sizeof(buf)));
+
+    /* Extract isn't counted in the statistics at all */
+    mc_stats_enable(TRUE);
+    mc_stats_reset();
+    g_assert(mc_extract_value(str1, sizeof(str1) - 1, "B", NULL, 0));
+    mc_stats_get(&stats);
+    mc_stats_enable(FALSE);
+    for (i = 0, n = 0; i < MC_STATS_PATH_COUNT; i++) {
+        n += stats.values[i];
+    }
+    g_assert_cmpuint(n, ==, 0);
+}
+
+/* Common */
+
+#define TEST_(x) "/scan/" x
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("basic"), test_basic);
+    g_test_add_func(TEST_("stop"), test_stop);
+    g_test_add_func(TEST_("invalid"), test_invalid);
+    g_test_add_func(TEST_("unescape"), test_unescape);
+    g_test_add_func(TEST_("extract"), test_extract);
+    g_test_add_func(TEST_("extract_skip"), test_extract_skip);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
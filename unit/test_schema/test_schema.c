@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_matmsg.h"
+#include "mc_mebkm.h"
+#include "mc_mecard.h"
+#include "mc_meloc.h"
+#include "mc_wifi.h"
+
+#include <glib.h>
+
+/* Null */
+
+static
+void
+test_null(
+    void)
+{
+    /* NULL resistance */
+    g_assert(!mebkm_parse(NULL));
+    g_assert(!matmsg_parse(NULL));
+    g_assert(!meloc_parse(NULL));
+    g_assert(!wifi_parse(NULL));
+    g_assert(!mebkm_parse_data(NULL, 0));
+    g_assert(!matmsg_parse_data(NULL, 0));
+    g_assert(!meloc_parse_data(NULL, 0));
+    g_assert(!wifi_parse_data(NULL, 0));
+    mebkm_free(NULL);
+    matmsg_free(NULL);
+    meloc_free(NULL);
+    wifi_free(NULL);
+}
+
+/* Ident */
+
+static
+void
+test_ident(
+    void)
+{
+    /* Only the matching identifier is accepted */
+    g_assert(!mebkm_parse("MEBKM"));
+    g_assert(!mebkm_parse("MEBKMX:TITLE:x;;"));
+    g_assert(!mebkm_parse("MECARD:N:x;;"));
+    g_assert(!matmsg_parse("MEBKM:TITLE:x;;"));
+    g_assert(!meloc_parse("WIFI:S:x;;"));
+    g_assert(!wifi_parse("MATMSG:TO:x;;"));
+    g_assert(!mecard_parse("WIFI:S:x;;"));
+
+    /* Malformed */
+    g_assert(!mebkm_parse("MEBKM:TITLE:x:y;;"));
+    g_assert(!wifi_parse("WIFI:S:x\\"));
+}
+
+/* Bookmark */
+
+static
+void
+test_mebkm(
+    void)
+{
+    MeBkm* bkm = mebkm_parse(" MEBKM:TITLE:Example\\, Inc.;"
+        "URL:http\\://example.com;;");
+
+    g_assert(bkm);
+    g_assert_cmpstr(bkm->title, ==, "Example, Inc.");
+    g_assert_cmpstr(bkm->url, ==, "http://example.com");
+    mebkm_free(bkm);
+
+    /* Unescaped ':' is only allowed in URL */
+    bkm = mebkm_parse("MEBKM:URL:http://example.com;;");
+    g_assert(bkm);
+    g_assert(!bkm->title);
+    g_assert_cmpstr(bkm->url, ==, "http://example.com");
+    mebkm_free(bkm);
+}
+
+/* Message */
+
+static
+void
+test_matmsg(
+    void)
+{
+    MatMsg* msg = matmsg_parse("MATMSG:TO:a@example.com,b@example.com;"
+        "SUB:;SUB:Hi;BODY:\x83\x6e,x,,y;X-FOO:bar;SUB:Bye;TO:c@x;;");
+
+    /* All recipients are there, unknown properties are ignored */
+    g_assert(msg);
+    g_assert(msg->to);
+    g_assert_cmpstr(msg->to[0], ==, "a@example.com");
+    g_assert_cmpstr(msg->to[1], ==, "b@example.com");
+    g_assert_cmpstr(msg->to[2], ==, "c@x");
+    g_assert(!msg->to[3]);
+
+    /* The first non-empty property wins, unescaped commas are kept */
+    g_assert_cmpstr(msg->sub, ==, "Hi");
+    g_assert_cmpstr(msg->body, ==, "\xe3\x83\x8f,x,y");
+    matmsg_free(msg);
+
+    msg = matmsg_parse("MATMSG:;");
+    g_assert(msg);
+    g_assert(!msg->to);
+    g_assert(!msg->sub);
+    g_assert(!msg->body);
+    matmsg_free(msg);
+}
+
+/* Location */
+
+static
+void
+test_meloc(
+    void)
+{
+    static const char str[] = "MELOC:LAT:35.6586;LNG:139.7454;"
+        "NAME:Tokyo Tower;";
+    MeLoc* loc = meloc_parse_data(str, sizeof(str) - 1);
+
+    g_assert(loc);
+    g_assert_cmpstr(loc->lat, ==, "35.6586");
+    g_assert_cmpstr(loc->lng, ==, "139.7454");
+    g_assert(!loc->alt);
+    g_assert_cmpstr(loc->name, ==, "Tokyo Tower");
+    meloc_free(loc);
+}
+
+/* Wi-Fi */
+
+static
+void
+test_wifi(
+    void)
+{
+    WiFi* wifi = wifi_parse("WIFI:T:WPA;S:My\\;Net;P:p\\:ss;H:true;;");
+
+    g_assert(wifi);
+    g_assert_cmpstr(wifi->type, ==, "WPA");
+    g_assert_cmpstr(wifi->ssid, ==, "My;Net");
+    g_assert_cmpstr(wifi->password, ==, "p:ss");
+    g_assert_cmpstr(wifi->hidden, ==, "true");
+    wifi_free(wifi);
+
+    /* Unescaped commas are part of the value */
+    wifi = wifi_parse("WIFI:S:a,b;P:1,2,3;;");
+    g_assert(wifi);
+    g_assert_cmpstr(wifi->ssid, ==, "a,b");
+    g_assert_cmpstr(wifi->password, ==, "1,2,3");
+    g_assert(!wifi->type);
+    wifi_free(wifi);
+}
+
+/* MeCard */
+
+static
+void
+test_mecard(
+    void)
+{
+    MeCard* mecard = mecard_parse("MECARD:TEL:1,2;X:y;N:Doe;TEL:;TEL:3;;");
+
+    /* All occurrences are combined */
+    g_assert(mecard);
+    g_assert_cmpstr(mecard->n[0], ==, "Doe");
+    g_assert(!mecard->n[1]);
+    g_assert_cmpstr(mecard->tel[0], ==, "1");
+    g_assert_cmpstr(mecard->tel[1], ==, "2");
+    g_assert_cmpstr(mecard->tel[2], ==, "3");
+    g_assert(!mecard->tel[3]);
+    g_assert(!mecard->email);
+    mecard_free(mecard);
+}
+
+/* Common */
+
+#define TEST_(x) "/schema/" x
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("ident"), test_ident);
+    g_test_add_func(TEST_("mebkm"), test_mebkm);
+    g_test_add_func(TEST_("matmsg"), test_matmsg);
+    g_test_add_func(TEST_("meloc"), test_meloc);
+    g_test_add_func(TEST_("wifi"), test_wifi);
+    g_test_add_func(TEST_("mecard"), test_mecard);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_mebkm.h"
+#include "mc_mecard.h"
+#include "mc_record.h"
+#include "mc_scan.h"
+#include "mc_stats.h"
+
+#include <glib.h>
+
+static
+guint64
+test_stats_calls(
+    const McStats* stats,
+    MC_STATS_ENTRY entry)
+{
+    guint64 n = 0;
+    guint i;
+
+    for (i = 0; i < MC_STATS_LATENCY_BUCKETS; i++) {
+        n += stats->latency[entry][i];
+    }
+    return n;
+}
+
+/* Disabled */
+
+static
+void
+test_disabled(
+    void)
+{
+    McStats stats;
+
+    mc_stats_get(NULL);
+    mc_stats_enable(FALSE);
+    g_assert(!mc_stats_enabled());
+    mc_stats_reset();
+    mc_record_free(mc_record_parse("id:n:v;;"));
+    mecard_free(mecard_parse("x"));
+
+    /* Nothing has been counted */
+    memset(&stats, 0xff, sizeof(stats));
+    mc_stats_get(&stats);
+    g_assert(!stats.records);
+    g_assert(!stats.bytes);
+    g_assert(!stats.failures[MC_STATS_FAIL_NO_IDENT]);
+    g_assert(!stats.values[MC_STATS_PATH_ASCII]);
+    g_assert(!test_stats_calls(&stats, MC_STATS_ENTRY_RECORD));
+}
+
+/* Failures */
+
+static
+void
+test_failures(
+    void)
+{
+    McStats stats;
+    guint64 n;
+    guint i;
+
+    mc_stats_enable(TRUE);
+    mc_stats_reset();
+    g_assert(!mc_record_parse(""));
+    g_assert(!mc_record_parse("  id"));
+    g_assert(!mc_record_parse("i d:n:v;"));
+    g_assert(!mc_record_parse("id:n:v;garbage"));
+    g_assert(!mecard_parse("MEBKM:TITLE:x;;"));
+    g_assert(!mecard_parse("MECARDX:N:x;;"));
+    g_assert(!mecard_parse("   "));
+    g_assert(!mebkm_parse("MECARD:N:x;;"));
+    g_assert(!mc_record_scan("id:n:a:b", 8, NULL, NULL));
+
+    /* Not entry points, not counted */
+    g_assert(!mc_extract_value("i d:n:v;", 8, "n", NULL, 0));
+    g_assert(!mc_extract_value("id:n:a:b", 8, "x", NULL, 0));
+    mc_stats_get(&stats);
+    mc_stats_enable(FALSE);
+
+    g_assert_cmpuint(stats.records, ==, 0);
+    g_assert_cmpuint(stats.bytes, ==, 0 + 4 + 8 + 14 + 15 + 13 + 3 + 12 + 8);
+    g_assert_cmpuint(stats.failures[MC_STATS_FAIL_NO_IDENT], ==, 3);
+    g_assert_cmpuint(stats.failures[MC_STATS_FAIL_BAD_IDENT], ==, 1);
+    g_assert_cmpuint(stats.failures[MC_STATS_FAIL_TRAILING_GARBAGE], ==, 2);
+    g_assert_cmpuint(stats.failures[MC_STATS_FAIL_WRONG_IDENT], ==, 3);
+    g_assert_cmpuint(test_stats_calls(&stats, MC_STATS_ENTRY_RECORD), ==, 4);
+    g_assert_cmpuint(test_stats_calls(&stats, MC_STATS_ENTRY_MECARD), ==, 3);
+    g_assert_cmpuint(test_stats_calls(&stats, MC_STATS_ENTRY_TYPED), ==, 1);
+    g_assert_cmpuint(test_stats_calls(&stats, MC_STATS_ENTRY_SCAN), ==, 1);
+
+    /* Every failed call has exactly one reason */
+    for (i = 0, n = 0; i < MC_STATS_FAIL_COUNT; i++) {
+        n += stats.failures[i];
+    }
+    for (i = 0; i < MC_STATS_ENTRY_COUNT; i++) {
+        n -= test_stats_calls(&stats, i);
+    }
+    g_assert_cmpuint(n, ==, 0);
+}
+
+/* Paths */
+
+static
+void
+test_paths(
+    void)
+{
+    static const char str[] = "id:a:plain,\\,escaped;"
+        "b:\xD1\x82\xD0\xB5\xD1\x81\xD1\x82,\x83\x6e,x\xe3\x83\x8f\x83\x6e;"
+        "c:\xe9t\xe9,\x83\x6e\xff;;";
+    McStats stats;
+    McRecord* rec;
+
+    mc_stats_enable(TRUE);
+    mc_stats_reset();
+    rec = mc_record_parse_data(str, sizeof(str) - 1);
+    g_assert(rec);
+    mc_record_free(rec);
+    mc_stats_get(&stats);
+    mc_stats_enable(FALSE);
+
+    g_assert_cmpuint(stats.records, ==, 1);
+    g_assert_cmpuint(stats.bytes, ==, sizeof(str) - 1);
+    g_assert_cmpuint(stats.values[MC_STATS_PATH_ASCII], ==, 2);
+    g_assert_cmpuint(stats.values[MC_STATS_PATH_UTF8], ==, 1);
+    g_assert_cmpuint(stats.values[MC_STATS_PATH_SHIFT_JIS], ==, 2);
+    g_assert_cmpuint(stats.values[MC_STATS_PATH_ISO8BIT], ==, 2);
+    g_assert_cmpuint(test_stats_calls(&stats, MC_STATS_ENTRY_RECORD), ==, 1);
+
+    /* Reset */
+    mc_stats_reset();
+    mc_stats_get(&stats);
+    g_assert(!stats.records);
+    g_assert(!stats.values[MC_STATS_PATH_UTF8]);
+}
+
+/* Threads */
+
+static
+gpointer
+test_threads_proc(
+    gpointer data)
+{
+    guint i;
+
+    for (i = 0; i < 10; i++) {
+        mecard_free(mecard_parse("MECARD:N:x;;"));
+    }
+    return NULL;
+}
+
+static
+void
+test_threads(
+    void)
+{
+    GThread* thread[4];
+    McStats stats;
+    guint i;
+
+    mc_stats_enable(TRUE);
+    mc_stats_reset();
+    for (i = 0; i < G_N_ELEMENTS(thread); i++) {
+        thread[i] = g_thread_new("test", test_threads_proc, NULL);
+    }
+    test_threads_proc(NULL);
+    for (i = 0; i < G_N_ELEMENTS(thread); i++) {
+        g_thread_join(thread[i]);
+    }
+    mc_stats_enable(FALSE);
+
+    /* The counts of the finished threads are still there */
+    mc_stats_get(&stats);
+    g_assert_cmpuint(stats.records, ==, 50);
+    g_assert_cmpuint(stats.values[MC_STATS_PATH_ASCII], ==, 50);
+    g_assert_cmpuint(test_stats_calls(&stats, MC_STATS_ENTRY_MECARD), ==, 50);
+    mc_stats_reset();
+}
+
+/* ResetRace */
+
+typedef struct test_reset_race {
+    gint stop;
+    gint done;
+} TestResetRace;
+
+static
+gpointer
+test_reset_race_proc(
+    gpointer data)
+{
+    TestResetRace* test = data;
+
+    while (!g_atomic_int_get(&test->stop)) {
+        mc_record_free(mc_record_parse("id:a:b;;"));
+        g_atomic_int_inc(&test->done);
+    }
+    return NULL;
+}
+
+static
+void
+test_reset_race(
+    void)
+{
+    TestResetRace test;
+    GThread* thread;
+    McStats stats;
+    gint before = 0;
+    guint i;
+
+    memset(&test, 0, sizeof(test));
+    mc_stats_enable(TRUE);
+    thread = g_thread_new("test", test_reset_race_proc, &test);
+    for (i = 0; i < 1000; i++) {
+        before = g_atomic_int_get(&test.done);
+        mc_stats_reset();
+    }
+    g_atomic_int_set(&test.stop, TRUE);
+    g_thread_join(thread);
+    mc_stats_enable(FALSE);
+
+    /* Nothing counted before the last reset, except the call in flight */
+    mc_stats_get(&stats);
+    g_assert_cmpuint(stats.records, <=, test.done - before + 1);
+    mc_stats_reset();
+}
+
+/* Common */
+
+#define TEST_(x) "/stats/" x
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("disabled"), test_disabled);
+    g_test_add_func(TEST_("failures"), test_failures);
+    g_test_add_func(TEST_("paths"), test_paths);
+    g_test_add_func(TEST_("threads"), test_threads);
+    g_test_add_func(TEST_("reset_race"), test_reset_race);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_stream.h"
+#include "mc_record.h"
+
+#include <glib.h>
+
+static
+void
+test_record_compare(
+    const McRecord* r1,
+    const McRecord* r2)
+{
+    guint i, k;
+
+    g_assert(!r1 == !r2);
+    if (r1) {
+        g_assert_cmpstr(r1->ident, ==, r2->ident);
+        g_assert_cmpuint(r1->n_prop, ==, r2->n_prop);
+        for (i = 0; i < r1->n_prop; i++) {
+            const McProperty* p1 = r1->prop + i;
+            const McProperty* p2 = r2->prop + i;
+
+            g_assert_cmpstr(p1->name, ==, p2->name);
+            g_assert(!p1->values == !p2->values);
+            if (p1->values) {
+                for (k = 0; p1->values[k]; k++) {
+                    g_assert_cmpstr(p1->values[k], ==, p2->values[k]);
+                }
+                g_assert(!p2->values[k]);
+            }
+        }
+    }
+}
+
+/* Null */
+
+static
+void
+test_null(
+    void)
+{
+    McRecordStream* stream = mc_record_stream_new();
+
+    /* NULL resistance */
+    g_assert(!mc_record_stream_feed(NULL, "x:", 2));
+    g_assert(!mc_record_stream_feed(stream, NULL, 1));
+    g_assert(mc_record_stream_feed(stream, NULL, 0));
+    g_assert(!mc_record_stream_finish(NULL));
+    g_assert(!mc_record_stream_finish(stream));
+    mc_record_stream_free(stream);
+    mc_record_stream_free(NULL);
+}
+
+/* Error */
+
+static
+void
+test_error(
+    void)
+{
+    McRecordStream* stream = mc_record_stream_new();
+
+    /* The error is detected as soon as the offending byte arrives */
+    g_assert(mc_record_stream_feed(stream, "id: name", 8));
+    g_assert(!mc_record_stream_feed(stream, " ", 1));
+    g_assert(!mc_record_stream_feed(stream, ":value;", 7));
+    g_assert(!mc_record_stream_finish(stream));
+
+    /* The stream is reusable after finish */
+    g_assert(mc_record_stream_feed(stream, "id: name:", 9));
+    g_assert(!mc_record_stream_feed(stream, "value:", 6));
+    g_assert(!mc_record_stream_finish(stream));
+    mc_record_stream_free(stream);
+}
+
+/* Done */
+
+static
+void
+test_done(
+    void)
+{
+    McRecordStream* stream = mc_record_stream_new();
+    McRecord* rec;
+
+    /* Whatever follows the terminator is ignored */
+    g_assert(mc_record_stream_feed(stream, "id:name:value;", 14));
+    g_assert(mc_record_stream_feed(stream, ";", 1));
+    g_assert(mc_record_stream_feed(stream, "garbage", 7));
+    rec = mc_record_stream_finish(stream);
+    g_assert(rec);
+    g_assert_cmpstr(rec->ident, ==, "id");
+    g_assert_cmpuint(rec->n_prop, ==, 1);
+    g_assert_cmpstr(rec->prop[0].name, ==, "name");
+    g_assert_cmpstr(rec->prop[0].values[0], ==, "value");
+    g_assert(!rec->prop[0].values[1]);
+    mc_record_free(rec);
+    mc_record_stream_free(stream);
+}
+
+/* Split */
+
+static const char* test_split_data[] = {
+    "id:name-0:value_0;name-1:value_1;;",
+    " foo-bar: name0:value; name1:;;",
+    " id: name:value0,,value1,",
+    " test: URL:http://example.com;;",
+    " test: UR:http://example.com;;",
+    "id :n:\r\nv;;",
+    "foo:",
+    "fo o:",
+    ":n:v",
+    "  \t",
+    "id:n:\xD1\x82\xD0\xB5\xD1\x81\xD1\x82;;",
+    "id:n:\xF0\x9F\x98\x80\xE3\x83\x8F;",
+    "id:n:\x83\x6e\x83\x8d\x83\x5c,\x93\xfa\x96\x7b\xe0\x40;",
+    "id:n:\x83\x6e\xe3\x83\x8f\x83;",
+    "id:n:\xe0\x80\xaf\xed\xa0\x80\xc0;",
+    "id:n:\xe3\x83",
+    "id:n:\x83",
+    "id:n:back\\\\slash\\;\\,\\:\\.;",
+    "id:n:\\\x83\x5c\\\xD1\x82;",
+    "id:n:dangling\\",
+    "id:n:bad\\\x01;",
+    "id:n:v\t ;garbage",
+    "id:n:v;garbage",
+    "id:n:v:x;"
+};
+
+static
+void
+test_split(
+    gconstpointer test_data)
+{
+    const char* str = test_data;
+    const gsize len = strlen(str);
+    McRecord* expected = mc_record_parse_data(str, len);
+    McRecordStream* stream = mc_record_stream_new();
+    McRecord* rec;
+    gsize i, k;
+
+    /* Every possible split point */
+    for (i = 0; i <= len; i++) {
+        mc_record_stream_feed(stream, str, i);
+        mc_record_stream_feed(stream, str + i, len - i);
+        rec = mc_record_stream_finish(stream);
+        test_record_compare(expected, rec);
+        mc_record_free(rec);
+    }
+
+    /* One byte at a time, then two bytes at a time with an offset */
+    for (i = 0; i < len; i++) {
+        mc_record_stream_feed(stream, str + i, 1);
+    }
+    rec = mc_record_stream_finish(stream);
+    test_record_compare(expected, rec);
+    mc_record_free(rec);
+    for (k = 0; k < 2; k++) {
+        mc_record_stream_feed(stream, str, k);
+        for (i = k; i < len; i += 2) {
+            mc_record_stream_feed(stream, str + i, MIN(2, len - i));
+        }
+        rec = mc_record_stream_finish(stream);
+        test_record_compare(expected, rec);
+        mc_record_free(rec);
+    }
+
+    mc_record_free(expected);
+    mc_record_stream_free(stream);
+}
+
+/* Long */
+
+static
+void
+test_long(
+    void)
+{
+    GString* buf = g_string_new("id:");
+    McRecordStream* stream = mc_record_stream_new();
+    McRecord* expected;
+    McRecord* rec;
+    gsize i, chunk;
+
+    for (i = 0; i < 100; i++) {
+        g_string_append_printf(buf, "p%u:value %u\\, \xD1\x82\xD0\xB5"
+            "\x83\x6e\x83\x8d\xe3\x83\x8f\\\\,second;", (guint)i, (guint)i);
+    }
+    expected = mc_record_parse_data(buf->str, buf->len);
+    g_assert(expected);
+    g_assert_cmpuint(expected->n_prop, ==, 100);
+
+    /* Chunks of various sizes */
+    for (chunk = 1; chunk < 40; chunk++) {
+        for (i = 0; i < buf->len; i += chunk) {
+            g_assert(mc_record_stream_feed(stream, buf->str + i,
+                MIN(chunk, buf->len - i)));
+        }
+        rec = mc_record_stream_finish(stream);
+        test_record_compare(expected, rec);
+        mc_record_free(rec);
+    }
+
+    mc_record_free(expected);
+    mc_record_stream_free(stream);
+    g_string_free(buf, TRUE);
+}
+
+/* Common */
+
+#define TEST_(x) "/stream/" x
+
+int main(int argc, char* argv[])
+{
+    guint i;
+
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("error"), test_error);
+    g_test_add_func(TEST_("done"), test_done);
+    g_test_add_func(TEST_("long"), test_long);
+    for (i = 0; i < G_N_ELEMENTS(test_split_data); i++) {
+        char* name = g_strdup_printf(TEST_("split/%u"), i + 1);
+
+        g_test_add_data_func(name, test_split_data[i], test_split);
+        g_free(name);
+    }
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2026 by Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "mc_view.h"
+#include "mc_record.h"
+
+#include <glib.h>
+
+static
+void
+test_assert_slice(
+    const McStrSlice* slice,
+    const char* str)
+{
+    g_assert(slice->ptr);
+    g_assert_cmpuint(slice->len, ==, strlen(str));
+    g_assert(!memcmp(slice->ptr, str, slice->len));
+}
+
+/* Null */
+
+static
+void
+test_null(
+    void)
+{
+    const char empty[] = "";
+
+    /* NULL resistance */
+    g_assert(!mc_record_view_parse(NULL, 0));
+    g_assert(!mc_record_view_parse(empty, 0));
+    g_assert(!mc_record_view_parse_bytes(NULL));
+    mc_record_view_free(NULL);
+}
+
+/* Failure */
+
+static
+void
+test_failure(
+    gconstpointer str)
+{
+    g_assert(!mc_record_view_parse(str, strlen(str)));
+}
+
+/* Basic */
+
+static
+void
+test_basic(
+    void)
+{
+    const char str[] = " id :name-0:value_0;name-1:value_1,,x;name-2:;;";
+    McRecordView* view = mc_record_view_parse(str, sizeof(str) - 1);
+    const McPropertyView* prop;
+
+    g_assert(view);
+    test_assert_slice(&view->ident, "id");
+    g_assert(view->ident.ptr == str + 1);
+    g_assert_cmpuint(view->n_prop, ==, 3);
+
+    prop = view->prop;
+    test_assert_slice(&prop->name, "name-0");
+    g_assert(prop->name.ptr == str + 5);
+    g_assert_cmpuint(prop->n_values, ==, 1);
+    test_assert_slice(prop->values, "value_0");
+    g_assert(prop->values[0].ptr == str + 12);
+
+    prop++;
+    test_assert_slice(&prop->name, "name-1");
+    g_assert_cmpuint(prop->n_values, ==, 2);
+    test_assert_slice(prop->values + 0, "value_1");
+    test_assert_slice(prop->values + 1, "x");
+    g_assert(prop->values[1].ptr == str + 36);
+
+    prop++;
+    test_assert_slice(&prop->name, "name-2");
+    g_assert_cmpuint(prop->n_values, ==, 0);
+    g_assert(!prop->values);
+    mc_record_view_free(view);
+}
+
+/* Decode */
+
+static
+void
+test_decode(
+    void)
+{
+    const char str[] = "id:a:x\\:y,\\,;b:\x83\x6e\x83\x8d;URL:http://foo";
+    McRecordView* view = mc_record_view_parse(str, sizeof(str) - 1);
+    const McPropertyView* prop;
+
+    g_assert(view);
+    g_assert_cmpuint(view->n_prop, ==, 3);
+
+    /* Escaped values are decoded, i.e. don't point to the input */
+    prop = view->prop;
+    g_assert_cmpuint(prop->n_values, ==, 2);
+    test_assert_slice(prop->values + 0, "x:y");
+    test_assert_slice(prop->values + 1, ",");
+    g_assert(prop->values[0].ptr < str ||
+        prop->values[0].ptr >= str + sizeof(str));
+
+    /* And so is Shift-JIS */
+    prop++;
+    g_assert_cmpuint(prop->n_values, ==, 1);
+    test_assert_slice(prop->values, "\xe3\x83\x8f\xe3\x83\xad");
+
+    /* But unescaped URL isn't */
+    prop++;
+    g_assert_cmpuint(prop->n_values, ==, 1);
+    test_assert_slice(prop->values, "http://foo");
+    g_assert(prop->values[0].ptr == str + 24);
+    mc_record_view_free(view);
+}
+
+/* Bytes */
+
+static
+void
+test_bytes(
+    void)
+{
+    static const char str[] = "id:name:value;;";
+    char* copy = g_strdup(str);
+    GBytes* bytes = g_bytes_new_take(copy, sizeof(str) - 1);
+    McRecordView* view = mc_record_view_parse_bytes(bytes);
+
+    /* The view keeps the data alive */
+    g_bytes_unref(bytes);
+    g_assert(view);
+    test_assert_slice(&view->ident, "id");
+    g_assert(view->ident.ptr == copy);
+    g_assert_cmpuint(view->n_prop, ==, 1);
+    test_assert_slice(&view->prop->name, "name");
+    g_assert_cmpuint(view->prop->n_values, ==, 1);
+    test_assert_slice(view->prop->values, "value");
+    mc_record_view_free(view);
+}
+
+/* Record */
+
+static
+void
+test_record(
+    gconstpointer data)
+{
+    /* View must be consistent with McRecord */
+    const char* str = data;
+    McRecord* rec = mc_record_parse(str);
+    McRecordView* view = mc_record_view_parse(str, strlen(str));
+    guint i, k;
+
+    g_assert(rec);
+    g_assert(view);
+    test_assert_slice(&view->ident, rec->ident);
+    g_assert_cmpuint(view->n_prop, ==, rec->n_prop);
+    for (i = 0; i < rec->n_prop; i++) {
+        const McProperty* p1 = rec->prop + i;
+        const McPropertyView* p2 = view->prop + i;
+
+        test_assert_slice(&p2->name, p1->name);
+        if (p1->values) {
+            for (k = 0; p1->values[k]; k++) {
+                g_assert_cmpuint(k, < ,p2->n_values);
+                test_assert_slice(p2->values + k, p1->values[k]);
+            }
+            g_assert_cmpuint(k, == ,p2->n_values);
+        } else {
+            g_assert(!p2->n_values);
+        }
+    }
+    mc_record_free(rec);
+    mc_record_view_free(view);
+}
+
+/* Common */
+
+#define TEST_(x) "/view/" x
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_data_func(TEST_("invalid_id"), "_:", test_failure);
+    g_test_add_data_func(TEST_("invalid_prop/1"), "foo: a", test_failure);
+    g_test_add_data_func(TEST_("invalid_prop/2"), "foo: a:\\", test_failure);
+    g_test_add_func(TEST_("basic"), test_basic);
+    g_test_add_func(TEST_("decode"), test_decode);
+    g_test_add_func(TEST_("bytes"), test_bytes);
+    g_test_add_data_func(TEST_("record/1"), " foo : ;;", test_record);
+    g_test_add_data_func(TEST_("record/2"), "MECARD:N:Doe,John;"
+        "TEL:13035551212;EMAIL:;URL:http\\://www.example.com;;",
+        test_record);
+    g_test_add_data_func(TEST_("record/3"), "id:a:\xD1\x82\xD0\xB5,"
+        "\xD1\xD1,\x83\x6e;b:\\\\\\.;;", test_record);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */